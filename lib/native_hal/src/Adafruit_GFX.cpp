@@ -0,0 +1,239 @@
+// Adafruit_GFX.cpp
+// Drawing primitives and the classic 5x7 text used by the firmware.
+#include "Adafruit_GFX.h"
+
+// 5x7 glyphs for ASCII 32-126, one byte per column, bit 0 at the top
+static const uint8_t classicFont[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00,  // ' '
+    0x00, 0x00, 0x5F, 0x00, 0x00,  // '!'
+    0x00, 0x07, 0x00, 0x07, 0x00,  // '"'
+    0x14, 0x7F, 0x14, 0x7F, 0x14,  // '#'
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,  // '$'
+    0x23, 0x13, 0x08, 0x64, 0x62,  // '%'
+    0x36, 0x49, 0x55, 0x22, 0x50,  // '&'
+    0x00, 0x04, 0x03, 0x00, 0x00,  // "'"
+    0x00, 0x1C, 0x22, 0x41, 0x00,  // '('
+    0x00, 0x41, 0x22, 0x1C, 0x00,  // ')'
+    0x14, 0x08, 0x3E, 0x08, 0x14,  // '*'
+    0x08, 0x08, 0x3E, 0x08, 0x08,  // '+'
+    0x00, 0x50, 0x30, 0x00, 0x00,  // ','
+    0x08, 0x08, 0x08, 0x08, 0x08,  // '-'
+    0x00, 0x60, 0x60, 0x00, 0x00,  // '.'
+    0x20, 0x10, 0x08, 0x04, 0x02,  // '/'
+    0x3E, 0x51, 0x49, 0x45, 0x3E,  // '0'
+    0x00, 0x42, 0x7F, 0x40, 0x00,  // '1'
+    0x42, 0x61, 0x51, 0x49, 0x46,  // '2'
+    0x21, 0x41, 0x45, 0x4B, 0x31,  // '3'
+    0x18, 0x14, 0x12, 0x7F, 0x10,  // '4'
+    0x27, 0x45, 0x45, 0x45, 0x39,  // '5'
+    0x3C, 0x4A, 0x49, 0x49, 0x30,  // '6'
+    0x01, 0x71, 0x09, 0x05, 0x03,  // '7'
+    0x36, 0x49, 0x49, 0x49, 0x36,  // '8'
+    0x06, 0x49, 0x49, 0x29, 0x1E,  // '9'
+    0x00, 0x36, 0x36, 0x00, 0x00,  // ':'
+    0x00, 0x56, 0x36, 0x00, 0x00,  // ';'
+    0x08, 0x14, 0x22, 0x41, 0x00,  // '<'
+    0x14, 0x14, 0x14, 0x14, 0x14,  // '='
+    0x00, 0x41, 0x22, 0x14, 0x08,  // '>'
+    0x02, 0x01, 0x51, 0x09, 0x06,  // '?'
+    0x32, 0x49, 0x79, 0x41, 0x3E,  // '@'
+    0x7E, 0x11, 0x11, 0x11, 0x7E,  // 'A'
+    0x7F, 0x49, 0x49, 0x49, 0x36,  // 'B'
+    0x3E, 0x41, 0x41, 0x41, 0x22,  // 'C'
+    0x7F, 0x41, 0x41, 0x22, 0x1C,  // 'D'
+    0x7F, 0x49, 0x49, 0x49, 0x41,  // 'E'
+    0x7F, 0x09, 0x09, 0x09, 0x01,  // 'F'
+    0x3E, 0x41, 0x49, 0x49, 0x7A,  // 'G'
+    0x7F, 0x08, 0x08, 0x08, 0x7F,  // 'H'
+    0x00, 0x41, 0x7F, 0x41, 0x00,  // 'I'
+    0x20, 0x40, 0x41, 0x3F, 0x01,  // 'J'
+    0x7F, 0x08, 0x14, 0x22, 0x41,  // 'K'
+    0x7F, 0x40, 0x40, 0x40, 0x40,  // 'L'
+    0x7F, 0x02, 0x0C, 0x02, 0x7F,  // 'M'
+    0x7F, 0x04, 0x08, 0x10, 0x7F,  // 'N'
+    0x3E, 0x41, 0x41, 0x41, 0x3E,  // 'O'
+    0x7F, 0x09, 0x09, 0x09, 0x06,  // 'P'
+    0x3E, 0x41, 0x51, 0x21, 0x5E,  // 'Q'
+    0x7F, 0x09, 0x19, 0x29, 0x46,  // 'R'
+    0x46, 0x49, 0x49, 0x49, 0x31,  // 'S'
+    0x01, 0x01, 0x7F, 0x01, 0x01,  // 'T'
+    0x3F, 0x40, 0x40, 0x40, 0x3F,  // 'U'
+    0x1F, 0x20, 0x40, 0x20, 0x1F,  // 'V'
+    0x3F, 0x40, 0x38, 0x40, 0x3F,  // 'W'
+    0x63, 0x14, 0x08, 0x14, 0x63,  // 'X'
+    0x07, 0x08, 0x70, 0x08, 0x07,  // 'Y'
+    0x61, 0x51, 0x49, 0x45, 0x43,  // 'Z'
+    0x00, 0x7F, 0x41, 0x41, 0x00,  // '['
+    0x02, 0x04, 0x08, 0x10, 0x20,  // '\\'
+    0x00, 0x41, 0x41, 0x7F, 0x00,  // ']'
+    0x04, 0x02, 0x01, 0x02, 0x04,  // '^'
+    0x40, 0x40, 0x40, 0x40, 0x40,  // '_'
+    0x00, 0x01, 0x02, 0x04, 0x00,  // '`'
+    0x20, 0x54, 0x54, 0x54, 0x78,  // 'a'
+    0x7F, 0x48, 0x44, 0x44, 0x38,  // 'b'
+    0x38, 0x44, 0x44, 0x44, 0x20,  // 'c'
+    0x38, 0x44, 0x44, 0x48, 0x7F,  // 'd'
+    0x38, 0x54, 0x54, 0x54, 0x18,  // 'e'
+    0x08, 0x7E, 0x09, 0x01, 0x02,  // 'f'
+    0x0C, 0x52, 0x52, 0x52, 0x3E,  // 'g'
+    0x7F, 0x08, 0x04, 0x04, 0x78,  // 'h'
+    0x00, 0x44, 0x7D, 0x40, 0x00,  // 'i'
+    0x20, 0x40, 0x44, 0x3D, 0x00,  // 'j'
+    0x7F, 0x10, 0x28, 0x44, 0x00,  // 'k'
+    0x00, 0x41, 0x7F, 0x40, 0x00,  // 'l'
+    0x7C, 0x04, 0x18, 0x04, 0x78,  // 'm'
+    0x7C, 0x08, 0x04, 0x04, 0x78,  // 'n'
+    0x38, 0x44, 0x44, 0x44, 0x38,  // 'o'
+    0x7C, 0x14, 0x14, 0x14, 0x08,  // 'p'
+    0x08, 0x14, 0x14, 0x18, 0x7C,  // 'q'
+    0x7C, 0x08, 0x04, 0x04, 0x08,  // 'r'
+    0x48, 0x54, 0x54, 0x54, 0x20,  // 's'
+    0x04, 0x3F, 0x44, 0x40, 0x20,  // 't'
+    0x3C, 0x40, 0x40, 0x20, 0x7C,  // 'u'
+    0x1C, 0x20, 0x40, 0x20, 0x1C,  // 'v'
+    0x3C, 0x40, 0x30, 0x40, 0x3C,  // 'w'
+    0x44, 0x28, 0x10, 0x28, 0x44,  // 'x'
+    0x0C, 0x50, 0x50, 0x50, 0x3C,  // 'y'
+    0x44, 0x64, 0x54, 0x4C, 0x44,  // 'z'
+    0x00, 0x08, 0x36, 0x41, 0x00,  // '{'
+    0x00, 0x00, 0x7F, 0x00, 0x00,  // '|'
+    0x00, 0x41, 0x36, 0x08, 0x00,  // '}'
+    0x08, 0x04, 0x08, 0x10, 0x08,  // '~'
+};
+
+Adafruit_GFX::Adafruit_GFX(int16_t width, int16_t height) : widthValue(width), heightValue(height) {}
+
+void Adafruit_GFX::writePixel(int16_t x, int16_t y, uint16_t color) {
+    drawPixel(x, y, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t width, uint16_t color) {
+    for (int16_t i = 0; i < width; i++) {
+        drawPixel(x + i, y, color);
+    }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t height, uint16_t color) {
+    for (int16_t i = 0; i < height; i++) {
+        drawPixel(x, y + i, color);
+    }
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    // Bresenham
+    int16_t dx = abs(x1 - x0);
+    int16_t dy = -abs(y1 - y0);
+    int16_t stepX = x0 < x1 ? 1 : -1;
+    int16_t stepY = y0 < y1 ? 1 : -1;
+    int16_t error = dx + dy;
+    while (true) {
+        drawPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int16_t doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x0 += stepX;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y0 += stepY;
+        }
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color) {
+    drawFastHLine(x, y, width, color);
+    drawFastHLine(x, y + height - 1, width, color);
+    drawFastVLine(x, y, height, color);
+    drawFastVLine(x + width - 1, y, height, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color) {
+    for (int16_t i = 0; i < height; i++) {
+        drawFastHLine(x, y + i, width, color);
+    }
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+    fillRect(0, 0, widthValue, heightValue, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t width, int16_t height,
+                              uint16_t color) {
+    int16_t byteWidth = (width + 7) / 8;
+    for (int16_t row = 0; row < height; row++) {
+        for (int16_t column = 0; column < width; column++) {
+            if (bitmap[row * byteWidth + column / 8] & (0x80 >> (column & 7))) {
+                drawPixel(x + column, y + row, color);
+            }
+        }
+    }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t width, int16_t height,
+                              uint16_t color, uint16_t background) {
+    int16_t byteWidth = (width + 7) / 8;
+    for (int16_t row = 0; row < height; row++) {
+        for (int16_t column = 0; column < width; column++) {
+            bool set = bitmap[row * byteWidth + column / 8] & (0x80 >> (column & 7));
+            drawPixel(x + column, y + row, set ? color : background);
+        }
+    }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t background,
+                            uint8_t size) {
+    if (c < 32 || c > 126) {
+        c = '?';
+    }
+    const uint8_t* glyph = classicFont + (c - 32) * 5;
+    for (int8_t column = 0; column < 6; column++) {
+        uint8_t bits = column < 5 ? glyph[column] : 0;  // Sixth column is the gap
+        for (int8_t row = 0; row < 8; row++, bits >>= 1) {
+            if (bits & 1) {
+                fillRect(x + column * size, y + row * size, size, size, color);
+            } else if (background != color) {
+                fillRect(x + column * size, y + row * size, size, size, background);
+            }
+        }
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        cursorX = 0;
+        cursorY += textSize * 8;
+    } else if (c != '\r') {
+        if (wrap && cursorX + textSize * 6 > widthValue) {
+            cursorX = 0;
+            cursorY += textSize * 8;
+        }
+        drawChar(cursorX, cursorY, c, textColor, textBackground, textSize);
+        cursorX += textSize * 6;
+    }
+    return 1;
+}
+
+void Adafruit_GFX::getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* width,
+                                 uint16_t* height) {
+    int16_t lineWidth = 0;
+    int16_t maxWidth = 0;
+    int16_t lines = 1;
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '\n') {
+            lines++;
+            lineWidth = 0;
+        } else if (*c != '\r') {
+            lineWidth += textSize * 6;
+            if (lineWidth > maxWidth) {
+                maxWidth = lineWidth;
+            }
+        }
+    }
+    *x1 = x;
+    *y1 = y;
+    *width = maxWidth;
+    *height = lines * textSize * 8;
+}
@@ -0,0 +1,51 @@
+// Adafruit_GFX.h
+// Subset of Adafruit GFX with the same classic 6x8 text metrics.
+#ifndef NATIVE_HAL_ADAFRUIT_GFX_H
+#define NATIVE_HAL_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t width, int16_t height);
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t width, uint16_t color);
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t height, uint16_t color);
+    virtual void fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color);
+    virtual void fillScreen(uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t width, int16_t height, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t width, int16_t height, uint16_t color,
+                    uint16_t background);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t background, uint8_t size);
+
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+    void setTextSize(uint8_t size) { textSize = size > 0 ? size : 1; }
+    void setTextColor(uint16_t color) { textColor = textBackground = color; }
+    void setTextColor(uint16_t color, uint16_t background) { textColor = color; textBackground = background; }
+    void setTextWrap(bool enabled) { wrap = enabled; }
+    void getTextBounds(const char* text, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* width,
+                       uint16_t* height);
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+    int16_t width() const { return widthValue; }
+    int16_t height() const { return heightValue; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+protected:
+    int16_t widthValue;
+    int16_t heightValue;
+    int16_t cursorX = 0;
+    int16_t cursorY = 0;
+    uint16_t textColor = 0xFFFF;
+    uint16_t textBackground = 0xFFFF;
+    uint8_t textSize = 1;
+    bool wrap = true;
+};
+
+#endif
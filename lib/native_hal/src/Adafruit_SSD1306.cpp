@@ -0,0 +1,200 @@
+// Adafruit_SSD1306.cpp
+#include "Adafruit_SSD1306.h"
+
+static SimSsd1306Panel panel;
+
+SimSsd1306Panel& simSsd1306Panel() {
+    return panel;
+}
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t width, uint8_t height, TwoWire* wire, int8_t resetPin,
+                                   uint32_t clkDuring, uint32_t clkAfter)
+    : Adafruit_GFX(width, height), wire(wire), clockDuring(clkDuring), clockAfter(clkAfter) {
+    memset(buffer, 0, sizeof(buffer));
+}
+
+bool Adafruit_SSD1306::begin(uint8_t vccState, uint8_t i2cAddress, bool reset, bool periphBegin) {
+    address = i2cAddress != 0 ? i2cAddress : 0x3C;
+    simAttachI2cDevice(address, &panel);
+    ssd1306_command(SSD1306_DISPLAYOFF);
+    ssd1306_command(SSD1306_MEMORYMODE);
+    ssd1306_command(0x00);  // Horizontal addressing
+    ssd1306_command(SSD1306_NORMALDISPLAY);
+    ssd1306_command(SSD1306_DISPLAYON);
+    return true;
+}
+
+// Like the library, each transaction runs at clkDuring and leaves the bus at clkAfter
+void Adafruit_SSD1306::ssd1306_command(uint8_t command) {
+    wire->setClock(clockDuring);
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x00);
+    wire->write(command);
+    wire->endTransmission();
+    wire->setClock(clockAfter);
+}
+
+void Adafruit_SSD1306::display() {
+    static const uint8_t window[] = {SSD1306_PAGEADDR, 0, 7, SSD1306_COLUMNADDR, 0, 127};
+    for (uint8_t command : window) {
+        ssd1306_command(command);
+    }
+    wire->setClock(clockDuring);
+    for (size_t offset = 0; offset < sizeof(buffer); offset += WIRE_BUFFER_SIZE - 1) {
+        size_t chunk = sizeof(buffer) - offset < WIRE_BUFFER_SIZE - 1 ? sizeof(buffer) - offset : WIRE_BUFFER_SIZE - 1;
+        wire->beginTransmission(address);
+        wire->write((uint8_t)0x40);
+        wire->write(buffer + offset, chunk);
+        wire->endTransmission();
+    }
+    wire->setClock(clockAfter);
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+    memset(buffer, 0, sizeof(buffer));
+}
+
+void Adafruit_SSD1306::invertDisplay(bool invert) {
+    ssd1306_command(invert ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+    ssd1306_command(SSD1306_SETCONTRAST);
+    ssd1306_command(dim ? 0x00 : 0xCF);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= widthValue || y >= heightValue) {
+        return;
+    }
+    uint8_t& cell = buffer[x + (y / 8) * widthValue];
+    uint8_t bit = 1 << (y & 7);
+    if (color == SSD1306_WHITE) {
+        cell |= bit;
+    } else if (color == SSD1306_BLACK) {
+        cell &= ~bit;
+    } else if (color == SSD1306_INVERSE) {
+        cell ^= bit;
+    }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+    if (x < 0 || y < 0 || x >= widthValue || y >= heightValue) {
+        return false;
+    }
+    return buffer[x + (y / 8) * widthValue] & (1 << (y & 7));
+}
+
+// ---- Simulated panel ----
+
+static uint8_t commandArgCount(uint8_t command) {
+    switch (command) {
+        case SSD1306_COLUMNADDR:
+        case SSD1306_PAGEADDR:
+        case 0xA3:  // Vertical scroll area
+            return 2;
+        case 0x26:
+        case 0x27:  // Horizontal scroll
+            return 6;
+        case 0x29:
+        case 0x2A:  // Vertical and horizontal scroll
+            return 5;
+        case SSD1306_MEMORYMODE:
+        case SSD1306_SETCONTRAST:
+        case SSD1306_CHARGEPUMP:
+        case 0xA8:  // Multiplex ratio
+        case 0xD3:  // Display offset
+        case 0xD5:  // Clock divide
+        case 0xD9:  // Pre-charge
+        case 0xDA:  // COM pins
+        case 0xDB:  // VCOMH deselect
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+void SimSsd1306Panel::command(uint8_t byte) {
+    if (pendingArgs > 0) {
+        args[argCount++] = byte;
+        if (--pendingArgs > 0) {
+            return;
+        }
+        if (pendingCommand == SSD1306_COLUMNADDR) {
+            columnStart = column = args[0] & 0x7F;
+            columnEnd = args[1] & 0x7F;
+        } else if (pendingCommand == SSD1306_PAGEADDR) {
+            pageStart = page = args[0] & 0x07;
+            pageEnd = args[1] & 0x07;
+        }
+        return;
+    }
+
+    pendingCommand = byte;
+    pendingArgs = commandArgCount(byte);
+    argCount = 0;
+    if (byte == SSD1306_DISPLAYON) {
+        on = true;
+    } else if (byte == SSD1306_DISPLAYOFF) {
+        on = false;
+    } else if (byte == SSD1306_INVERTDISPLAY) {
+        inverted = true;
+    } else if (byte == SSD1306_NORMALDISPLAY) {
+        inverted = false;
+    }
+}
+
+void SimSsd1306Panel::data(uint8_t byte) {
+    gddram[page * 128 + column] = byte;
+    dataByteCount++;
+    if (column++ >= columnEnd) {
+        column = columnStart;
+        page = page >= pageEnd ? pageStart : page + 1;
+    }
+}
+
+void SimSsd1306Panel::onI2cWrite(const uint8_t* bytes, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    bool isData = bytes[0] & 0x40;
+    for (size_t i = 1; i < length; i++) {
+        if (isData) {
+            data(bytes[i]);
+        } else {
+            command(bytes[i]);
+        }
+    }
+}
+
+bool SimSsd1306Panel::pixel(int x, int y) const {
+    if (!on) {
+        return false;
+    }
+    bool lit = gddram[(y / 8) * 128 + x] & (1 << (y & 7));
+    return lit != inverted;
+}
+
+bool SimSsd1306Panel::writePbm(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "P1\n128 64\n");
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 128; x++) {
+            fputc(pixel(x, y) ? '1' : '0', file);
+        }
+        fputc('\n', file);
+    }
+    fclose(file);
+    return true;
+}
+
+uint32_t SimSsd1306Panel::frameHash() const {
+    uint32_t hash = on ? 2166136261UL : 0;  // FNV-1a over what is visible
+    for (int i = 0; on && i < (int)sizeof(gddram); i++) {
+        hash = (hash ^ (inverted ? (uint8_t)~gddram[i] : gddram[i])) * 16777619UL;
+    }
+    return hash;
+}
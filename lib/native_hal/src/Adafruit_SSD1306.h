@@ -0,0 +1,81 @@
+// Adafruit_SSD1306.h
+// Framebuffer-compatible SSD1306 driver. Everything reaches the simulated
+// panel over Wire, so page/column addressed partial updates behave as on
+// hardware and the panel contents can be dumped as PBM frames.
+#ifndef NATIVE_HAL_ADAFRUIT_SSD1306_H
+#define NATIVE_HAL_ADAFRUIT_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+#include "sim_hal.h"
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_CHARGEPUMP 0x8D
+#define SSD1306_NORMALDISPLAY 0xA6
+#define SSD1306_INVERTDISPLAY 0xA7
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_EXTERNALVCC 0x01
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+    Adafruit_SSD1306(uint8_t width, uint8_t height, TwoWire* wire = &Wire, int8_t resetPin = -1,
+                     uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+
+    bool begin(uint8_t vccState = SSD1306_SWITCHCAPVCC, uint8_t address = 0, bool reset = true,
+               bool periphBegin = true);
+    void display();
+    void clearDisplay();
+    void invertDisplay(bool invert);
+    void dim(bool dim);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    bool getPixel(int16_t x, int16_t y);
+    uint8_t* getBuffer() { return buffer; }
+    void ssd1306_command(uint8_t command);
+
+private:
+    TwoWire* wire;
+    uint8_t address = 0x3C;
+    uint32_t clockDuring;
+    uint32_t clockAfter;
+    uint8_t buffer[128 * 64 / 8];
+};
+
+// The panel side: GDDRAM plus the command state machine
+class SimSsd1306Panel : public SimI2cDevice {
+public:
+    void onI2cWrite(const uint8_t* data, size_t length) override;
+
+    bool pixel(int x, int y) const;  // What the glass shows, taking power and inversion into account
+    bool displayOn() const { return on; }
+    bool writePbm(const char* path) const;  // Lit pixels are written as 1 (black)
+    uint32_t frameHash() const;  // Changes whenever the visible image does
+    uint64_t dataBytes() const { return dataByteCount; }
+
+private:
+    void command(uint8_t byte);
+    void data(uint8_t byte);
+
+    uint8_t gddram[128 * 64 / 8] = {0};
+    bool on = false;
+    bool inverted = false;
+    uint8_t pageStart = 0, pageEnd = 7, columnStart = 0, columnEnd = 127;
+    uint8_t page = 0, column = 0;
+    uint8_t pendingCommand = 0;
+    uint8_t pendingArgs = 0;
+    uint8_t args[6];
+    uint8_t argCount = 0;
+    uint64_t dataByteCount = 0;
+};
+
+SimSsd1306Panel& simSsd1306Panel();
+
+#endif
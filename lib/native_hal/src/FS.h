@@ -0,0 +1,38 @@
+// FS.h
+// Files of the simulated flash file system are plain host files.
+#ifndef NATIVE_HAL_FS_H
+#define NATIVE_HAL_FS_H
+
+#include <stdio.h>
+#include <memory>
+#include "Stream.h"
+
+namespace fs {
+
+class File : public Stream {
+public:
+    File() {}
+    explicit File(FILE* file) : handle(file, fclose) {}
+
+    explicit operator bool() const { return handle != nullptr; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    bool seek(uint32_t position);
+    size_t position() const;
+    size_t size() const;
+    void close() { handle.reset(); }
+
+private:
+    std::shared_ptr<FILE> handle;  // Copies share the open file, as on the device
+};
+
+}  // namespace fs
+
+using fs::File;
+
+#endif
@@ -0,0 +1,39 @@
+// HTTPClient.h
+// Answers GET requests from the simulator's route table instead of the network.
+// The client is connected to the URL's host first, unless setReuse(true) left
+// it connected from the previous request.
+#ifndef NATIVE_HAL_HTTPCLIENT_H
+#define NATIVE_HAL_HTTPCLIENT_H
+
+#include <WiFi.h>
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    bool begin(WiFiClient& client, const String& url);
+    void useHTTP10(bool enabled = true) {}
+    void setReuse(bool enabled) { reuse = enabled; }
+    void setTimeout(uint16_t timeout) {}
+    void addHeader(const String& name, const String& value) {}
+    void collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {}
+    String header(const char* name) { return String(); }  // Bodies are sent whole, never chunked
+    int GET();
+    int getSize() { return body.length(); }
+    String getString() { return body; }
+    WiFiClient& getStream() { return *client; }
+    void end();
+
+private:
+    String url;
+    String body;
+    bool reuse = false;
+    WiFiClient ownClient;
+    WiFiClient* client = &ownClient;
+};
+
+#endif
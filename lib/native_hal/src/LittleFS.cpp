@@ -0,0 +1,79 @@
+// LittleFS.cpp
+#include <string>
+#include <sys/stat.h>
+#include "LittleFS.h"
+
+fs::LittleFSFS LittleFS;
+
+static std::string rootDirectory;
+
+void simSetLittleFsRoot(const char* directory) {
+    rootDirectory = directory;
+}
+
+namespace fs {
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    return handle ? fwrite(buffer, 1, size, handle.get()) : 0;
+}
+
+int File::available() {
+    return handle ? (int)(size() - position()) : 0;
+}
+
+int File::read() {
+    return handle ? fgetc(handle.get()) : -1;
+}
+
+int File::peek() {
+    if (!handle) {
+        return -1;
+    }
+    int c = fgetc(handle.get());
+    if (c != EOF) {
+        ungetc(c, handle.get());
+    }
+    return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    return handle ? fread(buffer, 1, size, handle.get()) : 0;
+}
+
+bool File::seek(uint32_t position) {
+    return handle && fseek(handle.get(), position, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    return handle ? (size_t)ftell(handle.get()) : 0;
+}
+
+size_t File::size() const {
+    struct stat info;
+    return handle && fstat(fileno(handle.get()), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    struct stat info;
+    mounted = !rootDirectory.empty() && stat(rootDirectory.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+    return mounted;
+}
+
+File LittleFSFS::open(const char* path, const char* mode) {
+    if (!mounted || path == nullptr || path[0] != '/') {
+        return File();
+    }
+    std::string hostMode = mode;
+    if (hostMode.find('b') == std::string::npos) {
+        hostMode += 'b';
+    }
+    FILE* handle = fopen((rootDirectory + path).c_str(), hostMode.c_str());
+    return handle != nullptr ? File(handle) : File();
+}
+
+bool LittleFSFS::exists(const char* path) {
+    struct stat info;
+    return mounted && path != nullptr && path[0] == '/' && stat((rootDirectory + path).c_str(), &info) == 0;
+}
+
+}  // namespace fs
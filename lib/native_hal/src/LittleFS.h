@@ -0,0 +1,30 @@
+// LittleFS.h
+// LittleFS on the "spiffs" partition, backed by a host directory given with
+// --data. Without one, begin() fails as on a board with an unformatted partition.
+#ifndef NATIVE_HAL_LITTLEFS_H
+#define NATIVE_HAL_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = "spiffs");
+    void end() { mounted = false; }
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+
+private:
+    bool mounted = false;
+};
+
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+// Directory that stands in for the partition's root
+void simSetLittleFsRoot(const char* directory);
+
+#endif
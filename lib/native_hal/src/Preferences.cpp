@@ -0,0 +1,154 @@
+// Preferences.cpp
+#include <stdio.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Preferences.h"
+
+typedef std::map<std::string, std::vector<uint8_t>> SimNamespace;
+
+static std::map<std::string, SimNamespace> nvs;
+static std::mutex nvsLock;
+static uint64_t nvsBytesWritten = 0;
+
+uint64_t simNvsBytesWritten() {
+    return nvsBytesWritten;
+}
+
+bool Preferences::begin(const char* name, bool openReadOnly) {
+    space = name;
+    opened = true;
+    readOnly = openReadOnly;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(nvsLock);
+    nvs[space.str()].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(nvsLock);
+    return nvs[space.str()].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::mutex> guard(nvsLock);
+    return opened && nvs[space.str()].count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!opened || readOnly) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(nvsLock);
+    const uint8_t* bytes = (const uint8_t*)value;
+    nvs[space.str()][key] = std::vector<uint8_t>(bytes, bytes + length);
+    nvsBytesWritten += length;
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::lock_guard<std::mutex> guard(nvsLock);
+    SimNamespace& entries = nvs[space.str()];
+    auto it = entries.find(key);
+    return opened && it != entries.end() ? it->second.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    std::lock_guard<std::mutex> guard(nvsLock);
+    SimNamespace& entries = nvs[space.str()];
+    auto it = entries.find(key);
+    if (!opened || it == entries.end() || it->second.size() > maxLength) {
+        return 0;
+    }
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    size_t length = strlen(value);
+    return putBytes(key, value, length + 1) > 0 ? length : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t length = getBytesLength(key);
+    if (length == 0) {
+        return defaultValue;
+    }
+    std::vector<char> value(length);
+    getBytes(key, value.data(), length);
+    return String(value.data());
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+    size_t length = getBytesLength(key);
+    if (length == 0 || length > maxLength) {
+        return 0;
+    }
+    getBytes(key, value, maxLength);
+    return length;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t value = defaultValue;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+static bool readChunk(FILE* file, std::vector<uint8_t>& chunk) {
+    uint32_t length;
+    if (fread(&length, sizeof(length), 1, file) != 1) {
+        return false;
+    }
+    chunk.resize(length);
+    return length == 0 || fread(chunk.data(), length, 1, file) == 1;
+}
+
+static void writeChunk(FILE* file, const void* data, uint32_t length) {
+    fwrite(&length, sizeof(length), 1, file);
+    fwrite(data, length, 1, file);
+}
+
+// File layout: repeated (namespace, key, value) triples, each a uint32 length and bytes
+bool simLoadNvs(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return true;
+    }
+    std::lock_guard<std::mutex> guard(nvsLock);
+    std::vector<uint8_t> space, key, value;
+    while (readChunk(file, space) && readChunk(file, key) && readChunk(file, value)) {
+        nvs[std::string(space.begin(), space.end())][std::string(key.begin(), key.end())] = value;
+    }
+    bool ok = feof(file) != 0;
+    fclose(file);
+    return ok;
+}
+
+bool simSaveNvs(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(nvsLock);
+    for (const auto& space : nvs) {
+        for (const auto& entry : space.second) {
+            writeChunk(file, space.first.data(), space.first.size());
+            writeChunk(file, entry.first.data(), entry.first.size());
+            writeChunk(file, entry.second.data(), entry.second.size());
+        }
+    }
+    return fclose(file) == 0;
+}
@@ -0,0 +1,40 @@
+// Preferences.h
+// NVS namespaces kept in memory for the length of a simulation run,
+// optionally loaded from and saved to a file (--nvs).
+#ifndef NATIVE_HAL_PREFERENCES_H
+#define NATIVE_HAL_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLength);
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+    size_t getBytesLength(const char* key);
+    size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+
+private:
+    String space;
+    bool opened = false;
+    bool readOnly = true;
+};
+
+// Total bytes written to the simulated NVS since start
+uint64_t simNvsBytesWritten();
+
+// Load or save every namespace; a missing file loads as empty NVS
+bool simLoadNvs(const char* path);
+bool simSaveNvs(const char* path);
+
+#endif
@@ -0,0 +1,30 @@
+// Print.cpp
+#include <stdarg.h>
+#include <stdio.h>
+#include <vector>
+#include "Print.h"
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size--) {
+        written += write(*buffer++);
+    }
+    return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+    if (length < 0) {
+        va_end(args);
+        return 0;
+    }
+    std::vector<char> buffer(length + 1);
+    vsnprintf(buffer.data(), buffer.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)buffer.data(), length);
+}
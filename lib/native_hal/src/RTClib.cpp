@@ -0,0 +1,124 @@
+// RTClib.cpp
+#include "RTClib.h"
+#include "sim_hal.h"
+
+// Days since 1970-01-01 for a civil date, and back (Howard Hinnant's algorithms)
+static long daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (long)dayOfEra - 719468;
+}
+
+static void civilFromDays(long days, int& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = (int)(yearOfEra + era * 400) + (month <= 2);
+}
+
+DateTime::DateTime(uint32_t unixTime) {
+    long days = unixTime / 86400UL;
+    uint32_t seconds = unixTime % 86400UL;
+    int year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    yearValue = year;
+    monthValue = month;
+    dayValue = day;
+    hourValue = seconds / 3600;
+    minuteValue = seconds / 60 % 60;
+    secondValue = seconds % 60;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+    : yearValue(year < 100 ? year + 2000 : year), monthValue(month), dayValue(day), hourValue(hour),
+      minuteValue(minute), secondValue(second) {}
+
+DateTime::DateTime(const char* date, const char* time) {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char name[4] = {date[0], date[1], date[2], 0};
+    const char* found = strstr(months, name);
+    monthValue = found != nullptr ? (found - months) / 3 + 1 : 1;
+    dayValue = atoi(date + 4);
+    yearValue = atoi(date + 7);
+    hourValue = atoi(time);
+    minuteValue = atoi(time + 3);
+    secondValue = atoi(time + 6);
+}
+
+uint32_t DateTime::unixtime() const {
+    return (uint32_t)(daysFromCivil(yearValue, monthValue, dayValue) * 86400L + hourValue * 3600L +
+                      minuteValue * 60L + secondValue);
+}
+
+uint8_t DateTime::dayOfTheWeek() const {
+    return (uint8_t)((daysFromCivil(yearValue, monthValue, dayValue) + 4) % 7);  // 1970-01-01 was a Thursday
+}
+
+// Register file behind I2C address 0x68. Only the control and aging registers
+// do anything: the aging offset takes effect when a conversion is started.
+class SimDs3231Registers : public SimI2cDevice {
+public:
+    void onI2cWrite(const uint8_t* data, size_t length) override {
+        if (length == 0) {
+            return;
+        }
+        pointer = data[0] % sizeof(registers);
+        for (size_t i = 1; i < length; i++) {
+            registers[pointer] = data[i];
+            if (pointer == CONTROL && (data[i] & CONV) != 0) {
+                simSetRtcAging((int8_t)registers[AGING]);
+                registers[CONTROL] &= ~CONV;
+            }
+            pointer = (pointer + 1) % sizeof(registers);
+        }
+    }
+
+    size_t onI2cRead(uint8_t* data, size_t length) override {
+        for (size_t i = 0; i < length; i++) {
+            data[i] = registers[pointer];
+            pointer = (pointer + 1) % sizeof(registers);
+        }
+        return length;
+    }
+
+private:
+    static const uint8_t CONTROL = 0x0E;
+    static const uint8_t AGING = 0x10;
+    static const uint8_t CONV = 0x20;
+    uint8_t registers[0x13] = {};
+    uint8_t pointer = 0;
+};
+
+static SimDs3231Registers ds3231Registers;
+
+bool RTC_DS3231::begin(TwoWire* wire) {
+    simAttachI2cDevice(0x68, &ds3231Registers);  // Starts with aging 0, like a fresh part
+    return true;
+}
+
+DateTime RTC_DS3231::now() {
+    return DateTime(simRtcTime());
+}
+
+void RTC_DS3231::adjust(const DateTime& time) {
+    simSetRtcTime(time.unixtime());
+    simSetRtcLostPower(false);
+}
+
+bool RTC_DS3231::lostPower() {
+    return simRtcLostPower();
+}
+
+void RTC_DS3231::writeSqwPinMode(Ds3231SqwPinMode mode) {
+    sqwMode = mode;
+    simSetRtcSqw(mode == DS3231_SquareWave1Hz);
+}
@@ -0,0 +1,82 @@
+// RTClib.h
+// DateTime/TimeSpan compatible with Adafruit RTClib, and a DS3231 whose time,
+// power-loss flag, SQW output, drift and aging register are controlled by the simulator.
+#ifndef NATIVE_HAL_RTCLIB_H
+#define NATIVE_HAL_RTCLIB_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class TimeSpan {
+public:
+    TimeSpan(int32_t seconds = 0) : total(seconds) {}
+    TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds)
+        : total((int32_t)days * 86400L + (int32_t)hours * 3600 + (int32_t)minutes * 60 + seconds) {}
+
+    int16_t days() const { return total / 86400L; }
+    int8_t hours() const { return total / 3600 % 24; }
+    int8_t minutes() const { return total / 60 % 60; }
+    int8_t seconds() const { return total % 60; }
+    int32_t totalseconds() const { return total; }
+
+private:
+    int32_t total;
+};
+
+class DateTime {
+public:
+    DateTime(uint32_t unixTime = 946684800UL);  // Defaults to 2000-01-01 like RTClib
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t minute = 0, uint8_t second = 0);
+    DateTime(const char* date, const char* time);  // __DATE__, __TIME__
+
+    uint16_t year() const { return yearValue; }
+    uint8_t month() const { return monthValue; }
+    uint8_t day() const { return dayValue; }
+    uint8_t hour() const { return hourValue; }
+    uint8_t minute() const { return minuteValue; }
+    uint8_t second() const { return secondValue; }
+    uint8_t dayOfTheWeek() const;
+    uint32_t unixtime() const;
+
+    DateTime operator+(const TimeSpan& span) const { return DateTime(unixtime() + span.totalseconds()); }
+    DateTime operator-(const TimeSpan& span) const { return DateTime(unixtime() - span.totalseconds()); }
+    TimeSpan operator-(const DateTime& other) const { return TimeSpan((int32_t)(unixtime() - other.unixtime())); }
+    bool operator<(const DateTime& other) const { return unixtime() < other.unixtime(); }
+    bool operator>(const DateTime& other) const { return other < *this; }
+    bool operator==(const DateTime& other) const { return unixtime() == other.unixtime(); }
+    bool operator!=(const DateTime& other) const { return !(*this == other); }
+
+private:
+    uint16_t yearValue;
+    uint8_t monthValue;
+    uint8_t dayValue;
+    uint8_t hourValue;
+    uint8_t minuteValue;
+    uint8_t secondValue;
+};
+
+enum Ds3231SqwPinMode {
+    DS3231_OFF = 0x1C,
+    DS3231_SquareWave1Hz = 0x00,
+    DS3231_SquareWave1kHz = 0x08,
+    DS3231_SquareWave4kHz = 0x10,
+    DS3231_SquareWave8kHz = 0x18
+};
+
+class RTC_DS3231 {
+public:
+    bool begin(TwoWire* wire = &Wire);
+    DateTime now();
+    void adjust(const DateTime& time);
+    bool lostPower();
+    void writeSqwPinMode(Ds3231SqwPinMode mode);
+    Ds3231SqwPinMode readSqwPinMode() { return sqwMode; }
+    float getTemperature() { return 25.0f; }
+    void enable32K() {}
+    void disable32K() {}
+
+private:
+    Ds3231SqwPinMode sqwMode = DS3231_OFF;
+};
+
+#endif
@@ -0,0 +1,60 @@
+// Stream.cpp
+// Reads never wait: the simulated sources are either complete or empty.
+#include "Stream.h"
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+bool Stream::findUntil(const char* target, const char* terminator) {
+    size_t targetLength = strlen(target);
+    size_t terminatorLength = terminator != nullptr ? strlen(terminator) : 0;
+    size_t matched = 0;
+    size_t terminatorMatched = 0;
+    if (targetLength == 0) {
+        return true;
+    }
+
+    int c;
+    while ((c = read()) >= 0) {
+        // Simple prefix matching is enough for the JSON delimiters we look for
+        matched = c == target[matched] ? matched + 1 : (c == target[0] ? 1 : 0);
+        if (matched == targetLength) {
+            return true;
+        }
+        if (terminatorLength > 0) {
+            terminatorMatched = c == terminator[terminatorMatched] ? terminatorMatched + 1
+                                                                   : (c == terminator[0] ? 1 : 0);
+            if (terminatorMatched == terminatorLength) {
+                return false;
+            }
+        }
+    }
+    return false;
+}
+
+String Stream::readString() {
+    String result;
+    int c;
+    while ((c = read()) >= 0) {
+        result += (char)c;
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
@@ -0,0 +1,27 @@
+// Stream.h
+#ifndef NATIVE_HAL_STREAM_H
+#define NATIVE_HAL_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+    void setTimeout(unsigned long timeout) { timeoutMs = timeout; }
+    unsigned long getTimeout() const { return timeoutMs; }
+
+    bool find(const char* target) { return findUntil(target, nullptr); }
+    bool findUntil(const char* target, const char* terminator);
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long timeoutMs = 1000;
+};
+
+#endif
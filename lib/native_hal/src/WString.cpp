@@ -0,0 +1,130 @@
+// WString.cpp
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "WString.h"
+
+static std::string formatInteger(unsigned long number, unsigned char base, bool negative) {
+    std::string digits;
+    do {
+        int digit = number % base;
+        digits.insert(digits.begin(), (char)(digit < 10 ? '0' + digit : 'a' + digit - 10));
+        number /= base;
+    } while (number > 0);
+    if (negative) {
+        digits.insert(digits.begin(), '-');
+    }
+    return digits;
+}
+
+String::String(int number, unsigned char base) : String((long)number, base) {}
+
+String::String(unsigned int number, unsigned char base) : String((unsigned long)number, base) {}
+
+String::String(long number, unsigned char base)
+    : value(base == 10 && number < 0 ? formatInteger(0UL - (unsigned long)number, base, true)
+                                     : formatInteger((unsigned long)number, base, false)) {}
+
+String::String(unsigned long number, unsigned char base) : value(formatInteger(number, base, false)) {}
+
+String::String(float number, unsigned int decimals) : String((double)number, decimals) {}
+
+String::String(double number, unsigned int decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, number);
+    value = buffer;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t at = value.find(c, from);
+    return at == std::string::npos ? -1 : (int)at;
+}
+
+int String::indexOf(const String& text, unsigned int from) const {
+    size_t at = value.find(text.value, from);
+    return at == std::string::npos ? -1 : (int)at;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t at = value.rfind(c);
+    return at == std::string::npos ? -1 : (int)at;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return value.size() >= suffix.value.size() &&
+           value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from >= value.size()) {
+        return String();
+    }
+    if (to > value.size()) {
+        to = value.size();
+    }
+    return String(value.substr(from, to - from));
+}
+
+void String::trim() {
+    size_t first = 0;
+    while (first < value.size() && isspace((unsigned char)value[first])) first++;
+    size_t last = value.size();
+    while (last > first && isspace((unsigned char)value[last - 1])) last--;
+    value = value.substr(first, last - first);
+}
+
+void String::toLowerCase() {
+    for (char& c : value) c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (char& c : value) c = toupper((unsigned char)c);
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.value.empty()) {
+        return;
+    }
+    size_t at = 0;
+    while ((at = value.find(find.value, at)) != std::string::npos) {
+        value.replace(at, find.value.size(), replacement.value);
+        at += replacement.value.size();
+    }
+}
+
+long String::toInt() const {
+    return strtol(value.c_str(), nullptr, 10);
+}
+
+double String::toDouble() const {
+    return strtod(value.c_str(), nullptr);
+}
+
+String operator+(const String& left, const String& right) {
+    String result(left);
+    result += right;
+    return result;
+}
+
+String operator+(const String& left, const char* right) {
+    String result(left);
+    result += right;
+    return result;
+}
+
+String operator+(const char* left, const String& right) {
+    String result(left);
+    result += right;
+    return result;
+}
+
+String operator+(const String& left, char right) {
+    String result(left);
+    result += right;
+    return result;
+}
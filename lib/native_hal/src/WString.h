@@ -0,0 +1,76 @@
+// WString.h
+// Arduino String on top of std::string, covering what the firmware and
+// ArduinoJson use.
+#ifndef NATIVE_HAL_WSTRING_H
+#define NATIVE_HAL_WSTRING_H
+
+#include <stddef.h>
+#include <strings.h>
+#include <string>
+
+class String {
+public:
+    String(const char* value = "") : value(value != nullptr ? value : "") {}
+    String(const std::string& value) : value(value) {}
+    explicit String(char c) : value(1, c) {}
+    explicit String(int number, unsigned char base = 10);
+    explicit String(unsigned int number, unsigned char base = 10);
+    explicit String(long number, unsigned char base = 10);
+    explicit String(unsigned long number, unsigned char base = 10);
+    explicit String(float number, unsigned int decimals = 2);
+    explicit String(double number, unsigned int decimals = 2);
+
+    unsigned int length() const { return value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    const char* c_str() const { return value.c_str(); }
+    bool reserve(unsigned int size) { value.reserve(size); return true; }
+
+    char charAt(unsigned int index) const { return index < value.size() ? value[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return value[index]; }
+
+    bool concat(const String& other) { value += other.value; return true; }
+    bool concat(const char* other) { value += other; return true; }
+    bool concat(const char* other, unsigned int length) { value.append(other, length); return true; }
+    bool concat(char c) { value += c; return true; }
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+
+    bool equals(const String& other) const { return value == other.value; }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(value.c_str(), other.value.c_str()) == 0; }
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == other; }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator!=(const char* other) const { return value != other; }
+    bool operator<(const String& other) const { return value < other.value; }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& text, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+    bool endsWith(const String& suffix) const;
+    String substring(unsigned int from) const { return substring(from, value.size()); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    void replace(const String& find, const String& replacement);
+
+    long toInt() const;
+    float toFloat() const { return (float)toDouble(); }
+    double toDouble() const;
+
+    const std::string& str() const { return value; }
+
+private:
+    std::string value;
+};
+
+String operator+(const String& left, const String& right);
+String operator+(const String& left, const char* right);
+String operator+(const char* left, const String& right);
+String operator+(const String& left, char right);
+
+#endif
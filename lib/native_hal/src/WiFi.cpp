@@ -0,0 +1,186 @@
+// WiFi.cpp
+#include <map>
+#include <vector>
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include "sim_hal.h"
+
+// Air time charged per step on the board, for simRadioStats()
+#define SIM_WIFI_JOIN_MS 1500       // Scan, WPA2 and DHCP
+#define SIM_TCP_CONNECT_MS 60       // DNS lookup and SYN round-trip
+#define SIM_TLS_HANDSHAKE_MS 1200   // Full handshake, key exchange and certificate check on the ESP32
+#define SIM_TLS_RESUME_MS 150       // Session ticket: two round-trips, no public key work
+#define SIM_REQUEST_MS 200          // Request round-trip and server time
+#define SIM_LINK_BYTES_PER_S 50000  // TLS record decryption bound
+
+WiFiClass WiFi;
+
+static bool wifiAvailable = true;
+static SimRadioStats radioStats;
+
+struct SimHttpRoute {
+    String prefix;
+    int status;
+    String body;
+};
+
+static std::vector<SimHttpRoute> httpRoutes;
+
+void simSetWifiAvailable(bool available) {
+    wifiAvailable = available;
+    if (!available) {
+        WiFi.disconnect();
+    }
+}
+
+bool simWifiAvailable() {
+    return wifiAvailable;
+}
+
+void simAddHttpRoute(const char* urlPrefix, int status, const String& body) {
+    SimHttpRoute route = {urlPrefix, status, body};
+    httpRoutes.push_back(route);
+}
+
+// Longest matching prefix wins; the scheme is ignored
+int simHttpGet(const String& url, String& body) {
+    String path = url;
+    int scheme = path.indexOf("://");
+    if (scheme >= 0) {
+        path = path.substring(scheme + 3);
+    }
+
+    const SimHttpRoute* match = nullptr;
+    for (const SimHttpRoute& route : httpRoutes) {
+        if (path.startsWith(route.prefix) && (match == nullptr || route.prefix.length() > match->prefix.length())) {
+            match = &route;
+        }
+    }
+    if (match == nullptr) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    body = match->body;
+    return match->status;
+}
+
+const SimRadioStats& simRadioStats() {
+    return radioStats;
+}
+
+void simResetRadioStats() {
+    memset(&radioStats, 0, sizeof(radioStats));
+}
+
+void simNoteTlsHandshake(bool resumed) {
+    if (resumed) {
+        radioStats.resumed++;
+        radioStats.airMicros += SIM_TLS_RESUME_MS * 1000ULL;
+    } else {
+        radioStats.handshakes++;
+        radioStats.airMicros += SIM_TLS_HANDSHAKE_MS * 1000ULL;
+    }
+}
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+    return String(text);
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* password) {
+    ssidValue = ssid;
+    modeValue = WIFI_STA;
+    bool joined = state == WL_CONNECTED;
+    state = wifiAvailable && ssid != nullptr && ssid[0] != '\0' ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+    if (!joined && state == WL_CONNECTED) {
+        radioStats.joins++;
+        radioStats.airMicros += SIM_WIFI_JOIN_MS * 1000ULL;
+    }
+    return state;
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+    state = WL_DISCONNECTED;
+    if (wifiOff) {
+        modeValue = WIFI_OFF;
+    }
+    return true;
+}
+
+bool WiFiClass::mode(wifi_mode_t newMode) {
+    modeValue = newMode;
+    if (newMode == WIFI_OFF) {
+        state = WL_DISCONNECTED;
+    }
+    return true;
+}
+
+bool HTTPClient::begin(const String& target) {
+    url = target;
+    client = &ownClient;
+    return true;
+}
+
+bool HTTPClient::begin(WiFiClient& stream, const String& target) {
+    url = target;
+    client = &stream;
+    return true;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    stop();
+    open = WiFi.status() == WL_CONNECTED;
+    if (open) {
+        radioStats.connections++;
+        radioStats.airMicros += SIM_TCP_CONNECT_MS * 1000ULL;
+    }
+    return open;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    size_t count = 0;
+    while (count < size && position < content.length()) {
+        buf[count++] = (uint8_t)content[position++];
+    }
+    return count > 0 ? (int)count : -1;
+}
+
+int HTTPClient::GET() {
+    if (WiFi.status() != WL_CONNECTED) {
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+    if (!reuse || !client->connected()) {
+        String host = url;
+        int scheme = host.indexOf("://");
+        bool secure = host.startsWith("https");
+        if (scheme >= 0) {
+            host = host.substring(scheme + 3);
+        }
+        int slash = host.indexOf('/');
+        if (slash >= 0) {
+            host = host.substring(0, slash);
+        }
+        if (!client->connect(host.c_str(), secure ? 443 : 80, 5000)) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        if (secure && client == &ownClient) {
+            simNoteTlsHandshake(false);  // HTTPClient's own WiFiClientSecure, which never resumes
+        }
+    }
+    body = "";
+    int status = simHttpGet(url, body);
+    if (status > 0) {
+        radioStats.requests++;
+        radioStats.bytes += body.length();
+        radioStats.airMicros += SIM_REQUEST_MS * 1000ULL + body.length() * 1000000ULL / SIM_LINK_BYTES_PER_S;
+    }
+    client->setBody(status > 0 ? body : String());
+    return status;
+}
+
+void HTTPClient::end() {
+    if (!reuse) {
+        client->stop();
+    }
+    body = "";
+}
@@ -0,0 +1,85 @@
+// WiFi.h
+// Station that associates instantly when the simulator says Wi-Fi is up.
+#ifndef NATIVE_HAL_WIFI_H
+#define NATIVE_HAL_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+class IPAddress : public Printable {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+    String toString() const;
+    size_t printTo(Print& out) const override { return out.print(toString()); }
+    uint8_t operator[](int index) const { return octets[index]; }
+
+private:
+    uint8_t octets[4];
+};
+
+class Client : public Stream {
+public:
+    virtual int connect(const char* host, uint16_t port) { return 0; }
+    virtual int connect(const char* host, uint16_t port, int32_t timeout) { return connect(host, port); }
+    virtual int read(uint8_t* buf, size_t size) { return -1; }
+    virtual void stop() {}
+    virtual uint8_t connected() { return 0; }
+    size_t write(uint8_t c) override { return 0; }
+    using Print::write;
+    using Stream::read;
+};
+
+// A connection to whatever host is asked for; reads back the response body
+// handed over by HTTPClient and swallows what is written to it
+class WiFiClient : public Client {
+public:
+    int connect(const char* host, uint16_t port) override { return connect(host, port, 0); }
+    int connect(const char* host, uint16_t port, int32_t timeout) override;
+    void setBody(const String& body) { content = body; position = 0; }
+    size_t write(uint8_t c) override { return open ? 1 : 0; }
+    size_t write(const uint8_t* buf, size_t size) override { return open ? size : 0; }
+    int available() override { return content.length() - position; }
+    int read() override { return position < content.length() ? (uint8_t)content[position++] : -1; }
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override { return position < content.length() ? (uint8_t)content[position] : -1; }
+    uint8_t connected() override { return open || position < content.length(); }
+    void stop() override { open = false; setBody(""); }
+
+private:
+    String content;
+    unsigned int position = 0;
+    bool open = false;
+};
+
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* password = nullptr);
+    wl_status_t status() { return state; }
+    bool disconnect(bool wifiOff = false);
+    bool mode(wifi_mode_t newMode);
+    wifi_mode_t getMode() { return modeValue; }
+    IPAddress localIP() { return state == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+    int8_t RSSI() { return state == WL_CONNECTED ? -55 : 0; }
+    String SSID() { return ssidValue; }
+    uint8_t* BSSID() { return state == WL_CONNECTED ? bssidValue : nullptr; }
+    String macAddress() { return "24:0A:C4:00:00:01"; }
+
+private:
+    wl_status_t state = WL_DISCONNECTED;
+    wifi_mode_t modeValue = WIFI_OFF;
+    String ssidValue;
+    uint8_t bssidValue[6] = {0x24, 0x0A, 0xC4, 0x10, 0x20, 0x30};
+};
+
+extern WiFiClass WiFi;
+
+#endif
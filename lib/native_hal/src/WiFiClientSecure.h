@@ -0,0 +1,25 @@
+// WiFiClientSecure.h
+#ifndef NATIVE_HAL_WIFI_CLIENT_SECURE_H
+#define NATIVE_HAL_WIFI_CLIENT_SECURE_H
+
+#include <WiFi.h>
+#include "sim_hal.h"
+
+// Plain WiFiClient that charges a full TLS handshake per connection, as the
+// Arduino client keeps no session
+class WiFiClientSecure : public WiFiClient {
+public:
+    int connect(const char* host, uint16_t port, int32_t timeout) override {
+        int connected = WiFiClient::connect(host, port, timeout);
+        if (connected) {
+            simNoteTlsHandshake(false);
+        }
+        return connected;
+    }
+    using WiFiClient::connect;
+    void setInsecure() {}
+    void setCACert(const char* rootCA) {}
+    void setHandshakeTimeout(unsigned long seconds) {}
+};
+
+#endif
@@ -0,0 +1,73 @@
+// Wire.cpp
+#include <map>
+#include "Wire.h"
+#include "sim_hal.h"
+
+TwoWire Wire;
+
+static std::map<uint8_t, SimI2cDevice*> i2cDevices;
+
+void simAttachI2cDevice(uint8_t address, SimI2cDevice* device) {
+    i2cDevices[address] = device;
+}
+
+SimI2cDevice* simI2cDevice(uint8_t address) {
+    auto it = i2cDevices.find(address);
+    return it != i2cDevices.end() ? it->second : nullptr;
+}
+
+void TwoWire::beginTransmission(uint8_t target) {
+    address = target;
+    length = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (length >= WIRE_BUFFER_SIZE) {
+        return 0;  // Same silent truncation as the ESP32 core
+    }
+    buffer[length++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t count) {
+    size_t written = 0;
+    while (written < count && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+// Function to hold the bus for a transaction of bytes (address included): 9 clocks per
+// byte plus start and stop, queued behind whatever is still on the bus
+void TwoWire::occupyBus(size_t bytes) {
+    uint64_t duration = ((uint64_t)bytes * 9 + 2) * 1000000ULL / clockHz;
+    uint64_t start = busFreeAt > simMicros() ? busFreeAt : simMicros();
+    busFreeAt = start + duration;
+    busyMicros += duration;
+    simWaitUntil(busFreeAt);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t target, uint8_t count, bool sendStop) {
+    transactionCount++;
+    rxPosition = 0;
+    rxLength = 0;
+    SimI2cDevice* device = simI2cDevice(target);
+    if (device == nullptr) {
+        return 0;
+    }
+    rxLength = device->onI2cRead(rxBuffer, count < WIRE_BUFFER_SIZE ? count : WIRE_BUFFER_SIZE);
+    occupyBus(rxLength + 1);
+    return (uint8_t)rxLength;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    transactionCount++;
+    byteCount += length + 1;  // Payload plus the address byte
+    SimI2cDevice* device = simI2cDevice(address);
+    if (device == nullptr) {
+        return 2;  // NACK on address
+    }
+    device->onI2cWrite(buffer, length);
+    occupyBus(length + 1);
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Wire.h
+// I2C bus: each write transaction is handed to the simulated device at its
+// address, and requestFrom() asks that device for bytes. Transactions take
+// bus time at the current clock: the caller waits for the bus and for its
+// own bytes, so a blocking transfer stalls whichever task makes it.
+#ifndef NATIVE_HAL_WIRE_H
+#define NATIVE_HAL_WIRE_H
+
+#include <Arduino.h>
+
+#define WIRE_BUFFER_SIZE 128
+
+class TwoWire : public Stream {
+public:
+    bool begin() { return true; }
+    bool begin(int sda, int scl, uint32_t frequency = 0) { return true; }
+    void setClock(uint32_t frequency) { clockHz = frequency; }
+    uint32_t getClock() const { return clockHz; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    using Print::write;
+    uint8_t endTransmission(bool sendStop = true);
+
+    uint8_t requestFrom(uint8_t address, uint8_t length, bool sendStop = true);
+    int available() override { return (int)(rxLength - rxPosition); }
+    int read() override { return rxPosition < rxLength ? rxBuffer[rxPosition++] : -1; }
+    int peek() override { return rxPosition < rxLength ? rxBuffer[rxPosition] : -1; }
+
+    uint32_t transactions() const { return transactionCount; }
+    uint64_t bytesWritten() const { return byteCount; }
+    uint64_t busMicros() const { return busyMicros; }
+
+private:
+    uint8_t address = 0;
+    uint8_t buffer[WIRE_BUFFER_SIZE];
+    size_t length = 0;
+    uint8_t rxBuffer[WIRE_BUFFER_SIZE];
+    size_t rxLength = 0;
+    size_t rxPosition = 0;
+    uint32_t clockHz = 100000;
+    uint32_t transactionCount = 0;
+    uint64_t byteCount = 0;
+    uint64_t busFreeAt = 0;
+    uint64_t busyMicros = 0;
+
+    void occupyBus(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,23 @@
+// gpio.h
+#ifndef NATIVE_HAL_DRIVER_GPIO_H
+#define NATIVE_HAL_DRIVER_GPIO_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+typedef int gpio_num_t;
+
+enum gpio_int_type_t {
+    GPIO_INTR_DISABLE = 0,
+    GPIO_INTR_POSEDGE = 1,
+    GPIO_INTR_NEGEDGE = 2,
+    GPIO_INTR_ANYEDGE = 3,
+    GPIO_INTR_LOW_LEVEL = 4,
+    GPIO_INTR_HIGH_LEVEL = 5
+};
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type);
+esp_err_t gpio_wakeup_disable(gpio_num_t pin);
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type);
+
+#endif
@@ -0,0 +1,97 @@
+// i2s.h
+// Legacy I2S driver (IDF 4.4) for one transmit port. Writes are paced in
+// simulated time as the DMA would drain them: a write waits while the
+// dma_buf_count buffers are full, and audio that arrives after the queue ran
+// dry counts as an underrun. What plays can be saved with --audio-out.
+#ifndef NATIVE_HAL_DRIVER_I2S_H
+#define NATIVE_HAL_DRIVER_I2S_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK 0
+#define ESP_FAIL -1
+#endif
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+
+#define I2S_PIN_NO_CHANGE (-1)
+
+enum i2s_port_t {
+    I2S_NUM_0 = 0,
+    I2S_NUM_1 = 1
+};
+
+enum i2s_mode_t {
+    I2S_MODE_MASTER = 1,
+    I2S_MODE_SLAVE = 2,
+    I2S_MODE_TX = 4,
+    I2S_MODE_RX = 8,
+    I2S_MODE_DAC_BUILT_IN = 16
+};
+
+enum i2s_bits_per_sample_t {
+    I2S_BITS_PER_SAMPLE_16BIT = 16,
+    I2S_BITS_PER_SAMPLE_32BIT = 32
+};
+
+enum i2s_channel_fmt_t {
+    I2S_CHANNEL_FMT_RIGHT_LEFT = 0,
+    I2S_CHANNEL_FMT_ALL_RIGHT,
+    I2S_CHANNEL_FMT_ALL_LEFT,
+    I2S_CHANNEL_FMT_ONLY_RIGHT,
+    I2S_CHANNEL_FMT_ONLY_LEFT
+};
+
+enum i2s_comm_format_t {
+    I2S_COMM_FORMAT_STAND_I2S = 0x01,
+    I2S_COMM_FORMAT_STAND_MSB = 0x02
+};
+
+enum i2s_dac_mode_t {
+    I2S_DAC_CHANNEL_DISABLE = 0,
+    I2S_DAC_CHANNEL_RIGHT_EN = 1,
+    I2S_DAC_CHANNEL_LEFT_EN = 2,
+    I2S_DAC_CHANNEL_BOTH_EN = 3
+};
+
+struct i2s_config_t {
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+};
+
+struct i2s_pin_config_t {
+    int mck_io_num;
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+};
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t* config, int queueSize, void* queue);
+esp_err_t i2s_driver_uninstall(i2s_port_t port);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t* pins);
+esp_err_t i2s_set_dac_mode(i2s_dac_mode_t mode);
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port);
+esp_err_t i2s_start(i2s_port_t port);
+esp_err_t i2s_stop(i2s_port_t port);
+esp_err_t i2s_write(i2s_port_t port, const void* source, size_t size, size_t* written, uint32_t ticks);
+
+// Save the left channel, as signed 16-bit mono, to a WAV file. Clips follow
+// each other without the idle time in between; underruns appear as silence.
+bool simSetAudioOutput(const char* path);
+// Finish the WAV file and print what was played
+void simFinishAudio();
+
+#endif
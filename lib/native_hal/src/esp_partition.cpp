@@ -0,0 +1,86 @@
+// esp_partition.cpp
+#include <stdio.h>
+#include <string.h>
+#include <list>
+#include <vector>
+#include "esp_partition.h"
+
+#define SIM_FLASH_SECTOR_SIZE 4096
+
+struct SimPartition {
+    esp_partition_t info;
+    std::vector<uint8_t> data;
+};
+
+// A list, so the esp_partition_t pointers handed out stay valid
+static std::list<SimPartition> partitions;
+
+bool simLoadPartition(const char* label, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::vector<uint8_t> contents;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.insert(contents.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    simAddPartition(label, contents.data(), contents.size());
+    return true;
+}
+
+void simAddPartition(const char* label, const uint8_t* contents, size_t size) {
+    SimPartition partition;
+    memset(&partition.info, 0, sizeof(partition.info));
+    partition.info.type = ESP_PARTITION_TYPE_DATA;
+    partition.info.subtype = 0x40;
+    partition.info.size = (size + SIM_FLASH_SECTOR_SIZE - 1) / SIM_FLASH_SECTOR_SIZE * SIM_FLASH_SECTOR_SIZE;
+    strncpy(partition.info.label, label, sizeof(partition.info.label) - 1);
+    partition.data.assign(partition.info.size, 0xFF);
+    memcpy(partition.data.data(), contents, size);
+    partitions.push_back(partition);
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (const SimPartition& partition : partitions) {
+        if (partition.info.type == type && (subtype == ESP_PARTITION_SUBTYPE_ANY || partition.info.subtype == subtype) &&
+            (label == nullptr || strcmp(partition.info.label, label) == 0)) {
+            return &partition.info;
+        }
+    }
+    return nullptr;
+}
+
+static const SimPartition* findPartition(const esp_partition_t* info) {
+    for (const SimPartition& partition : partitions) {
+        if (&partition.info == info) {
+            return &partition;
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* info, size_t offset, void* dst, size_t size) {
+    const SimPartition* partition = findPartition(info);
+    if (partition == nullptr || offset + size > partition->data.size()) {
+        return ESP_FAIL;
+    }
+    memcpy(dst, partition->data.data() + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* info, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out, spi_flash_mmap_handle_t* handle) {
+    const SimPartition* partition = findPartition(info);
+    if (partition == nullptr || offset + size > partition->data.size()) {
+        return ESP_FAIL;
+    }
+    *out = partition->data.data() + offset;
+    *handle = 0;
+    return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {}
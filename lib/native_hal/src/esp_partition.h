@@ -0,0 +1,53 @@
+// esp_partition.h
+// Data partitions backed by files given on the command line (--partition)
+// or bytes handed over by a test, rounded up to whole 4 KB sectors and erased (0xFF) past the end of the file.
+#ifndef NATIVE_HAL_ESP_PARTITION_H
+#define NATIVE_HAL_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+typedef uint32_t spi_flash_mmap_handle_t;
+
+#ifndef ESP_OK
+#define ESP_OK 0
+#define ESP_FAIL -1
+#endif
+#define ESP_ERR_NOT_FOUND 0x105
+
+enum esp_partition_type_t {
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01
+};
+
+enum esp_partition_subtype_t {
+    ESP_PARTITION_SUBTYPE_ANY = 0xff
+};
+
+enum spi_flash_mmap_memory_t {
+    SPI_FLASH_MMAP_DATA,
+    SPI_FLASH_MMAP_INST
+};
+
+struct esp_partition_t {
+    esp_partition_type_t type;
+    uint8_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+    bool encrypted;
+};
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size);
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void** out, spi_flash_mmap_handle_t* handle);
+void spi_flash_munmap(spi_flash_mmap_handle_t handle);
+
+// Add a data partition holding the file's contents, or the given bytes
+bool simLoadPartition(const char* label, const char* path);
+void simAddPartition(const char* label, const uint8_t* contents, size_t size);
+
+#endif
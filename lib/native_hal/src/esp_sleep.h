@@ -0,0 +1,20 @@
+// esp_sleep.h
+#ifndef NATIVE_HAL_ESP_SLEEP_H
+#define NATIVE_HAL_ESP_SLEEP_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+enum esp_sleep_wakeup_cause_t {
+    ESP_SLEEP_WAKEUP_UNDEFINED = 0,
+    ESP_SLEEP_WAKEUP_TIMER = 4,
+    ESP_SLEEP_WAKEUP_GPIO = 7
+};
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+esp_err_t esp_sleep_enable_gpio_wakeup();
+esp_err_t esp_light_sleep_start();
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+
+#endif
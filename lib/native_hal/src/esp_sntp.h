@@ -0,0 +1,15 @@
+// esp_sntp.h
+// SNTP notification API. The answer arrives 150 ms (simulated) after
+// configTime(), on the simulator thread, carrying the true UTC time.
+#ifndef NATIVE_HAL_ESP_SNTP_H
+#define NATIVE_HAL_ESP_SNTP_H
+
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+void sntp_stop();
+bool sntp_enabled();
+
+#endif
@@ -0,0 +1,202 @@
+// i2s.cpp
+#include <stdio.h>
+#include <string.h>
+#include "driver/i2s.h"
+#include "sim_hal.h"
+
+struct SimI2s {
+    bool installed = false;
+    bool running = false;
+    bool dac = false;
+    uint32_t sampleRate = 0;
+    uint32_t bufferFrames = 0;
+    uint32_t bufferCount = 0;
+    uint64_t drainedAt = 0;  // Simulated micros when the queued audio has played
+    bool fed = false;        // Something was written since i2s_start()
+
+    uint32_t starts = 0;
+    uint64_t frames = 0;
+    uint32_t underruns = 0;
+    uint64_t gapFrames = 0;
+};
+
+static SimI2s port0;
+static FILE* audioFile = nullptr;
+static uint64_t audioFileFrames = 0;
+
+static void writeLe16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+static void writeLe32(uint8_t* out, uint32_t value) {
+    writeLe16(out, value & 0xFFFF);
+    writeLe16(out + 2, value >> 16);
+}
+
+// Header for mono 16-bit PCM; rewritten with the final size at the end
+static void writeWavHeader(uint32_t sampleRate, uint32_t frames) {
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    writeLe32(header + 4, 36 + frames * 2);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    writeLe32(header + 16, 16);
+    writeLe16(header + 20, 1);
+    writeLe16(header + 22, 1);
+    writeLe32(header + 24, sampleRate);
+    writeLe32(header + 28, sampleRate * 2);
+    writeLe16(header + 32, 2);
+    writeLe16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    writeLe32(header + 40, frames * 2);
+    fseek(audioFile, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), audioFile);
+    fseek(audioFile, 0, SEEK_END);
+}
+
+static void writeSilence(uint64_t frames) {
+    static const int16_t zeros[256] = {0};
+    while (audioFile != nullptr && frames > 0) {
+        size_t count = frames < 256 ? frames : 256;
+        fwrite(zeros, sizeof(int16_t), count, audioFile);
+        audioFileFrames += count;
+        frames -= count;
+    }
+}
+
+bool simSetAudioOutput(const char* path) {
+    audioFile = fopen(path, "wb");
+    if (audioFile == nullptr) {
+        return false;
+    }
+    writeWavHeader(0, 0);
+    return true;
+}
+
+void simFinishAudio() {
+    if (audioFile != nullptr) {
+        writeWavHeader(port0.sampleRate, audioFileFrames);
+        fclose(audioFile);
+        audioFile = nullptr;
+    }
+    if (port0.installed) {
+        printf("[sim] audio: %u clips started, %.1f s played, %u underruns (%.1f ms of silence)\n", port0.starts,
+               port0.sampleRate > 0 ? (double)port0.frames / port0.sampleRate : 0.0, port0.underruns,
+               port0.sampleRate > 0 ? port0.gapFrames * 1000.0 / port0.sampleRate : 0.0);
+    }
+}
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t* config, int queueSize, void* queue) {
+    if (port != I2S_NUM_0 || config == nullptr || port0.installed || !(config->mode & I2S_MODE_TX) ||
+        config->bits_per_sample != I2S_BITS_PER_SAMPLE_16BIT || config->channel_format != I2S_CHANNEL_FMT_RIGHT_LEFT ||
+        config->dma_buf_count < 2 || config->dma_buf_len < 8 || config->sample_rate == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    port0.installed = true;
+    port0.running = true;  // As on the device, the driver starts right away
+    port0.dac = (config->mode & I2S_MODE_DAC_BUILT_IN) != 0;
+    port0.sampleRate = config->sample_rate;
+    port0.bufferFrames = config->dma_buf_len;
+    port0.bufferCount = config->dma_buf_count;
+    port0.drainedAt = simMicros();
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t port) {
+    port0.installed = false;
+    port0.running = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t* pins) {
+    return port0.installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t i2s_set_dac_mode(i2s_dac_mode_t mode) {
+    return ESP_OK;
+}
+
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port) {
+    if (!port0.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port0.drainedAt = simMicros();  // Whatever was queued is dropped
+    return ESP_OK;
+}
+
+esp_err_t i2s_start(i2s_port_t port) {
+    if (!port0.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port0.running = true;
+    port0.fed = false;
+    port0.drainedAt = simMicros();
+    port0.starts++;
+    return ESP_OK;
+}
+
+esp_err_t i2s_stop(i2s_port_t port) {
+    if (!port0.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    port0.running = false;
+    return ESP_OK;
+}
+
+static uint64_t framesToMicros(uint64_t frames) {
+    return frames * 1000000ULL / port0.sampleRate;
+}
+
+// Frames go out one DMA buffer at a time; each waits until a buffer is free
+esp_err_t i2s_write(i2s_port_t port, const void* source, size_t size, size_t* written, uint32_t ticks) {
+    if (!port0.installed || !port0.running) {
+        if (written != nullptr) {
+            *written = 0;
+        }
+        return ESP_ERR_INVALID_STATE;
+    }
+    const int16_t* samples = (const int16_t*)source;
+    size_t frames = size / (2 * sizeof(int16_t));
+    size_t done = 0;
+    while (done < frames) {
+        size_t chunk = frames - done < port0.bufferFrames ? frames - done : port0.bufferFrames;
+        uint64_t capacity = framesToMicros((uint64_t)port0.bufferCount * port0.bufferFrames);
+        uint64_t room = port0.drainedAt + framesToMicros(chunk);
+        if (room > simMicros() + capacity) {
+            simWaitUntil(room - capacity);
+        }
+
+        uint64_t now = simMicros();
+        if (port0.drainedAt < now) {
+            if (port0.fed) {
+                uint64_t gap = (now - port0.drainedAt) * port0.sampleRate / 1000000ULL;
+                port0.underruns++;
+                port0.gapFrames += gap;
+                writeSilence(gap);
+            }
+            port0.drainedAt = now;
+        }
+        port0.drainedAt += framesToMicros(chunk);
+        port0.fed = true;
+        port0.frames += chunk;
+
+        if (audioFile != nullptr) {
+            int16_t mono[512];
+            for (size_t i = 0; i < chunk;) {
+                size_t count = chunk - i < 512 ? chunk - i : 512;
+                for (size_t j = 0; j < count; j++) {
+                    uint16_t sample = (uint16_t)samples[2 * (done + i + j)];
+                    mono[j] = (int16_t)(port0.dac ? sample ^ 0x8000 : sample);
+                }
+                fwrite(mono, sizeof(int16_t), count, audioFile);
+                audioFileFrames += count;
+                i += count;
+            }
+        }
+        done += chunk;
+    }
+    if (written != nullptr) {
+        *written = frames * 2 * sizeof(int16_t);
+    }
+    return ESP_OK;
+}
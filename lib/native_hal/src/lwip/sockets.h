@@ -0,0 +1,13 @@
+// sockets.h
+// lwIP's BSD socket API is the host's own, so the status server listens on
+// a real loopback port in the simulator.
+#ifndef NATIVE_HAL_LWIP_SOCKETS_H
+#define NATIVE_HAL_LWIP_SOCKETS_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
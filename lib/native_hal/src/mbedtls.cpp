@@ -0,0 +1,210 @@
+// mbedtls.cpp
+#include <stdio.h>
+#include <string.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include "sim_hal.h"
+
+void mbedtls_ssl_init(mbedtls_ssl_context* ssl) {
+    memset(ssl, 0, sizeof(*ssl));
+}
+
+void mbedtls_ssl_free(mbedtls_ssl_context* ssl) {
+    memset(ssl, 0, sizeof(*ssl));
+}
+
+void mbedtls_ssl_config_init(mbedtls_ssl_config* conf) {
+    memset(conf, 0, sizeof(*conf));
+}
+
+void mbedtls_ssl_config_free(mbedtls_ssl_config* conf) {
+    memset(conf, 0, sizeof(*conf));
+}
+
+int mbedtls_ssl_config_defaults(mbedtls_ssl_config* conf, int endpoint, int transport, int preset) {
+    return 0;
+}
+
+void mbedtls_ssl_conf_authmode(mbedtls_ssl_config* conf, int authmode) {
+    conf->authmode = authmode;
+}
+
+void mbedtls_ssl_conf_ca_chain(mbedtls_ssl_config* conf, mbedtls_x509_crt* caChain, mbedtls_x509_crl* caCrl) {}
+
+void mbedtls_ssl_conf_verify(mbedtls_ssl_config* conf, mbedtls_verify_t* verify, void* context) {
+    conf->verify = verify;
+    conf->verifyContext = context;
+}
+
+void mbedtls_ssl_conf_rng(mbedtls_ssl_config* conf, mbedtls_rng_t* rng, void* context) {}
+
+void mbedtls_ssl_conf_session_tickets(mbedtls_ssl_config* conf, int useTickets) {
+    conf->tickets = useTickets;
+}
+
+int mbedtls_ssl_setup(mbedtls_ssl_context* ssl, const mbedtls_ssl_config* conf) {
+    ssl->conf = conf;
+    return 0;
+}
+
+int mbedtls_ssl_set_hostname(mbedtls_ssl_context* ssl, const char* hostname) {
+    snprintf(ssl->host, sizeof(ssl->host), "%s", hostname);
+    return 0;
+}
+
+void mbedtls_ssl_set_bio(mbedtls_ssl_context* ssl, void* bio, mbedtls_ssl_send_t* send, mbedtls_ssl_recv_t* recv,
+                         mbedtls_ssl_recv_timeout_t* recvTimeout) {
+    ssl->bio = bio;
+    ssl->send = send;
+    ssl->recv = recv;
+}
+
+int mbedtls_ssl_handshake(mbedtls_ssl_context* ssl) {
+    uint32_t now = simWallTime();
+    bool resumed = ssl->conf->tickets && strcmp(ssl->offered.host, ssl->host) == 0 &&
+                   now - ssl->offered.issued < SIM_TLS_TICKET_LIFETIME_S;
+    simNoteTlsHandshake(resumed);
+    if (resumed) {
+        ssl->session = ssl->offered;  // The server keeps its ticket
+        return 0;
+    }
+
+    uint32_t flags = 0;
+    if (ssl->conf->verify != nullptr) {
+        mbedtls_x509_crt leaf = {1};
+        ssl->conf->verify(ssl->conf->verifyContext, &leaf, 0, &flags);
+    }
+    snprintf(ssl->session.host, sizeof(ssl->session.host), "%s", ssl->host);
+    ssl->session.issued = now;
+    return 0;
+}
+
+int mbedtls_ssl_read(mbedtls_ssl_context* ssl, unsigned char* buf, size_t length) {
+    if (ssl->position == ssl->length) {
+        int received = ssl->recv(ssl->bio, ssl->buffer, sizeof(ssl->buffer));
+        if (received < 0) {
+            return received;
+        }
+        if (received == 0) {
+            return MBEDTLS_ERR_SSL_CONN_EOF;
+        }
+        ssl->length = received;
+        ssl->position = 0;
+    }
+    size_t count = ssl->length - ssl->position;
+    if (count > length) {
+        count = length;
+    }
+    if (count > 0) {
+        memcpy(buf, ssl->buffer + ssl->position, count);
+        ssl->position += count;
+    }
+    return (int)count;
+}
+
+int mbedtls_ssl_write(mbedtls_ssl_context* ssl, const unsigned char* buf, size_t length) {
+    return ssl->send(ssl->bio, buf, length);
+}
+
+size_t mbedtls_ssl_get_bytes_avail(const mbedtls_ssl_context* ssl) {
+    return ssl->length - ssl->position;
+}
+
+int mbedtls_ssl_close_notify(mbedtls_ssl_context* ssl) {
+    return 0;
+}
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session* session) {
+    memset(session, 0, sizeof(*session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session* session) {
+    memset(session, 0, sizeof(*session));
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context* ssl, const mbedtls_ssl_session* session) {
+    ssl->offered = *session;
+    return 0;
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context* ssl, mbedtls_ssl_session* session) {
+    *session = ssl->session;
+    return 0;
+}
+
+int mbedtls_ssl_session_save(const mbedtls_ssl_session* session, unsigned char* buf, size_t length, size_t* written) {
+    int n = snprintf((char*)buf, length, "simtls %s %u", session->host, (unsigned)session->issued);
+    if (n < 0 || (size_t)n >= length) {
+        return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+    *written = n;
+    return 0;
+}
+
+int mbedtls_ssl_session_load(mbedtls_ssl_session* session, const unsigned char* buf, size_t length) {
+    char text[96];
+    unsigned issued;
+    if (length >= sizeof(text)) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    memcpy(text, buf, length);
+    text[length] = '\0';
+    if (sscanf(text, "simtls %63s %u", session->host, &issued) != 2) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    session->issued = issued;
+    return 0;
+}
+
+void mbedtls_x509_crt_init(mbedtls_x509_crt* crt) {
+    crt->certificates = 0;
+}
+
+void mbedtls_x509_crt_free(mbedtls_x509_crt* crt) {
+    crt->certificates = 0;
+}
+
+int mbedtls_x509_crt_parse(mbedtls_x509_crt* chain, const unsigned char* buf, size_t length) {
+    // PEM input must include its terminating NUL, as with the real parser
+    if (length == 0 || buf[length - 1] != '\0') {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    for (const char* pem = strstr((const char*)buf, "-----BEGIN CERTIFICATE-----"); pem != nullptr;
+         pem = strstr(pem + 1, "-----BEGIN CERTIFICATE-----")) {
+        chain->certificates++;
+    }
+    return chain->certificates > 0 ? 0 : MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+}
+
+void mbedtls_ctr_drbg_init(mbedtls_ctr_drbg_context* ctx) {
+    ctx->seeded = 0;
+}
+
+void mbedtls_ctr_drbg_free(mbedtls_ctr_drbg_context* ctx) {
+    ctx->seeded = 0;
+}
+
+int mbedtls_ctr_drbg_seed(mbedtls_ctr_drbg_context* ctx, int (*entropy)(void*, unsigned char*, size_t),
+                          void* entropyContext, const unsigned char* custom, size_t length) {
+    ctx->seeded = 1;
+    return 0;
+}
+
+int mbedtls_ctr_drbg_random(void* ctx, unsigned char* output, size_t length) {
+    memset(output, 0x5A, length);
+    return 0;
+}
+
+void mbedtls_entropy_init(mbedtls_entropy_context* ctx) {
+    ctx->sources = 1;
+}
+
+void mbedtls_entropy_free(mbedtls_entropy_context* ctx) {
+    ctx->sources = 0;
+}
+
+int mbedtls_entropy_func(void* data, unsigned char* output, size_t length) {
+    memset(output, 0xA5, length);
+    return 0;
+}
@@ -0,0 +1,17 @@
+// mbedtls/ctr_drbg.h
+#ifndef NATIVE_HAL_MBEDTLS_CTR_DRBG_H
+#define NATIVE_HAL_MBEDTLS_CTR_DRBG_H
+
+#include <stddef.h>
+
+typedef struct mbedtls_ctr_drbg_context {
+    int seeded;
+} mbedtls_ctr_drbg_context;
+
+void mbedtls_ctr_drbg_init(mbedtls_ctr_drbg_context* ctx);
+void mbedtls_ctr_drbg_free(mbedtls_ctr_drbg_context* ctx);
+int mbedtls_ctr_drbg_seed(mbedtls_ctr_drbg_context* ctx, int (*entropy)(void*, unsigned char*, size_t),
+                          void* entropyContext, const unsigned char* custom, size_t length);
+int mbedtls_ctr_drbg_random(void* ctx, unsigned char* output, size_t length);
+
+#endif
@@ -0,0 +1,96 @@
+// mbedtls/ssl.h
+// The slice of the mbedTLS 2.x client API the firmware uses. No cryptography:
+// records pass through the BIO callbacks in clear. A handshake resumes when
+// the offered session was issued for the same host within a day (a stand-in
+// for the server's ticket lifetime); otherwise it is a full one and runs the
+// verify callback.
+#ifndef NATIVE_HAL_MBEDTLS_SSL_H
+#define NATIVE_HAL_MBEDTLS_SSL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MBEDTLS_SSL_IS_CLIENT 0
+#define MBEDTLS_SSL_TRANSPORT_STREAM 0
+#define MBEDTLS_SSL_PRESET_DEFAULT 0
+#define MBEDTLS_SSL_VERIFY_REQUIRED 2
+#define MBEDTLS_SSL_SESSION_TICKETS_ENABLED 1
+
+#define MBEDTLS_ERR_SSL_WANT_READ -0x6900
+#define MBEDTLS_ERR_SSL_WANT_WRITE -0x6880
+#define MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY -0x7880
+#define MBEDTLS_ERR_SSL_CONN_EOF -0x7280
+#define MBEDTLS_ERR_SSL_BAD_INPUT_DATA -0x7100
+#define MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL -0x6A00
+
+#define SIM_TLS_TICKET_LIFETIME_S 86400UL
+
+typedef struct mbedtls_x509_crt {
+    int certificates;
+} mbedtls_x509_crt;
+
+typedef struct mbedtls_x509_crl mbedtls_x509_crl;
+
+typedef int mbedtls_ssl_send_t(void* context, const unsigned char* buf, size_t length);
+typedef int mbedtls_ssl_recv_t(void* context, unsigned char* buf, size_t length);
+typedef int mbedtls_ssl_recv_timeout_t(void* context, unsigned char* buf, size_t length, uint32_t timeout);
+typedef int mbedtls_verify_t(void* context, mbedtls_x509_crt* certificate, int depth, uint32_t* flags);
+typedef int mbedtls_rng_t(void* context, unsigned char* output, size_t length);
+
+typedef struct mbedtls_ssl_session {
+    char host[64];
+    uint32_t issued;  // Simulated wall time
+} mbedtls_ssl_session;
+
+typedef struct mbedtls_ssl_config {
+    int authmode;
+    int tickets;
+    mbedtls_verify_t* verify;
+    void* verifyContext;
+} mbedtls_ssl_config;
+
+typedef struct mbedtls_ssl_context {
+    const mbedtls_ssl_config* conf;
+    char host[64];
+    mbedtls_ssl_send_t* send;
+    mbedtls_ssl_recv_t* recv;
+    void* bio;
+    mbedtls_ssl_session offered;
+    mbedtls_ssl_session session;
+    unsigned char buffer[512];  // Received plaintext not read yet
+    size_t length;
+    size_t position;
+} mbedtls_ssl_context;
+
+void mbedtls_ssl_init(mbedtls_ssl_context* ssl);
+void mbedtls_ssl_free(mbedtls_ssl_context* ssl);
+void mbedtls_ssl_config_init(mbedtls_ssl_config* conf);
+void mbedtls_ssl_config_free(mbedtls_ssl_config* conf);
+int mbedtls_ssl_config_defaults(mbedtls_ssl_config* conf, int endpoint, int transport, int preset);
+void mbedtls_ssl_conf_authmode(mbedtls_ssl_config* conf, int authmode);
+void mbedtls_ssl_conf_ca_chain(mbedtls_ssl_config* conf, mbedtls_x509_crt* caChain, mbedtls_x509_crl* caCrl);
+void mbedtls_ssl_conf_verify(mbedtls_ssl_config* conf, mbedtls_verify_t* verify, void* context);
+void mbedtls_ssl_conf_rng(mbedtls_ssl_config* conf, mbedtls_rng_t* rng, void* context);
+void mbedtls_ssl_conf_session_tickets(mbedtls_ssl_config* conf, int useTickets);
+int mbedtls_ssl_setup(mbedtls_ssl_context* ssl, const mbedtls_ssl_config* conf);
+int mbedtls_ssl_set_hostname(mbedtls_ssl_context* ssl, const char* hostname);
+void mbedtls_ssl_set_bio(mbedtls_ssl_context* ssl, void* bio, mbedtls_ssl_send_t* send, mbedtls_ssl_recv_t* recv,
+                         mbedtls_ssl_recv_timeout_t* recvTimeout);
+int mbedtls_ssl_handshake(mbedtls_ssl_context* ssl);
+int mbedtls_ssl_read(mbedtls_ssl_context* ssl, unsigned char* buf, size_t length);
+int mbedtls_ssl_write(mbedtls_ssl_context* ssl, const unsigned char* buf, size_t length);
+size_t mbedtls_ssl_get_bytes_avail(const mbedtls_ssl_context* ssl);
+int mbedtls_ssl_close_notify(mbedtls_ssl_context* ssl);
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session* session);
+void mbedtls_ssl_session_free(mbedtls_ssl_session* session);
+int mbedtls_ssl_set_session(mbedtls_ssl_context* ssl, const mbedtls_ssl_session* session);
+int mbedtls_ssl_get_session(const mbedtls_ssl_context* ssl, mbedtls_ssl_session* session);
+int mbedtls_ssl_session_save(const mbedtls_ssl_session* session, unsigned char* buf, size_t length, size_t* written);
+int mbedtls_ssl_session_load(mbedtls_ssl_session* session, const unsigned char* buf, size_t length);
+
+void mbedtls_x509_crt_init(mbedtls_x509_crt* crt);
+void mbedtls_x509_crt_free(mbedtls_x509_crt* crt);
+int mbedtls_x509_crt_parse(mbedtls_x509_crt* chain, const unsigned char* buf, size_t length);
+
+#endif
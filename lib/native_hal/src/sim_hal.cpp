@@ -0,0 +1,901 @@
+// sim_hal.cpp
+// Simulated clock, pins, interrupts, RTC, buzzer, FreeRTOS and sleep for env:native.
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <esp_sntp.h>
+#include <malloc.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "sim_hal.h"
+
+#define SIM_PIN_COUNT 40
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ---- Clock ----
+
+static std::atomic<uint64_t> nowMicros(0);
+static std::thread::id mainThread;
+static uint32_t wallEpochAtZero = 0;  // Wall time when nowMicros was 0
+
+static void startHeapModel();
+
+void simBindMainThread() {
+    mainThread = std::this_thread::get_id();
+    startHeapModel();
+}
+
+uint64_t simMicros() {
+    return nowMicros;
+}
+
+unsigned long millis() {
+    return (unsigned long)(nowMicros / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)nowMicros;
+}
+
+void delay(uint32_t ms) {
+    if (std::this_thread::get_id() == mainThread) {
+        simAdvance((uint64_t)ms * 1000);
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+void delayMicroseconds(uint32_t us) {
+    if (std::this_thread::get_id() == mainThread) {
+        simAdvance(us);
+    }
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+void simSetWallTime(uint32_t localEpoch) {
+    wallEpochAtZero = localEpoch - (uint32_t)(nowMicros / 1000000);
+}
+
+uint32_t simWallTime() {
+    return wallEpochAtZero + (uint32_t)(nowMicros / 1000000);
+}
+
+void simFormatWallTime(char* out, size_t size) {
+    time_t seconds = simWallTime();
+    struct tm parts;
+    gmtime_r(&seconds, &parts);
+    snprintf(out, size, "%04d-%02d-%02d %02d:%02d:%02d.%03u", parts.tm_year + 1900, parts.tm_mon + 1,
+             parts.tm_mday, parts.tm_hour, parts.tm_min, parts.tm_sec, (unsigned)(nowMicros / 1000 % 1000));
+}
+
+// ---- Pins and interrupts ----
+
+struct SimPin {
+    int level = HIGH;
+    void (*handler)() = nullptr;
+    int mode = 0;
+    bool wakeEnabled = false;
+    int wakeLevel = LOW;
+};
+
+struct SimPinEvent {
+    uint64_t micros;
+    uint8_t pin;
+    int level;
+};
+
+static SimPin pins[SIM_PIN_COUNT];
+static std::deque<SimPinEvent> pinEvents;  // Sorted by time
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+int digitalRead(uint8_t pin) {
+    return pin < SIM_PIN_COUNT ? pins[pin].level : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < SIM_PIN_COUNT) {
+        pins[pin].level = level ? HIGH : LOW;
+    }
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+    return pin;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+    if (pin < SIM_PIN_COUNT) {
+        pins[pin].handler = handler;
+        pins[pin].mode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < SIM_PIN_COUNT) {
+        pins[pin].handler = nullptr;
+    }
+}
+
+static void applyPinLevel(uint8_t pin, int level, bool runInterrupts) {
+    SimPin& state = pins[pin];
+    if (state.level == level) {
+        return;
+    }
+    state.level = level;
+    bool fire = state.mode == CHANGE || (state.mode == FALLING && level == LOW) ||
+                (state.mode == RISING && level == HIGH);
+    if (runInterrupts && fire && state.handler != nullptr) {
+        state.handler();
+    }
+}
+
+void simSetPinLevel(uint8_t pin, int level) {
+    if (pin < SIM_PIN_COUNT) {
+        applyPinLevel(pin, level, true);
+    }
+}
+
+static void addPinEvent(uint64_t at, uint8_t pin, int level) {
+    SimPinEvent event = {at, pin, level};
+    auto it = pinEvents.begin();
+    while (it != pinEvents.end() && it->micros <= at) ++it;
+    pinEvents.insert(it, event);
+}
+
+void simScheduleButtonPress(uint8_t pin, uint64_t atMicros, uint32_t durationMs) {
+    addPinEvent(atMicros, pin, LOW);
+    addPinEvent(atMicros + (uint64_t)durationMs * 1000, pin, HIGH);
+}
+
+// ---- DS3231 ----
+
+static uint8_t sqwPin = 4;  // SIM_PIN_COUNT or above: SQW not wired
+static bool sqwEnabled = false;
+static bool rtcPowerLost = false;
+// The DS3231 counts at a rate set by its crystal error and aging offset.
+// rtcAnchor is its time (µs, local epoch) at simulator time anchorMicros; a
+// write restarts the second countdown and a rate change moves the anchor.
+static uint64_t anchorMicros = 0;
+static long double rtcAnchor = 0;
+static double rtcDriftPpm = 0;
+static int8_t rtcAging = 0;
+
+static long double rtcRate() {
+    return 1.0L + (rtcDriftPpm - rtcAging * 0.1) * 1e-6L;
+}
+
+static long double rtcMicrosAt(uint64_t simTime) {
+    return rtcAnchor + (long double)(int64_t)(simTime - anchorMicros) * rtcRate();
+}
+
+static void reanchorRtc() {
+    rtcAnchor = rtcMicrosAt(nowMicros);
+    anchorMicros = nowMicros;
+}
+
+void simSetSqwPin(uint8_t pin) {
+    sqwPin = pin;
+}
+
+void simSetRtcTime(uint32_t localEpoch) {
+    rtcAnchor = (long double)localEpoch * 1000000.0L;
+    anchorMicros = nowMicros;
+}
+
+uint32_t simRtcTime() {
+    return (uint32_t)(uint64_t)(rtcMicrosAt(nowMicros) / 1000000.0L);
+}
+
+void simSetRtcLostPower(bool lost) {
+    rtcPowerLost = lost;
+}
+
+bool simRtcLostPower() {
+    return rtcPowerLost;
+}
+
+void simSetRtcSqw(bool enabled) {
+    sqwEnabled = enabled && sqwPin < SIM_PIN_COUNT;
+    if (sqwEnabled) {
+        pins[sqwPin].level = HIGH;
+    }
+}
+
+void simSetRtcDrift(double ppm) {
+    reanchorRtc();
+    rtcDriftPpm = ppm;
+}
+
+void simSetRtcAging(int8_t aging) {
+    reanchorRtc();
+    rtcAging = aging;
+}
+
+int8_t simRtcAging() {
+    return rtcAging;
+}
+
+int64_t simRtcErrorMicros() {
+    long double wall = (long double)wallEpochAtZero * 1000000.0L + (long double)nowMicros;
+    return (int64_t)(rtcMicrosAt(nowMicros) - wall);
+}
+
+// Next RTC second rollover after the given time; the SQW falls there
+static uint64_t nextSqwEdge(uint64_t after) {
+    long double second = floorl(rtcMicrosAt(after) / 1000000.0L) + 1;
+    uint64_t edge = anchorMicros + (uint64_t)ceill((second * 1000000.0L - rtcAnchor) / rtcRate());
+    return edge > after ? edge : after + 1;
+}
+
+// ---- SNTP ----
+
+static bool ntpAvailable = true;
+static bool ntpConfigured = false;
+static long ntpOffsetSec = 0;                   // gmtOffset + daylightOffset from configTime()
+static std::atomic<uint64_t> sntpAnswerAt(0);   // 0: no request in flight
+static sntp_sync_time_cb_t sntpCallback = nullptr;
+
+// Runs on the simulator thread, standing in for the lwIP task
+static void answerSntp() {
+    sntpAnswerAt = 0;
+    if (sntpCallback == nullptr) {
+        return;
+    }
+    int64_t utcMicros = (int64_t)wallEpochAtZero * 1000000LL + (int64_t)nowMicros - (int64_t)ntpOffsetSec * 1000000LL;
+    struct timeval tv;
+    tv.tv_sec = (time_t)(utcMicros / 1000000LL);
+    tv.tv_usec = (suseconds_t)(utcMicros % 1000000LL);
+    sntpCallback(&tv);
+}
+
+static bool nextTaskWake(uint64_t& at);
+static void wakeTasksAt(uint64_t at);
+
+// Move the clock to target, running due events in time order
+static void advanceTo(uint64_t target, bool runInterrupts) {
+    while (true) {
+        uint64_t next = target;
+        uint64_t taskWake = 0;
+        if (nextTaskWake(taskWake) && taskWake <= next) {
+            // A task waiting on simulated time (the I2C bus) resumes first and runs until it blocks
+            if (taskWake > nowMicros) {
+                nowMicros = taskWake;
+            }
+            wakeTasksAt(taskWake);
+            continue;
+        }
+        bool sqwDue = false;
+        if (sqwEnabled) {
+            uint64_t edge = nextSqwEdge(nowMicros);
+            if (edge <= next) {
+                next = edge;
+                sqwDue = true;
+            }
+        }
+        bool pinDue = !pinEvents.empty() && pinEvents.front().micros <= next;
+        if (pinDue) {
+            next = pinEvents.front().micros;
+            sqwDue = sqwDue && nextSqwEdge(nowMicros) == next;
+        }
+        uint64_t answerAt = sntpAnswerAt;
+        bool sntpDue = answerAt != 0 && answerAt <= next;
+        if (sntpDue) {
+            next = answerAt;
+            pinDue = pinDue && pinEvents.front().micros == next;
+            sqwDue = sqwDue && nextSqwEdge(nowMicros) == next;
+        }
+        nowMicros = next;
+
+        if (sntpDue) {
+            answerSntp();
+        }
+
+        if (pinDue) {
+            SimPinEvent event = pinEvents.front();
+            pinEvents.pop_front();
+            applyPinLevel(event.pin, event.level, runInterrupts);
+        }
+        if (sqwDue) {
+            // Short low pulse; the firmware only listens for the falling edge
+            applyPinLevel(sqwPin, LOW, runInterrupts);
+            applyPinLevel(sqwPin, HIGH, runInterrupts);
+        }
+        if (!pinDue && !sqwDue && !sntpDue) {
+            return;
+        }
+    }
+}
+
+void simAdvance(uint64_t micros) {
+    advanceTo(nowMicros + micros, true);
+}
+
+// ---- Sleep ----
+
+static uint64_t sleepTimerMicros = 0;
+static bool gpioWakeup = false;
+static esp_sleep_wakeup_cause_t wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+void simSetGpioWakeup(uint8_t pin, bool enabled, int level) {
+    if (pin < SIM_PIN_COUNT) {
+        pins[pin].wakeEnabled = enabled;
+        pins[pin].wakeLevel = level;
+    }
+}
+
+bool simLightSleep(uint64_t maxMicros) {
+    uint64_t target = nowMicros + maxMicros;
+    // Stop just before the first event that would pull a wake pin to its level
+    for (const SimPinEvent& event : pinEvents) {
+        if (event.micros >= target) {
+            break;
+        }
+        if (gpioWakeup && pins[event.pin].wakeEnabled && event.level == pins[event.pin].wakeLevel) {
+            advanceTo(event.micros > nowMicros ? event.micros - 1 : (uint64_t)nowMicros, false);
+            return true;
+        }
+    }
+    advanceTo(target, false);
+    return false;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type) {
+    simSetGpioWakeup(pin, true, type == GPIO_INTR_HIGH_LEVEL ? HIGH : LOW);
+    return 0;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t pin) {
+    simSetGpioWakeup(pin, false, LOW);
+    return 0;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type) {
+    return 0;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+    sleepTimerMicros = timeUs;
+    return 0;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+    gpioWakeup = true;
+    return 0;
+}
+
+esp_err_t esp_light_sleep_start() {
+    bool byGpio = simLightSleep(sleepTimerMicros);
+    wakeupCause = byGpio ? ESP_SLEEP_WAKEUP_GPIO : ESP_SLEEP_WAKEUP_TIMER;
+    return 0;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+    return wakeupCause;
+}
+
+// ---- Buzzer ----
+
+#define SIM_TONE_LOG_RESERVE 65536  // Changes; a month of alerts is a few thousand
+
+static std::vector<SimToneEvent> toneLog;
+static bool printTones = true;
+static uint8_t pinChannels[SIM_PIN_COUNT];
+
+const std::vector<SimToneEvent>& simToneLog() {
+    return toneLog;
+}
+
+void simSetToneLogging(bool print) {
+    printTones = print;
+}
+
+static void recordTone(uint8_t channel, double frequency) {
+    if (!toneLog.empty() && toneLog.back().channel == channel && toneLog.back().frequency == frequency) {
+        return;
+    }
+    SimToneEvent event = {nowMicros, channel, frequency};
+    toneLog.push_back(event);
+    if (printTones) {
+        char when[32];
+        simFormatWallTime(when, sizeof(when));
+        printf("[sim %s] buzzer ch%u %s\n", when, channel,
+               frequency > 0 ? String(frequency, 0).c_str() : "off");
+    }
+}
+
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolutionBits) {
+    return frequency;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (pin < SIM_PIN_COUNT) {
+        pinChannels[pin] = channel;
+    }
+}
+
+double ledcWriteTone(uint8_t channel, double frequency) {
+    recordTone(channel, frequency);
+    return frequency;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (duty == 0) {
+        recordTone(channel, 0);
+    }
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    recordTone(pin < SIM_PIN_COUNT ? pinChannels[pin] : 0, frequency);
+}
+
+void noTone(uint8_t pin) {
+    recordTone(pin < SIM_PIN_COUNT ? pinChannels[pin] : 0, 0);
+}
+
+// ---- SNTP ----
+
+void simSetNtpAvailable(bool available) {
+    ntpAvailable = available;
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2,
+                const char* server3) {
+    // The simulated wall clock is already local time
+    ntpConfigured = true;
+    ntpOffsetSec = gmtOffsetSec + daylightOffsetSec;
+    if (ntpAvailable && simWifiAvailable()) {
+        sntpAnswerAt = nowMicros + 150000;
+    }
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {
+    sntpCallback = callback;
+}
+
+void sntp_stop() {
+    sntpAnswerAt = 0;
+}
+
+bool sntp_enabled() {
+    return sntpAnswerAt != 0;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    if (!ntpConfigured || !ntpAvailable || !simWifiAvailable()) {
+        return false;
+    }
+    time_t seconds = simWallTime();
+    gmtime_r(&seconds, info);
+    return true;
+}
+
+// ---- Serial and ESP ----
+
+// Console input, ordered by the time it arrives
+static std::deque<std::pair<uint64_t, uint8_t>> serialInput;
+static std::mutex serialLock;
+
+void simScheduleSerialInput(uint64_t atMicros, const char* text) {
+    std::lock_guard<std::mutex> guard(serialLock);
+    auto it = serialInput.begin();
+    while (it != serialInput.end() && it->first <= atMicros) {
+        ++it;
+    }
+    for (const char* c = text; *c != '\0'; c++) {
+        it = serialInput.insert(it, std::make_pair(atMicros, (uint8_t)*c)) + 1;
+    }
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> guard(serialLock);
+    int count = 0;
+    for (const auto& input : serialInput) {
+        if (input.first > nowMicros) {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> guard(serialLock);
+    return !serialInput.empty() && serialInput.front().first <= nowMicros ? serialInput.front().second : -1;
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> guard(serialLock);
+    if (serialInput.empty() || serialInput.front().first > nowMicros) {
+        return -1;
+    }
+    int c = serialInput.front().second;
+    serialInput.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+// The heap is SIM_HEAP_SIZE bytes less what glibc has handed out since
+// startHeapModel(). Free chunks stranded between live ones are holes; they
+// count against the largest block, as fragmentation does on the ESP32. One
+// malloc arena, so allocations on every task show up. Host sizes, so the
+// figures are for spotting trends (leaks, creeping fragmentation) rather
+// than for comparing with a board.
+#define SIM_HEAP_SIZE 320000
+
+static size_t heapUsedAtStart = 0;
+static size_t heapHolesAtStart = 0;
+static std::atomic<uint32_t> heapLowWater(SIM_HEAP_SIZE);
+
+static void measureHeap(size_t& used, size_t& holes) {
+    struct mallinfo2 info = mallinfo2();
+    used = info.uordblks + info.hblkhd;
+    holes = info.fordblks - info.keepcost;  // keepcost is the free top of the arena
+}
+
+static void startHeapModel() {
+    mallopt(M_ARENA_MAX, 1);
+    toneLog.reserve(SIM_TONE_LOG_RESERVE);  // Grown ahead, so the log is not mistaken for a leak
+    measureHeap(heapUsedAtStart, heapHolesAtStart);
+    heapLowWater = SIM_HEAP_SIZE;
+}
+
+static uint32_t freeHeapNow(size_t& holes) {
+    size_t used;
+    measureHeap(used, holes);
+    int64_t freeBytes = (int64_t)SIM_HEAP_SIZE - ((int64_t)used - (int64_t)heapUsedAtStart);
+    uint32_t result = freeBytes < 0 ? 0 : freeBytes > SIM_HEAP_SIZE ? SIM_HEAP_SIZE : (uint32_t)freeBytes;
+    uint32_t low = heapLowWater;
+    while (result < low && !heapLowWater.compare_exchange_weak(low, result)) {
+    }
+    return result;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    size_t holes;
+    return freeHeapNow(holes);
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    size_t holes;
+    freeHeapNow(holes);
+    return heapLowWater;
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    size_t holes;
+    uint32_t freeBytes = freeHeapNow(holes);
+    size_t newHoles = holes > heapHolesAtStart ? holes - heapHolesAtStart : 0;
+    return newHoles < freeBytes ? freeBytes - newHoles : 0;
+}
+
+uint32_t EspClass::getHeapSize() {
+    return SIM_HEAP_SIZE;
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t EspClass::getCpuFreqMHz() {
+    return 1000;
+}
+
+void EspClass::restart() {
+    printf("[sim] ESP.restart() called, stopping the simulation\n");
+    fflush(stdout);
+    _Exit(0);
+}
+
+// ---- FreeRTOS ----
+
+// Tasks that wait on notifications run in lock-step with the simulator thread:
+// once woken they run until they block again (on a notification or on
+// simulated time) before the simulator moves on, as a higher-priority task
+// would. Other tasks (the network task) just run freely on their thread.
+struct SimTask {
+    TaskFunction_t function;
+    void* parameter;
+    uint32_t notifications = 0;
+    bool lockstep = false;     // Has waited on a notification
+    bool running = true;
+    uint64_t wakeAt = 0;       // Waiting on simulated time until then, 0 if not
+};
+
+static std::mutex taskLock;
+static std::condition_variable taskChanged;
+static std::vector<SimTask*> simTasks;
+static thread_local SimTask* currentTask = nullptr;
+
+// Simulator thread: wait until every lock-step task has blocked
+static void settleTasks(std::unique_lock<std::mutex>& guard) {
+    taskChanged.wait(guard, [] {
+        for (SimTask* task : simTasks) {
+            if (task->lockstep && task->running) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+static bool nextTaskWake(uint64_t& at) {
+    std::lock_guard<std::mutex> guard(taskLock);
+    bool found = false;
+    for (SimTask* task : simTasks) {
+        if (task->wakeAt != 0 && (!found || task->wakeAt < at)) {
+            at = task->wakeAt;
+            found = true;
+        }
+    }
+    return found;
+}
+
+static void wakeTasksAt(uint64_t at) {
+    std::unique_lock<std::mutex> guard(taskLock);
+    for (SimTask* task : simTasks) {
+        if (task->wakeAt != 0 && task->wakeAt <= at) {
+            task->wakeAt = 0;
+            task->running = true;
+        }
+    }
+    taskChanged.notify_all();
+    settleTasks(guard);
+}
+
+bool simWaitUntil(uint64_t micros) {
+    if (std::this_thread::get_id() == mainThread) {
+        if (micros > nowMicros) {
+            simAdvance(micros - nowMicros);
+        }
+        return true;
+    }
+    SimTask* task = currentTask;
+    if (task == nullptr || !task->lockstep || micros <= nowMicros) {
+        return false;
+    }
+    std::unique_lock<std::mutex> guard(taskLock);
+    task->wakeAt = micros;
+    task->running = false;
+    taskChanged.notify_all();
+    taskChanged.wait(guard, [task] { return task->running; });
+    return true;
+}
+
+static void runSimTask(SimTask* task) {
+    currentTask = task;
+    task->function(task->parameter);
+}
+
+struct SimQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+
+static std::recursive_mutex criticalLock;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stackDepth, void* parameter,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    SimTask* simTask = new SimTask();
+    simTask->function = task;
+    simTask->parameter = parameter;
+    {
+        std::lock_guard<std::mutex> guard(taskLock);
+        simTasks.push_back(simTask);
+    }
+    std::thread(runSimTask, simTask).detach();
+    if (handle != nullptr) {
+        *handle = simTask;
+    }
+    return pdPASS;
+}
+
+// The main thread stands for the loop task, so tasks can notify it too
+static SimTask mainTask;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (currentTask != nullptr) {
+        return currentTask;
+    }
+    return std::this_thread::get_id() == mainThread ? &mainTask : nullptr;
+}
+
+// Function to wait on the main thread: simulated time moves on to each task's next wake-up
+// (or by a millisecond when none is due), as the task it waits for may be on the simulated bus
+static uint32_t takeMainNotifications(BaseType_t clearOnExit, TickType_t ticks) {
+    uint64_t deadline = ticks == portMAX_DELAY ? UINT64_MAX : nowMicros + (uint64_t)ticks * 1000;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> guard(taskLock);
+            if (mainTask.notifications > 0) {
+                uint32_t count = mainTask.notifications;
+                mainTask.notifications = clearOnExit ? 0 : count - 1;
+                return count;
+            }
+        }
+        if (nowMicros >= deadline) {
+            return 0;
+        }
+        uint64_t at;
+        if (!nextTaskWake(at) || at <= nowMicros) {
+            at = nowMicros + 1000;
+        }
+        simAdvance((at < deadline ? at : deadline) - nowMicros);
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    SimTask* task = currentTask;
+    if (task == nullptr) {
+        return std::this_thread::get_id() == mainThread ? takeMainNotifications(clearOnExit, ticks) : 0;
+    }
+    std::unique_lock<std::mutex> guard(taskLock);
+    task->lockstep = true;
+    if (task->notifications == 0) {
+        if (ticks != portMAX_DELAY) {
+            return 0;
+        }
+        task->running = false;
+        taskChanged.notify_all();
+        taskChanged.wait(guard, [task] { return task->notifications > 0; });
+        task->running = true;
+    }
+    uint32_t count = task->notifications;
+    task->notifications = clearOnExit ? 0 : count - 1;
+    return count;
+}
+
+void xTaskNotifyGive(TaskHandle_t handle) {
+    SimTask* task = (SimTask*)handle;
+    std::unique_lock<std::mutex> guard(taskLock);
+    bool fromSimulator = std::this_thread::get_id() == mainThread;
+    if (fromSimulator) {
+        taskChanged.wait(guard, [task] { return task->lockstep; });  // Let it reach its first wait
+    }
+    task->notifications++;
+    if (task->wakeAt == 0) {
+        task->running = true;  // Wakes it if it waits on a notification
+    }
+    taskChanged.notify_all();
+    if (fromSimulator) {
+        settleTasks(guard);
+    }
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stackDepth, void* parameter,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(task, name, stackDepth, parameter, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
+
+void vTaskDelete(TaskHandle_t task) {}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+TickType_t xTaskGetTickCount() {
+    return millis();
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue* queue = new SimQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t handle, const void* item, TickType_t ticks) {
+    SimQueue* queue = (SimQueue*)handle;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->items.size() >= queue->length) {
+        return errQUEUE_FULL;
+    }
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->itemSize));
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void* item, TickType_t ticks) {
+    SimQueue* queue = (SimQueue*)handle;
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (ticks == portMAX_DELAY) {
+        queue->changed.wait(guard, [queue] { return !queue->items.empty(); });
+    } else if (queue->items.empty()) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle) {
+    SimQueue* queue = (SimQueue*)handle;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new std::recursive_mutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    std::recursive_mutex* mutex = (std::recursive_mutex*)semaphore;
+    if (ticks == portMAX_DELAY) {
+        mutex->lock();
+        return pdTRUE;
+    }
+    return mutex->try_lock() ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    ((std::recursive_mutex*)semaphore)->unlock();
+    return pdTRUE;
+}
+
+void portENTER_CRITICAL(portMUX_TYPE* mux) {
+    criticalLock.lock();
+}
+
+void portEXIT_CRITICAL(portMUX_TYPE* mux) {
+    criticalLock.unlock();
+}
+
+// Route C++ allocations through malloc in this image so that the firmware's
+// -Wl,--wrap=malloc counter (heap_monitor.cpp) sees String and new as well
+void* operator new(size_t size) {
+    void* ptr = malloc(size != 0 ? size : 1);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
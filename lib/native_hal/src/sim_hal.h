@@ -0,0 +1,99 @@
+// sim_hal.h
+// Control side of the native HAL: the simulator drives the clock, pins,
+// RTC, network and inspects the buzzer and display through these calls.
+#ifndef NATIVE_HAL_SIM_HAL_H
+#define NATIVE_HAL_SIM_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "WString.h"
+
+// Clock. Only the simulator thread advances time; delay() on other tasks just yields.
+// Binding also starts the heap model: ESP.getFreeHeap() and friends report a
+// SIM_HEAP_SIZE heap minus what the process has allocated since.
+void simBindMainThread();
+uint64_t simMicros();
+void simAdvance(uint64_t micros);  // Fires pin and SQW interrupts that fall due, in order
+// Block the calling task until the simulated clock reaches micros (the simulator thread
+// advances to it). Only for tasks that wait on notifications; returns false elsewhere.
+bool simWaitUntil(uint64_t micros);
+
+// Wall time in local seconds since 1970; also what SNTP answers with
+void simSetWallTime(uint32_t localEpoch);
+uint32_t simWallTime();
+void simFormatWallTime(char* out, size_t size);  // "YYYY-MM-DD HH:MM:SS.mmm"
+
+// Pins. Levels default HIGH (pull-ups); interrupts fire on matching edges.
+void simSetPinLevel(uint8_t pin, int level);
+void simScheduleButtonPress(uint8_t pin, uint64_t atMicros, uint32_t durationMs);
+
+// Serial console input; the text becomes readable from Serial at the given time
+void simScheduleSerialInput(uint64_t atMicros, const char* text);
+
+// DS3231
+void simSetSqwPin(uint8_t pin);
+void simSetRtcTime(uint32_t localEpoch);
+void simSetRtcLostPower(bool lost);
+uint32_t simRtcTime();
+bool simRtcLostPower();
+void simSetRtcSqw(bool enabled);
+// Crystal error in ppm (positive runs fast), trimmed by the aging register at -0.1 ppm per LSB
+void simSetRtcDrift(double ppm);
+void simSetRtcAging(int8_t aging);
+int8_t simRtcAging();
+int64_t simRtcErrorMicros();  // RTC minus true wall time
+
+// Network. SNTP answers 150 ms after configTime() while Wi-Fi and NTP are available.
+void simSetWifiAvailable(bool available);
+bool simWifiAvailable();
+void simSetNtpAvailable(bool available);
+void simAddHttpRoute(const char* urlPrefix, int status, const String& body);
+int simHttpGet(const String& url, String& body);  // -1 when nothing answers
+
+// Radio accounting, to compare how long fetch strategies keep the radio busy. Nothing
+// takes simulated time on the network, so each Wi-Fi join, connection, TLS handshake and
+// request is counted and charged the air time it takes on the board instead (SIM_*_MS
+// in WiFi.cpp), plus response bodies at SIM_LINK_BYTES_PER_S.
+struct SimRadioStats {
+    uint32_t joins;
+    uint32_t connections;
+    uint32_t handshakes;   // Full TLS handshakes
+    uint32_t resumed;      // Handshakes that resumed a session
+    uint32_t requests;
+    uint32_t bytes;        // Response bodies
+    uint64_t airMicros;
+};
+const SimRadioStats& simRadioStats();
+void simResetRadioStats();
+void simNoteTlsHandshake(bool resumed);  // From the TLS stand-ins
+
+// Loopback clients hammering the firmware's status server on port, for as
+// long as the simulation runs; stopping prints throughput and latency
+void simStartHttpLoad(uint16_t port, int clients);
+void simStopHttpLoad();
+
+// Buzzer
+struct SimToneEvent {
+    uint64_t micros;
+    uint8_t channel;
+    double frequency;  // 0 = silent
+};
+const std::vector<SimToneEvent>& simToneLog();
+void simSetToneLogging(bool print);
+
+// I2C bus; devices see every write transaction addressed to them
+class SimI2cDevice {
+public:
+    virtual ~SimI2cDevice() {}
+    virtual void onI2cWrite(const uint8_t* data, size_t length) = 0;
+    virtual size_t onI2cRead(uint8_t* data, size_t length) { return 0; }
+};
+void simAttachI2cDevice(uint8_t address, SimI2cDevice* device);
+SimI2cDevice* simI2cDevice(uint8_t address);
+
+// Light sleep, used by esp_light_sleep_start(): no interrupts run, wakes early on GPIO
+bool simLightSleep(uint64_t maxMicros);  // Returns true if a GPIO woke it
+void simSetGpioWakeup(uint8_t pin, bool enabled, int level);
+
+#endif
@@ -0,0 +1,178 @@
+// sim_http_load.cpp
+// Loopback load generator for the firmware's status server. Each client
+// thread opens a connection, asks for one page, reads to the end and checks
+// the answer, then goes again at once. Latencies are counted in fixed
+// buckets so the clients never touch the (counted) heap while running.
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <thread>
+#include <vector>
+#include <lwip/sockets.h>
+#include "sim_hal.h"
+
+#define LOAD_BUCKET_US 10
+#define LOAD_BUCKETS 10000  // Up to 100 ms; slower answers land in the last bucket
+#define LOAD_RESPONSE_SIZE 4096
+#define LOAD_TIMEOUT_S 5
+
+static const char* const loadPaths[] = {"/status", "/schedule"};
+
+struct LoadClient {
+    uint64_t requests;
+    uint64_t errors;
+    uint64_t bytes;
+    uint64_t maxMicros;
+    uint32_t buckets[LOAD_BUCKETS];
+};
+
+static std::vector<LoadClient> loadClients;
+static std::vector<std::thread> loadThreads;
+static std::atomic<bool> loadRunning(false);
+static std::chrono::steady_clock::time_point loadFirstAnswer;
+static std::atomic<bool> loadAnswered(false);
+static uint16_t loadPort = 0;
+
+// A complete 200 answer with a Content-Length that matches and a body that parses
+static bool validAnswer(const char* response, size_t length) {
+    if (length < 12 || strncmp(response, "HTTP/1.1 200", 12) != 0) {
+        return false;
+    }
+    const char* body = strstr(response, "\r\n\r\n");
+    const char* contentLength = strstr(response, "Content-Length: ");
+    if (body == nullptr || contentLength == nullptr || contentLength > body) {
+        return false;
+    }
+    body += 4;
+    size_t bodyLength = length - (body - response);
+    if ((size_t)atol(contentLength + 16) != bodyLength) {
+        return false;
+    }
+    StaticJsonDocument<4096> document;
+    return !deserializeJson(document, body, bodyLength);
+}
+
+// Returns -1 when the server is not listening, 0 on a bad answer, 1 on success
+static int requestOnce(const char* path, char* response, size_t& length) {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        return 0;
+    }
+    struct timeval timeout = {LOAD_TIMEOUT_S, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(loadPort);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return errno == ECONNREFUSED ? -1 : 0;
+    }
+
+    char request[96];
+    int requestLength = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: azanclock\r\n\r\n", path);
+    if (send(fd, request, requestLength, MSG_NOSIGNAL) != requestLength) {
+        close(fd);
+        return 0;
+    }
+    length = 0;
+    ssize_t received;
+    while (length < LOAD_RESPONSE_SIZE - 1 &&
+           (received = recv(fd, response + length, LOAD_RESPONSE_SIZE - 1 - length, 0)) > 0) {
+        length += received;
+    }
+    close(fd);
+    response[length] = '\0';
+    return validAnswer(response, length) ? 1 : 0;
+}
+
+static void runLoadClient(LoadClient* client, int index) {
+    static thread_local char response[LOAD_RESPONSE_SIZE];
+    int next = index;
+    while (loadRunning) {
+        const char* path = loadPaths[next++ % 2];
+        auto start = std::chrono::steady_clock::now();
+        size_t length = 0;
+        int result = requestOnce(path, response, length);
+        if (result < 0) {
+            // Not listening yet: the firmware opens the port once Wi-Fi is up
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (!loadAnswered.exchange(true)) {
+            loadFirstAnswer = start;
+        }
+        if (result == 0) {
+            client->errors++;
+            continue;
+        }
+        uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        client->requests++;
+        client->bytes += length;
+        client->buckets[elapsed / LOAD_BUCKET_US < LOAD_BUCKETS ? elapsed / LOAD_BUCKET_US : LOAD_BUCKETS - 1]++;
+        if (elapsed > client->maxMicros) {
+            client->maxMicros = elapsed;
+        }
+    }
+}
+
+void simStartHttpLoad(uint16_t port, int clients) {
+    loadPort = port;
+    loadRunning = true;
+    loadClients.assign(clients, LoadClient());
+    for (int i = 0; i < clients; i++) {
+        memset(&loadClients[i], 0, sizeof(LoadClient));
+    }
+    for (int i = 0; i < clients; i++) {
+        loadThreads.push_back(std::thread(runLoadClient, &loadClients[i], i));
+    }
+}
+
+static uint64_t percentileMicros(const std::vector<uint64_t>& buckets, uint64_t total, double fraction) {
+    uint64_t target = (uint64_t)(total * fraction);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets.size(); b++) {
+        seen += buckets[b];
+        if (seen > target) {
+            return (b + 1) * LOAD_BUCKET_US;
+        }
+    }
+    return buckets.size() * LOAD_BUCKET_US;
+}
+
+void simStopHttpLoad() {
+    if (!loadRunning) {
+        return;
+    }
+    loadRunning = false;
+    for (std::thread& thread : loadThreads) {
+        thread.join();
+    }
+    auto stopped = std::chrono::steady_clock::now();
+
+    uint64_t requests = 0, errors = 0, bytes = 0, maxMicros = 0;
+    std::vector<uint64_t> buckets(LOAD_BUCKETS, 0);
+    for (const LoadClient& client : loadClients) {
+        requests += client.requests;
+        errors += client.errors;
+        bytes += client.bytes;
+        maxMicros = client.maxMicros > maxMicros ? client.maxMicros : maxMicros;
+        for (int b = 0; b < LOAD_BUCKETS; b++) {
+            buckets[b] += client.buckets[b];
+        }
+    }
+    double seconds =
+        loadAnswered ? std::chrono::duration_cast<std::chrono::microseconds>(stopped - loadFirstAnswer).count() / 1e6 : 0;
+    printf("[sim] http load: %u clients, %llu answers (%llu bytes) and %llu errors in %.2f s real, %.0f requests/s\n",
+           (unsigned)loadClients.size(), (unsigned long long)requests, (unsigned long long)bytes,
+           (unsigned long long)errors, seconds, seconds > 0 ? requests / seconds : 0.0);
+    printf("[sim] http latency: p50 %llu us, p99 %llu us, max %llu us\n",
+           (unsigned long long)percentileMicros(buckets, requests, 0.5),
+           (unsigned long long)percentileMicros(buckets, requests, 0.99), (unsigned long long)maxMicros);
+}
@@ -0,0 +1,238 @@
+// sim_main.cpp
+// Runs the unmodified firmware setup()/loop() against the simulated
+// hardware. Example:
+//   .pio/build/native/program --start "2024-03-10 04:30:00" --hours 24 --press 30 --frames frames/
+// Left out of test builds, which have their own main().
+#ifndef PIO_UNIT_TESTING
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <Wire.h>
+#include <driver/i2s.h>
+#include <esp_partition.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include "sim_hal.h"
+
+void setup();
+void loop();
+
+struct SimOptions {
+    uint32_t start = 1710045000UL;  // 2024-03-10 04:30:00
+    double hours = 24;
+    uint32_t stepMs = 10;
+    const char* framesDir = nullptr;
+    const char* nvsPath = nullptr;
+    uint32_t frameEverySeconds = 0;
+    int32_t rtcOffset = 0;
+    double rtcDriftPpm = 0;
+    bool rtcLostPower = false;
+    uint8_t buttonPin = 0;  // BUTTON_PIN in main.cpp
+    uint8_t sqwPin = 4;     // RTC_SQW_PIN in main.cpp
+    int httpClients = 0;
+    uint16_t httpPort = 8080;  // STATUS_SERVER_PORT of the native build
+};
+
+static void usage() {
+    printf("Options:\n"
+           "  --start \"YYYY-MM-DD HH:MM:SS\"  local wall time at boot\n"
+           "  --hours H                     simulated run length (default 24)\n"
+           "  --step-ms N                   simulated time per loop() pass (default 10)\n"
+           "  --frames DIR                  write a PBM whenever the panel image changes\n"
+           "  --frame-every S               at most one frame per S simulated seconds\n"
+           "  --press S[:MS]                press the button S seconds after boot for MS ms (default 100)\n"
+           "  --serial S:TEXT               type TEXT on the serial console S seconds after boot\n"
+           "  --rtc-offset S                start the DS3231 S seconds off the wall clock\n"
+           "  --rtc-drift PPM               DS3231 crystal error, positive runs fast (default 0)\n"
+           "  --rtc-lost-power              report an RTC power loss at boot\n"
+           "  --no-sqw                      leave the DS3231 SQW pin unwired\n"
+           "  --no-wifi | --no-ntp          take the network or SNTP away\n"
+           "  --nvs FILE                    load NVS from FILE at boot and save it back at the end\n"
+           "  --route PREFIX=FILE           serve FILE for GET requests to PREFIX\n"
+           "  --partition LABEL=FILE        flash FILE as the data partition LABEL, e.g. schedule\n"
+           "  --data DIR                    serve DIR as the LittleFS partition (Azan and reminder clips)\n"
+           "  --audio-out FILE              save what the I2S output plays as a WAV file\n"
+           "  --http-load N[:PORT]          N loopback clients polling the status server (default port 8080)\n"
+           "  --quiet-buzzer                do not print buzzer changes\n");
+}
+
+static bool parseDateTime(const char* text, uint32_t& epoch) {
+    struct tm parts = {};
+    if (sscanf(text, "%d-%d-%d %d:%d:%d", &parts.tm_year, &parts.tm_mon, &parts.tm_mday, &parts.tm_hour,
+               &parts.tm_min, &parts.tm_sec) < 3) {
+        return false;
+    }
+    parts.tm_year -= 1900;
+    parts.tm_mon -= 1;
+    epoch = (uint32_t)timegm(&parts);
+    return true;
+}
+
+static String readFile(const char* path) {
+    String content;
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return content;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.concat(buffer, n);
+    }
+    fclose(file);
+    return content;
+}
+
+static void addDefaultRoutes() {
+    simAddHttpRoute("api.ipify.org", 200, "203.0.113.7");
+    simAddHttpRoute("ip-api.com/json/", 200, "{\"lat\":25.2048,\"lon\":55.2708,\"city\":\"Dubai\"}");
+}
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    std::vector<std::pair<double, uint32_t>> presses;
+    bool sqwWired = true;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--start" && value && parseDateTime(value, options.start)) {
+            i++;
+        } else if (arg == "--hours" && value) {
+            options.hours = atof(argv[++i]);
+        } else if (arg == "--step-ms" && value) {
+            options.stepMs = atoi(argv[++i]);
+        } else if (arg == "--frames" && value) {
+            options.framesDir = argv[++i];
+        } else if (arg == "--frame-every" && value) {
+            options.frameEverySeconds = atoi(argv[++i]);
+        } else if (arg == "--press" && value) {
+            double at = atof(argv[++i]);
+            const char* duration = strchr(argv[i], ':');
+            presses.push_back(std::make_pair(at, duration != nullptr ? (uint32_t)atoi(duration + 1) : 100));
+        } else if (arg == "--serial" && value && strchr(value, ':') != nullptr) {
+            double at = atof(argv[++i]);
+            simScheduleSerialInput((uint64_t)(at * 1000000.0), strchr(argv[i], ':') + 1);
+        } else if (arg == "--rtc-offset" && value) {
+            options.rtcOffset = atoi(argv[++i]);
+        } else if (arg == "--rtc-drift" && value) {
+            options.rtcDriftPpm = atof(argv[++i]);
+        } else if (arg == "--rtc-lost-power") {
+            options.rtcLostPower = true;
+        } else if (arg == "--no-sqw") {
+            sqwWired = false;
+        } else if (arg == "--no-wifi") {
+            simSetWifiAvailable(false);
+        } else if (arg == "--no-ntp") {
+            simSetNtpAvailable(false);
+        } else if (arg == "--nvs" && value) {
+            options.nvsPath = argv[++i];
+        } else if (arg == "--route" && value && strchr(value, '=') != nullptr) {
+            std::string route = argv[++i];
+            size_t split = route.find('=');
+            simAddHttpRoute(route.substr(0, split).c_str(), 200, readFile(route.substr(split + 1).c_str()));
+        } else if (arg == "--partition" && value && strchr(value, '=') != nullptr) {
+            std::string partition = argv[++i];
+            size_t split = partition.find('=');
+            if (!simLoadPartition(partition.substr(0, split).c_str(), partition.substr(split + 1).c_str())) {
+                fprintf(stderr, "Cannot read partition file %s\n", partition.substr(split + 1).c_str());
+                return 2;
+            }
+        } else if (arg == "--data" && value) {
+            simSetLittleFsRoot(argv[++i]);
+        } else if (arg == "--audio-out" && value) {
+            if (!simSetAudioOutput(argv[++i])) {
+                fprintf(stderr, "Cannot write %s\n", argv[i]);
+                return 2;
+            }
+        } else if (arg == "--http-load" && value) {
+            options.httpClients = atoi(argv[++i]);
+            const char* port = strchr(argv[i], ':');
+            if (port != nullptr) {
+                options.httpPort = (uint16_t)atoi(port + 1);
+            }
+        } else if (arg == "--quiet-buzzer") {
+            simSetToneLogging(false);
+        } else {
+            usage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    if (options.nvsPath != nullptr && !simLoadNvs(options.nvsPath)) {
+        fprintf(stderr, "Cannot read NVS file %s\n", options.nvsPath);
+        return 2;
+    }
+    addDefaultRoutes();
+    signal(SIGPIPE, SIG_IGN);  // As on lwIP, a peer that hung up shows as a send() error
+    simBindMainThread();
+    simSetWallTime(options.start);
+    simSetRtcTime(options.start + options.rtcOffset);
+    simSetRtcLostPower(options.rtcLostPower);
+    simSetRtcDrift(options.rtcDriftPpm);
+    simSetSqwPin(sqwWired ? options.sqwPin : 0xFF);
+    for (const auto& press : presses) {
+        simScheduleButtonPress(options.buttonPin, (uint64_t)(press.first * 1000000.0), press.second);
+    }
+
+    setup();
+    if (options.httpClients > 0) {
+        simStartHttpLoad(options.httpPort, options.httpClients);
+    }
+
+    uint64_t end = (uint64_t)(options.hours * 3600.0 * 1000000.0);
+    uint64_t loops = 0;
+    uint32_t lastFrameHash = 0;
+    uint32_t lastFrameTime = 0;
+    uint32_t frames = 0;
+    while (simMicros() < end) {
+        loop();
+        loops++;
+        simAdvance((uint64_t)options.stepMs * 1000);
+
+        if (options.framesDir != nullptr) {
+            const SimSsd1306Panel& panel = simSsd1306Panel();
+            uint32_t hash = panel.frameHash();
+            uint32_t now = simWallTime();
+            if (hash != lastFrameHash && (frames == 0 || now - lastFrameTime >= options.frameEverySeconds)) {
+                char when[32];
+                simFormatWallTime(when, sizeof(when));
+                char path[512];
+                snprintf(path, sizeof(path), "%s/frame_%.4s%.2s%.2s_%.2s%.2s%.2s_%.3s.pbm", options.framesDir, when,
+                         when + 5, when + 8, when + 11, when + 14, when + 17, when + 20);
+                panel.writePbm(path);
+                lastFrameHash = hash;
+                lastFrameTime = now;
+                frames++;
+            }
+        }
+    }
+
+    simStopHttpLoad();
+    uint32_t tones = 0;
+    for (const SimToneEvent& event : simToneLog()) {
+        if (event.frequency > 0) {
+            tones++;
+        }
+    }
+    char when[32];
+    simFormatWallTime(when, sizeof(when));
+    printf("\n[sim] stopped at %s after %llu loop passes\n", when, (unsigned long long)loops);
+    printf("[sim] buzzer: %u tones, I2C: %u transactions / %llu bytes / %.1f ms busy, panel data: %llu bytes\n",
+           tones, Wire.transactions(), (unsigned long long)Wire.bytesWritten(), Wire.busMicros() / 1000.0,
+           (unsigned long long)simSsd1306Panel().dataBytes());
+    printf("[sim] RTC error: %.3f ms, aging offset: %d\n", simRtcErrorMicros() / 1000.0, simRtcAging());
+    uint32_t freeHeap = ESP.getFreeHeap();
+    printf("[sim] heap: %u bytes free, %u at the low point, largest block %u\n", freeHeap, ESP.getMinFreeHeap(),
+           ESP.getMaxAllocHeap());
+    simFinishAudio();
+    printf("[sim] NVS bytes written: %llu, frames written: %u\n", (unsigned long long)simNvsBytesWritten(), frames);
+    if (options.nvsPath != nullptr && !simSaveNvs(options.nvsPath)) {
+        printf("[sim] could not save NVS to %s\n", options.nvsPath);
+    }
+    fflush(stdout);
+    _Exit(0);  // The network task is still blocked on its queue
+}
+#endif
@@ -0,0 +1,138 @@
+// alert_player.cpp
+// Non-blocking alert engine. The buzzer is driven through the LEDC channel
+// set up in setup(), and each beep is a timed phase of a small state machine
+// advanced from loop(), so the loop keeps running during an alert. Clips
+// play on the audio task; the state machine only watches for their end.
+#include <Arduino.h>
+#include "alert_player.h"
+#include "audio_player.h"
+
+static constexpr AlertPattern alertPatterns[] = {
+    {"rem", 1000, 1000, 200, 5, "/reminder.wav"},  // Reminder: five long beeps
+    {"time", 1000, 400, 200, 15, "/azan.wav"},     // Prayer time: fifteen short beeps
+};
+
+struct PendingAlert {
+    const AlertPattern* pattern;
+    char title[ALERT_TEXT_SIZE];
+    char subtitle[ALERT_TEXT_SIZE];
+};
+
+static uint8_t alertChannel = 0;
+static AlertRenderCallback alertRender = nullptr;
+
+static PendingAlert alertQueue[ALERT_QUEUE_SIZE];
+static uint8_t queueHead = 0;
+static uint8_t queueCount = 0;
+
+static bool playing = false;
+static bool clipPlaying = false;
+static bool phaseOn = false;
+static uint8_t beepsLeft = 0;
+static unsigned long phaseStart = 0;
+
+void beginAlertPlayer(uint8_t channel, AlertRenderCallback render) {
+    alertChannel = channel;
+    alertRender = render;
+}
+
+const AlertPattern* findAlertPattern(const char* name) {
+    for (const AlertPattern& pattern : alertPatterns) {
+        if (strcmp(pattern.name, name) == 0) {
+            return &pattern;
+        }
+    }
+    return &alertPatterns[0];
+}
+
+static void setPhase(bool on, unsigned long nowMillis) {
+    const PendingAlert& alert = alertQueue[queueHead];
+    phaseOn = on;
+    phaseStart = nowMillis;
+    ledcWriteTone(alertChannel, on && !clipPlaying ? alert.pattern->frequency : 0);
+    if (alertRender != nullptr) {
+        alertRender(alert.title, alert.subtitle, on);
+    }
+}
+
+static void startNext(unsigned long nowMillis) {
+    if (queueCount == 0) {
+        playing = false;
+        return;
+    }
+    playing = true;
+    const AlertPattern* pattern = alertQueue[queueHead].pattern;
+    beepsLeft = pattern->repeats;
+    clipPlaying = pattern->clip != nullptr && playAudioClip(pattern->clip);
+    setPhase(true, nowMillis);
+}
+
+bool startAlert(const AlertPattern* pattern, const char* title, const char* subtitle) {
+    if (pattern == nullptr || queueCount >= ALERT_QUEUE_SIZE) {
+        return false;
+    }
+
+    PendingAlert& alert = alertQueue[(queueHead + queueCount) % ALERT_QUEUE_SIZE];
+    alert.pattern = pattern;
+    strncpy(alert.title, title, sizeof(alert.title) - 1);
+    alert.title[sizeof(alert.title) - 1] = '\0';
+    strncpy(alert.subtitle, subtitle, sizeof(alert.subtitle) - 1);
+    alert.subtitle[sizeof(alert.subtitle) - 1] = '\0';
+    queueCount++;
+
+    if (!playing) {
+        startNext(millis());
+    }
+    return true;
+}
+
+void updateAlertPlayer(unsigned long nowMillis) {
+    if (!playing) {
+        return;
+    }
+
+    if (clipPlaying) {
+        AudioState state = audioState();
+        if (state == AUDIO_FAILED) {
+            clipPlaying = false;  // Fall back to the beeps from the start
+            setPhase(true, nowMillis);
+            return;
+        }
+        if (state == AUDIO_IDLE) {
+            clipPlaying = false;
+            queueHead = (queueHead + 1) % ALERT_QUEUE_SIZE;
+            queueCount--;
+            startNext(nowMillis);
+            return;
+        }
+    }
+
+    const AlertPattern* pattern = alertQueue[queueHead].pattern;
+    unsigned long elapsed = nowMillis - phaseStart;
+    if (phaseOn && elapsed >= pattern->onMs) {
+        setPhase(false, nowMillis);
+    } else if (!phaseOn && elapsed >= pattern->offMs) {
+        if (clipPlaying || --beepsLeft > 0) {
+            setPhase(true, nowMillis);
+        } else {
+            queueHead = (queueHead + 1) % ALERT_QUEUE_SIZE;
+            queueCount--;
+            startNext(nowMillis);
+        }
+    }
+}
+
+void cancelAlert() {
+    if (clipPlaying) {
+        stopAudio();
+        clipPlaying = false;
+    }
+    ledcWriteTone(alertChannel, 0);
+    queueCount = 0;
+    playing = false;
+    phaseOn = false;
+}
+
+bool alertActive() {
+    return playing;
+}
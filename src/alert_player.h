@@ -0,0 +1,40 @@
+// alert_player.h
+#ifndef ALERT_PLAYER_H
+#define ALERT_PLAYER_H
+
+#include <stdint.h>
+
+#define ALERT_TEXT_SIZE 24
+#define ALERT_QUEUE_SIZE 4
+
+// Beep/flash pattern: repeats x (onMs with tone, offMs silent). When the
+// clip plays, the screen flashes at the same cadence until it ends instead;
+// without an audio player or the file, the beeps play.
+struct AlertPattern {
+    const char* name;
+    uint16_t frequency;
+    uint16_t onMs;
+    uint16_t offMs;
+    uint8_t repeats;
+    const char* clip;  // WAV file in LittleFS
+};
+
+// Called on every phase change so the caller can flash the screen
+typedef void (*AlertRenderCallback)(const char* title, const char* subtitle, bool on);
+
+void beginAlertPlayer(uint8_t channel, AlertRenderCallback render);
+
+const AlertPattern* findAlertPattern(const char* name);
+
+// Start (or queue behind the current one) an alert; never blocks
+bool startAlert(const AlertPattern* pattern, const char* title, const char* subtitle);
+
+// Advance the state machine; call every loop iteration
+void updateAlertPlayer(unsigned long nowMillis);
+
+// Stop the current alert and drop any queued ones
+void cancelAlert();
+
+bool alertActive();
+
+#endif
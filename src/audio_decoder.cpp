@@ -0,0 +1,237 @@
+// audio_decoder.cpp
+#include <string.h>
+#include "audio_decoder.h"
+
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_IMA_ADPCM 0x0011
+#define ADPCM_BLOCK_HEADER 4   // First sample, step index, reserved byte
+#define ADPCM_MAX_STEP_INDEX 88
+
+static const int16_t imaSteps[ADPCM_MAX_STEP_INDEX + 1] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+static const int8_t imaIndexAdjust[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+static uint16_t readLe16(const uint8_t* bytes) {
+    return bytes[0] | bytes[1] << 8;
+}
+
+static uint32_t readLe32(const uint8_t* bytes) {
+    return readLe16(bytes) | (uint32_t)readLe16(bytes + 2) << 16;
+}
+
+// Header reads go straight to the callback; only sample data is buffered
+static bool readExactly(AudioDecoder& decoder, uint8_t* buffer, size_t size) {
+    while (size > 0) {
+        size_t count = decoder.read(decoder.context, buffer, size);
+        if (count == 0) {
+            return false;
+        }
+        buffer += count;
+        size -= count;
+    }
+    return true;
+}
+
+static bool skipBytes(AudioDecoder& decoder, uint32_t size) {
+    while (size > 0) {
+        size_t count = size < sizeof(decoder.input) ? size : sizeof(decoder.input);
+        if (!readExactly(decoder, decoder.input, count)) {
+            return false;
+        }
+        size -= count;
+    }
+    return true;
+}
+
+static bool fillInput(AudioDecoder& decoder) {
+    if (decoder.dataLeft == 0) {
+        return false;
+    }
+    size_t wanted = decoder.dataLeft < sizeof(decoder.input) ? decoder.dataLeft : sizeof(decoder.input);
+    size_t count = decoder.read(decoder.context, decoder.input, wanted);
+    if (count == 0) {
+        decoder.dataLeft = 0;  // File shorter than its header says
+        return false;
+    }
+    decoder.dataLeft -= count;
+    decoder.inputLength = count;
+    decoder.inputPosition = 0;
+    return true;
+}
+
+static inline bool nextByte(AudioDecoder& decoder, uint8_t& byte) {
+    if (decoder.inputPosition >= decoder.inputLength && !fillInput(decoder)) {
+        return false;
+    }
+    byte = decoder.input[decoder.inputPosition++];
+    return true;
+}
+
+static bool nextAdpcmSample(AudioDecoder& decoder, int16_t& sample) {
+    if (decoder.blockLeft == 0) {
+        uint8_t header[ADPCM_BLOCK_HEADER];
+        for (int i = 0; i < ADPCM_BLOCK_HEADER; i++) {
+            if (!nextByte(decoder, header[i])) {
+                return false;
+            }
+        }
+        decoder.predictor = (int16_t)readLe16(header);
+        decoder.stepIndex = header[2] > ADPCM_MAX_STEP_INDEX ? ADPCM_MAX_STEP_INDEX : header[2];
+        decoder.blockLeft = decoder.blockAlign - ADPCM_BLOCK_HEADER;
+        decoder.highNibble = false;
+        sample = (int16_t)decoder.predictor;
+        return true;
+    }
+
+    // Low nibble first
+    uint8_t nibble;
+    if (!decoder.highNibble) {
+        if (!nextByte(decoder, decoder.nibbles)) {
+            return false;
+        }
+        nibble = decoder.nibbles & 0x0F;
+        decoder.highNibble = true;
+    } else {
+        nibble = decoder.nibbles >> 4;
+        decoder.highNibble = false;
+        decoder.blockLeft--;
+    }
+
+    int32_t step = imaSteps[decoder.stepIndex];
+    int32_t difference = step >> 3;
+    if (nibble & 4) {
+        difference += step;
+    }
+    if (nibble & 2) {
+        difference += step >> 1;
+    }
+    if (nibble & 1) {
+        difference += step >> 2;
+    }
+    decoder.predictor += (nibble & 8) ? -difference : difference;
+    if (decoder.predictor > INT16_MAX) {
+        decoder.predictor = INT16_MAX;
+    } else if (decoder.predictor < INT16_MIN) {
+        decoder.predictor = INT16_MIN;
+    }
+    int index = decoder.stepIndex + imaIndexAdjust[nibble & 7];
+    decoder.stepIndex = index < 0 ? 0 : index > ADPCM_MAX_STEP_INDEX ? ADPCM_MAX_STEP_INDEX : index;
+    sample = (int16_t)decoder.predictor;
+    return true;
+}
+
+// Next input sample, channels mixed down to mono
+static bool nextSample(AudioDecoder& decoder, int16_t& sample) {
+    if (decoder.encoding == AUDIO_IMA_ADPCM) {
+        return nextAdpcmSample(decoder, sample);
+    }
+
+    int32_t sum = 0;
+    for (int channel = 0; channel < decoder.channels; channel++) {
+        uint8_t low, high;
+        if (!nextByte(decoder, low)) {
+            return false;
+        }
+        if (decoder.encoding == AUDIO_PCM8) {
+            sum += ((int32_t)low - 128) << 8;  // 8-bit WAV is unsigned
+        } else if (nextByte(decoder, high)) {
+            sum += (int16_t)(low | high << 8);
+        } else {
+            return false;
+        }
+    }
+    sample = (int16_t)(sum / decoder.channels);
+    return true;
+}
+
+bool beginAudioDecoder(AudioDecoder& decoder, AudioReadCallback read, void* context, uint32_t outputRate) {
+    memset(&decoder, 0, sizeof(decoder));
+    decoder.read = read;
+    decoder.context = context;
+
+    uint8_t riff[12];
+    if (!readExactly(decoder, riff, sizeof(riff)) || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    // Walk the chunks up to "data", keeping "fmt " and skipping the rest (LIST, fact, ...)
+    uint16_t format = 0;
+    uint16_t bits = 0;
+    bool haveFormat = false;
+    while (true) {
+        uint8_t chunk[8];
+        if (!readExactly(decoder, chunk, sizeof(chunk))) {
+            return false;
+        }
+        uint32_t size = readLe32(chunk + 4);
+        if (memcmp(chunk, "data", 4) == 0) {
+            decoder.dataLeft = size;
+            break;
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fields[16];
+            if (!readExactly(decoder, fields, sizeof(fields))) {
+                return false;
+            }
+            format = readLe16(fields);
+            decoder.channels = readLe16(fields + 2);
+            decoder.sampleRate = readLe32(fields + 4);
+            decoder.blockAlign = readLe16(fields + 12);
+            bits = readLe16(fields + 14);
+            haveFormat = true;
+            size -= sizeof(fields);
+        }
+        if (!skipBytes(decoder, size + (size & 1))) {  // Chunks are padded to an even length
+            return false;
+        }
+    }
+
+    if (!haveFormat || decoder.channels < 1 || decoder.channels > 2 || decoder.sampleRate == 0 || outputRate == 0) {
+        return false;
+    }
+    if (format == WAVE_FORMAT_PCM && bits == 8 && decoder.blockAlign == decoder.channels) {
+        decoder.encoding = AUDIO_PCM8;
+    } else if (format == WAVE_FORMAT_PCM && bits == 16 && decoder.blockAlign == 2 * decoder.channels) {
+        decoder.encoding = AUDIO_PCM16;
+    } else if (format == WAVE_FORMAT_IMA_ADPCM && bits == 4 && decoder.channels == 1 &&
+               decoder.blockAlign > ADPCM_BLOCK_HEADER) {
+        decoder.encoding = AUDIO_IMA_ADPCM;
+    } else {
+        return false;
+    }
+
+    decoder.step = (uint32_t)(((uint64_t)decoder.sampleRate << 16) / outputRate);
+    if (decoder.step == 0) {
+        return false;
+    }
+
+    // Prime the interpolator with the first two samples
+    if (!nextSample(decoder, decoder.previous) || !nextSample(decoder, decoder.current)) {
+        decoder.finished = true;
+    }
+    return true;
+}
+
+size_t decodeAudio(AudioDecoder& decoder, int16_t* out, size_t frames) {
+    size_t count = 0;
+    while (count < frames && !decoder.finished) {
+        while (decoder.phase >= 0x10000) {
+            decoder.previous = decoder.current;
+            if (!nextSample(decoder, decoder.current)) {
+                decoder.finished = true;
+                return count;
+            }
+            decoder.phase -= 0x10000;
+        }
+        // 15-bit fraction, so the product stays within 32 bits
+        int32_t difference = (int32_t)decoder.current - decoder.previous;
+        out[count++] = (int16_t)(decoder.previous + ((difference * (int32_t)(decoder.phase >> 1)) >> 15));
+        decoder.phase += decoder.step;
+    }
+    return count;
+}
@@ -0,0 +1,59 @@
+// audio_decoder.h
+#ifndef AUDIO_DECODER_H
+#define AUDIO_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming WAV decoder: pulls the file through a small buffer, mixes it to
+// mono and resamples it to the output rate by linear interpolation. Nothing
+// here depends on the board, so the native build runs the same code.
+// Supported: 8 and 16-bit PCM (mono or stereo) and mono IMA ADPCM, which
+// stores 4 bits per sample and is what a three-minute Azan needs to fit in flash.
+#define AUDIO_INPUT_CHUNK 512  // Bytes read from the file at a time
+
+enum AudioEncoding : uint8_t {
+    AUDIO_PCM8,
+    AUDIO_PCM16,
+    AUDIO_IMA_ADPCM
+};
+
+// Read up to size bytes; returns the count read, 0 at the end
+typedef size_t (*AudioReadCallback)(void* context, uint8_t* buffer, size_t size);
+
+struct AudioDecoder {
+    AudioReadCallback read;
+    void* context;
+    AudioEncoding encoding;
+    uint8_t channels;
+    uint32_t sampleRate;       // Of the file
+    uint16_t blockAlign;       // Bytes per frame, or per block for ADPCM
+    uint32_t dataLeft;         // Bytes of the data chunk not yet pulled into input
+
+    uint8_t input[AUDIO_INPUT_CHUNK];
+    uint16_t inputLength;
+    uint16_t inputPosition;
+
+    // IMA ADPCM block state
+    int32_t predictor;
+    int8_t stepIndex;
+    uint16_t blockLeft;        // Bytes left in the current block
+    uint8_t nibbles;           // Byte being split into two samples
+    bool highNibble;           // The next sample comes from the high nibble
+
+    // Resampler: the output position lies between previous and current
+    uint32_t step;             // Input samples per output sample, 16.16 fixed point
+    uint32_t phase;            // 16.16, below 1.0 after each output sample
+    int16_t previous;
+    int16_t current;
+    bool finished;
+};
+
+// Parse the RIFF header up to the start of the sample data. Returns false for
+// anything but a supported WAV file.
+bool beginAudioDecoder(AudioDecoder& decoder, AudioReadCallback read, void* context, uint32_t outputRate);
+
+// Decode up to frames mono samples at the output rate; returns fewer only at the end
+size_t decodeAudio(AudioDecoder& decoder, int16_t* out, size_t frames);
+
+#endif
@@ -0,0 +1,216 @@
+// audio_player.cpp
+// The loop only posts a clip path and bumps a generation number; the task
+// opens the file, decodes AUDIO_DMA_FRAMES samples at a time and writes them
+// to the I2S driver, which copies them into a free DMA buffer or blocks the
+// task until the playing one is done. A newer request or stopAudio() bumps
+// the generation again, which ends the current clip at the next buffer.
+//
+// An underrun is a buffer handed over after the DMA had played everything it
+// had. When a write blocked, a buffer has just been freed, so the driver
+// holds AUDIO_DMA_BUFFERS buffers from then on; the time it runs dry is
+// tracked from there.
+#include <LittleFS.h>
+#include <driver/i2s.h>
+#include <atomic>
+#include "audio_player.h"
+#include "audio_decoder.h"
+
+#define AUDIO_BUFFER_MICROS (AUDIO_DMA_FRAMES * 1000000UL / AUDIO_SAMPLE_RATE)
+
+static TaskHandle_t audioTask = nullptr;
+static portMUX_TYPE requestMux = portMUX_INITIALIZER_UNLOCKED;
+static char requestedPath[AUDIO_PATH_SIZE];
+static std::atomic<uint32_t> generation(0);
+static std::atomic<uint8_t> state(AUDIO_IDLE);
+static AudioStats stats = {0, 0, 0, 0, 0, 0};
+
+// Audio task only
+static AudioDecoder decoder;
+static File clipFile;
+static int16_t monoBuffer[AUDIO_DMA_FRAMES];
+static int16_t stereoBuffer[2 * AUDIO_DMA_FRAMES];
+
+AudioState audioState() {
+    return (AudioState)state.load();
+}
+
+const AudioStats& audioStats() {
+    return stats;
+}
+
+static size_t readClip(void* context, uint8_t* buffer, size_t size) {
+    int count = ((File*)context)->read(buffer, size);
+    return count > 0 ? count : 0;
+}
+
+// Function to hand monoBuffer to the driver as left and right; returns true if it had to wait.
+// The built-in DAC takes the high byte of each sample, unsigned.
+static bool writeBuffer(size_t frames) {
+    for (size_t i = 0; i < frames; i++) {
+#if AUDIO_INTERNAL_DAC
+        int16_t sample = (int16_t)((uint16_t)monoBuffer[i] ^ 0x8000);
+#else
+        int16_t sample = monoBuffer[i];
+#endif
+        stereoBuffer[2 * i] = sample;
+        stereoBuffer[2 * i + 1] = sample;
+    }
+    uint32_t start = micros();
+    size_t written = 0;
+    i2s_write(AUDIO_I2S_PORT, stereoBuffer, frames * 2 * sizeof(int16_t), &written, portMAX_DELAY);
+    return micros() - start >= AUDIO_BUFFER_MICROS / 4;
+}
+
+// Only the newest request may change the state
+static void finishClip(uint32_t clipGeneration, AudioState result) {
+    portENTER_CRITICAL(&requestMux);
+    if (generation == clipGeneration) {
+        state = result;
+    }
+    portEXIT_CRITICAL(&requestMux);
+}
+
+static void playClip(const char* path, uint32_t clipGeneration) {
+    clipFile = LittleFS.open(path, "r");
+    if (!clipFile || !beginAudioDecoder(decoder, readClip, &clipFile, AUDIO_SAMPLE_RATE)) {
+        Serial.printf("Cannot play %s.\n", path);
+        if (clipFile) {
+            clipFile.close();
+        }
+        stats.failures++;
+        finishClip(clipGeneration, AUDIO_FAILED);
+        return;
+    }
+    stats.clips++;
+    i2s_zero_dma_buffer(AUDIO_I2S_PORT);
+    i2s_start(AUDIO_I2S_PORT);
+
+    bool started = false;
+    uint32_t drainAt = 0;  // micros() when the DMA has played everything written so far
+    while (generation == clipGeneration) {
+        uint32_t cycles = ESP.getCycleCount();
+        size_t frames = decodeAudio(decoder, monoBuffer, AUDIO_DMA_FRAMES);
+        cycles = ESP.getCycleCount() - cycles;
+        stats.decodeCycles += cycles;
+        if (cycles > stats.maxBufferCycles) {
+            stats.maxBufferCycles = cycles;
+        }
+        if (frames == 0) {
+            break;
+        }
+
+        uint32_t now = micros();
+        if (started && (int32_t)(now - drainAt) > 0) {
+            stats.underruns++;
+        }
+        uint32_t duration = frames * 1000000ULL / AUDIO_SAMPLE_RATE;
+        drainAt = (started && (int32_t)(drainAt - now) > 0 ? drainAt : now) + duration;
+        if (writeBuffer(frames)) {
+            drainAt = micros() + (AUDIO_DMA_BUFFERS - 1) * AUDIO_BUFFER_MICROS + duration;
+        }
+        started = true;
+        stats.frames += frames;
+    }
+    clipFile.close();
+
+    if (generation == clipGeneration) {
+        // Silence into every buffer: the last write returns once the clip's final buffer has played
+        memset(monoBuffer, 0, sizeof(monoBuffer));
+        for (int i = 0; i < AUDIO_DMA_BUFFERS; i++) {
+            writeBuffer(AUDIO_DMA_FRAMES);
+        }
+    } else {
+        i2s_zero_dma_buffer(AUDIO_I2S_PORT);
+    }
+    i2s_stop(AUDIO_I2S_PORT);  // The DAC holds its last (mid-scale) level
+    finishClip(clipGeneration, AUDIO_IDLE);
+}
+
+static void audioTaskMain(void* parameter) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        char path[AUDIO_PATH_SIZE];
+        portENTER_CRITICAL(&requestMux);
+        uint32_t clipGeneration = generation;
+        bool requested = state == AUDIO_PLAYING;
+        memcpy(path, requestedPath, sizeof(path));
+        portEXIT_CRITICAL(&requestMux);
+        if (requested) {
+            playClip(path, clipGeneration);
+        }
+    }
+}
+
+bool beginAudioPlayer() {
+    if (!LittleFS.begin(false)) {
+        Serial.println("No LittleFS partition, alerts use the buzzer.");
+        return false;
+    }
+
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | (AUDIO_INTERNAL_DAC ? I2S_MODE_DAC_BUILT_IN : 0));
+    config.sample_rate = AUDIO_SAMPLE_RATE;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    config.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+    config.communication_format = AUDIO_INTERNAL_DAC ? I2S_COMM_FORMAT_STAND_MSB : I2S_COMM_FORMAT_STAND_I2S;
+    config.dma_buf_count = AUDIO_DMA_BUFFERS;
+    config.dma_buf_len = AUDIO_DMA_FRAMES;
+    config.tx_desc_auto_clear = true;  // Send silence, not the old buffer, if the task falls behind
+    if (i2s_driver_install(AUDIO_I2S_PORT, &config, 0, nullptr) != ESP_OK) {
+        Serial.println("I2S driver failed to install, alerts use the buzzer.");
+        return false;
+    }
+#if AUDIO_INTERNAL_DAC
+    i2s_set_pin(AUDIO_I2S_PORT, nullptr);
+    i2s_set_dac_mode(I2S_DAC_CHANNEL_RIGHT_EN);  // GPIO 25
+#else
+    i2s_pin_config_t pins = {};
+    pins.mck_io_num = I2S_PIN_NO_CHANGE;
+    pins.bck_io_num = AUDIO_I2S_BCK_PIN;
+    pins.ws_io_num = AUDIO_I2S_WS_PIN;
+    pins.data_out_num = AUDIO_I2S_DATA_PIN;
+    pins.data_in_num = I2S_PIN_NO_CHANGE;
+    i2s_set_pin(AUDIO_I2S_PORT, &pins);
+#endif
+    i2s_stop(AUDIO_I2S_PORT);  // Started per clip
+
+    if (xTaskCreatePinnedToCore(audioTaskMain, "audio", AUDIO_TASK_STACK, nullptr, AUDIO_TASK_PRIORITY, &audioTask,
+                                AUDIO_TASK_CORE) != pdPASS) {
+        audioTask = nullptr;
+        i2s_driver_uninstall(AUDIO_I2S_PORT);
+        Serial.println("Audio task failed to start, alerts use the buzzer.");
+        return false;
+    }
+    return true;
+}
+
+bool playAudioClip(const char* path) {
+    if (audioTask == nullptr || path == nullptr) {
+        return false;
+    }
+    portENTER_CRITICAL(&requestMux);
+    strncpy(requestedPath, path, sizeof(requestedPath) - 1);
+    requestedPath[sizeof(requestedPath) - 1] = '\0';
+    generation++;
+    state = AUDIO_PLAYING;
+    portEXIT_CRITICAL(&requestMux);
+    xTaskNotifyGive(audioTask);
+    return true;
+}
+
+void stopAudio() {
+    portENTER_CRITICAL(&requestMux);
+    generation++;
+    state = AUDIO_IDLE;
+    portEXIT_CRITICAL(&requestMux);
+}
+
+// Function to print clips played, underruns and what decoding costs per second of audio
+void printAudioReport(Print& out) {
+    double seconds = (double)stats.frames / AUDIO_SAMPLE_RATE;
+    double cyclesPerSecond = seconds > 0 ? stats.decodeCycles / seconds : 0;
+    out.printf("audio,clips,%u,failures,%u,underruns,%u,seconds,%.1f\n", (unsigned)stats.clips,
+               (unsigned)stats.failures, (unsigned)stats.underruns, seconds);
+    out.printf("decode,cycles_per_audio_s,%.0f,cpu_percent,%.2f,max_buffer_cycles,%u\n", cyclesPerSecond,
+               cyclesPerSecond / (ESP.getCpuFreqMHz() * 1e4), (unsigned)stats.maxBufferCycles);
+}
@@ -0,0 +1,59 @@
+// audio_player.h
+#ifndef AUDIO_PLAYER_H
+#define AUDIO_PLAYER_H
+
+#include <Arduino.h>
+
+// Plays WAV clips from LittleFS through I2S. A task decodes one DMA buffer at
+// a time and hands it to the driver, which blocks that task (never the loop)
+// while the other buffer plays. Clips go to the built-in DAC on GPIO 25 by
+// default; build with -DAUDIO_INTERNAL_DAC=0 for an external I2S amplifier
+// such as a MAX98357A on the pins below.
+#ifndef AUDIO_INTERNAL_DAC
+#define AUDIO_INTERNAL_DAC 1
+#endif
+#define AUDIO_I2S_PORT I2S_NUM_0
+#define AUDIO_I2S_BCK_PIN 26
+#define AUDIO_I2S_WS_PIN 27
+#define AUDIO_I2S_DATA_PIN 33
+#define AUDIO_SAMPLE_RATE 22050
+#define AUDIO_DMA_BUFFERS 2     // Double-buffered: one plays while the next is filled
+#define AUDIO_DMA_FRAMES 512    // Per buffer, about 23 ms
+#define AUDIO_PATH_SIZE 32
+
+// Above the network task on its core, so a TLS handshake cannot starve it
+#define AUDIO_TASK_STACK 4096
+#define AUDIO_TASK_PRIORITY 3
+#define AUDIO_TASK_CORE 0
+
+enum AudioState : uint8_t {
+    AUDIO_IDLE,     // Nothing requested, or the last clip has finished
+    AUDIO_PLAYING,  // Requested or playing
+    AUDIO_FAILED    // The last clip could not be opened or is not a supported WAV
+};
+
+struct AudioStats {
+    uint32_t clips;           // Clips started
+    uint32_t failures;
+    uint32_t underruns;       // Buffers handed over after the DMA had run dry
+    uint64_t frames;          // Samples played at AUDIO_SAMPLE_RATE
+    uint64_t decodeCycles;    // CPU cycles spent reading and decoding
+    uint32_t maxBufferCycles; // Worst single buffer
+};
+
+// Mount LittleFS, install the I2S driver and start the task. Returns false
+// (and alerts keep using the buzzer) if either is missing.
+bool beginAudioPlayer();
+
+// Start a clip, replacing whatever plays. Returns false if there is no player.
+bool playAudioClip(const char* path);
+
+// Stop the clip at the next buffer and silence the output
+void stopAudio();
+
+AudioState audioState();
+
+const AudioStats& audioStats();
+void printAudioReport(Print& out);
+
+#endif
@@ -0,0 +1,141 @@
+// button_gestures.cpp
+// The ISR only timestamps edges into a single-producer/single-consumer ring;
+// debouncing and gesture decoding run in loop() from nextButtonGesture().
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include "button_gestures.h"
+
+struct ButtonEdge {
+    unsigned long millis;
+    uint8_t level;
+};
+
+static ButtonEdge edgeBuffer[BUTTON_EDGE_BUFFER_SIZE];
+static volatile uint8_t edgeHead = 0;  // Written by the ISR
+static volatile uint8_t edgeTail = 0;  // Written by the decoder
+static volatile uint32_t droppedEdges = 0;
+
+static int buttonPin = -1;
+static ButtonGestureConfig gestureConfig;
+
+// Decoder state
+static bool pressed = false;
+static bool holdFired = false;
+static unsigned long lastEdgeMillis = 0;
+static unsigned long pressStartMillis = 0;
+static unsigned long lastReleaseMillis = 0;
+static uint8_t pressCount = 0;
+
+static ButtonGesture gestureQueue[BUTTON_GESTURE_QUEUE_SIZE];
+static uint8_t gestureHead = 0;
+static uint8_t gestureCount = 0;
+
+static void IRAM_ATTR onButtonEdge() {
+    uint8_t head = edgeHead;
+    uint8_t next = (head + 1) & (BUTTON_EDGE_BUFFER_SIZE - 1);
+    if (next == edgeTail) {
+        droppedEdges++;
+        return;
+    }
+    edgeBuffer[head].millis = millis();
+    edgeBuffer[head].level = digitalRead(buttonPin);
+    edgeHead = next;
+}
+
+static void emitGesture(ButtonGestureType type, uint8_t count, unsigned long when) {
+    if (gestureCount >= BUTTON_GESTURE_QUEUE_SIZE) {
+        return;
+    }
+    ButtonGesture& gesture = gestureQueue[(gestureHead + gestureCount) % BUTTON_GESTURE_QUEUE_SIZE];
+    gesture.type = type;
+    gesture.count = count;
+    gesture.millis = when;
+    gestureCount++;
+}
+
+// Apply one raw edge; anything within the debounce window of the last accepted edge is bounce
+static void processEdge(unsigned long when, bool down) {
+    if (down == pressed || when - lastEdgeMillis < gestureConfig.debounceMs) {
+        return;
+    }
+    lastEdgeMillis = when;
+    pressed = down;
+
+    if (down) {
+        pressStartMillis = when;
+        holdFired = false;
+        emitGesture(GESTURE_DOWN, pressCount + 1, when);
+        return;
+    }
+
+    if (holdFired) {
+        return;  // The hold was already reported
+    }
+    if (when - pressStartMillis >= gestureConfig.longPressMs) {
+        pressCount = 0;
+        emitGesture(GESTURE_LONG_PRESS, 1, when);
+    } else {
+        pressCount++;
+        lastReleaseMillis = when;
+    }
+}
+
+void beginButtonGestures(int pin, const ButtonGestureConfig& config) {
+    buttonPin = pin;
+    gestureConfig = config;
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(pin), onButtonEdge, CHANGE);
+}
+
+bool nextButtonGesture(unsigned long nowMillis, ButtonGesture& gesture) {
+    while (edgeTail != edgeHead) {
+        const ButtonEdge& edge = edgeBuffer[edgeTail];
+        processEdge(edge.millis, edge.level == LOW);
+        edgeTail = (edgeTail + 1) & (BUTTON_EDGE_BUFFER_SIZE - 1);
+    }
+
+    // A bounce can hide the final edge; resync to the pin once it has settled
+    if (buttonPin >= 0 && nowMillis - lastEdgeMillis >= gestureConfig.debounceMs) {
+        bool down = digitalRead(buttonPin) == LOW;
+        if (down != pressed) {
+            processEdge(nowMillis, down);
+        }
+    }
+
+    if (pressed && !holdFired && nowMillis - pressStartMillis >= gestureConfig.holdMs) {
+        holdFired = true;
+        pressCount = 0;
+        emitGesture(GESTURE_HOLD, 1, nowMillis);
+    } else if (!pressed && pressCount > 0 && nowMillis - lastReleaseMillis >= gestureConfig.multiPressTimeoutMs) {
+        emitGesture(GESTURE_PRESSES, pressCount, nowMillis);
+        pressCount = 0;
+    }
+
+    if (gestureCount == 0) {
+        return false;
+    }
+    gesture = gestureQueue[gestureHead];
+    gestureHead = (gestureHead + 1) % BUTTON_GESTURE_QUEUE_SIZE;
+    gestureCount--;
+    return true;
+}
+
+bool buttonGesturePending() {
+    return pressed || pressCount > 0 || gestureCount > 0 || edgeTail != edgeHead;
+}
+
+void enableButtonWakeup() {
+    gpio_wakeup_enable((gpio_num_t)buttonPin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+}
+
+void disableButtonWakeup() {
+    // gpio_wakeup_enable() switched the pin to a level interrupt; restore edges
+    gpio_wakeup_disable((gpio_num_t)buttonPin);
+    gpio_set_intr_type((gpio_num_t)buttonPin, GPIO_INTR_ANYEDGE);
+}
+
+uint32_t buttonEdgesDropped() {
+    return droppedEdges;
+}
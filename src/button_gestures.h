@@ -0,0 +1,48 @@
+// button_gestures.h
+#ifndef BUTTON_GESTURES_H
+#define BUTTON_GESTURES_H
+
+#include <stdint.h>
+
+#define BUTTON_EDGE_BUFFER_SIZE 32  // Power of two
+#define BUTTON_GESTURE_QUEUE_SIZE 4
+
+enum ButtonGestureType : uint8_t {
+    GESTURE_DOWN,        // Debounced press edge, sent immediately
+    GESTURE_PRESSES,     // count short presses, sent after multiPressTimeoutMs of quiet
+    GESTURE_LONG_PRESS,  // Released after at least longPressMs
+    GESTURE_HOLD         // Still held after holdMs; the release is then ignored
+};
+
+struct ButtonGesture {
+    ButtonGestureType type;
+    uint8_t count;
+    unsigned long millis;  // Time of the edge that completed the gesture
+};
+
+struct ButtonGestureConfig {
+    uint16_t debounceMs;
+    uint16_t multiPressTimeoutMs;
+    uint16_t longPressMs;
+    uint16_t holdMs;
+};
+
+// Attach the edge interrupt. The button is active LOW with the internal pull-up.
+void beginButtonGestures(int pin, const ButtonGestureConfig& config);
+
+// Decode buffered edges; returns true and fills gesture for each ready gesture.
+// Call every loop iteration until it returns false.
+bool nextButtonGesture(unsigned long nowMillis, ButtonGesture& gesture);
+
+// A press or an undecoded gesture is in progress
+bool buttonGesturePending();
+
+// Let a button press wake the chip from light sleep. This turns the pin into a
+// level interrupt, so call disableButtonWakeup() straight after waking.
+void enableButtonWakeup();
+void disableButtonWakeup();
+
+// Edges dropped because the buffer was full
+uint32_t buttonEdgesDropped();
+
+#endif
@@ -0,0 +1,143 @@
+// chunked_stream.h
+#ifndef CHUNKED_STREAM_H
+#define CHUNKED_STREAM_H
+
+#include <Arduino.h>
+
+// Read-only Stream over one HTTP/1.1 response body: undoes chunked transfer
+// coding, or passes through contentLength bytes (-1: until the connection
+// closes). Reads stop at the end of the body, so a kept-alive connection is
+// left at the start of the next response. Each read waits up to the source's
+// timeout, as Stream::readBytes does.
+class ChunkedStream : public Stream {
+public:
+    ChunkedStream(Stream& source, bool chunked, int contentLength)
+        : source(source), chunked(chunked), remaining(chunked ? 0 : contentLength), done(!chunked && contentLength == 0) {}
+
+    // True once the whole body, with the chunked trailer, has been read
+    bool finished() { return done && peeked < 0; }
+
+    int available() override {
+        if (peeked >= 0) {
+            return 1;
+        }
+        if (done) {
+            return 0;
+        }
+        int count = source.available();
+        if (remaining == 0) {
+            return count > 0 ? 1 : 0;  // The chunk header is not data; at least one byte is near
+        }
+        return remaining > 0 && count > remaining ? remaining : count;
+    }
+
+    int peek() override {
+        if (peeked < 0) {
+            peeked = read();
+        }
+        return peeked;
+    }
+
+    int read() override {
+        char c;
+        return readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+    }
+
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t count = 0;
+        if (length > 0 && peeked >= 0) {
+            buffer[count++] = (char)peeked;
+            peeked = -1;
+        }
+        while (count < length && nextChunk()) {
+            size_t wanted = length - count;
+            if (remaining > 0 && wanted > (size_t)remaining) {
+                wanted = remaining;
+            }
+            size_t n = source.readBytes(buffer + count, wanted);
+            if (n == 0) {
+                done = true;  // Closed or timed out mid-body
+                break;
+            }
+            count += n;
+            if (remaining > 0) {
+                remaining -= n;
+            }
+        }
+        return count;
+    }
+
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    int sourceByte() {
+        char c;
+        return source.readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+    }
+
+    // Function to read up to and including the next LF; false if the stream ends first
+    bool skipLine() {
+        int c;
+        while ((c = sourceByte()) >= 0) {
+            if (c == '\n') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Function to make sure there is body data to read: moves to the next chunk when the
+    // current one is used up, and reads the trailer after the last one
+    bool nextChunk() {
+        if (done) {
+            return false;
+        }
+        if (!chunked || remaining != 0) {
+            if (remaining == 0) {
+                done = true;
+            }
+            return !done;
+        }
+
+        if (started && !skipLine()) {  // CRLF after the previous chunk's data
+            done = true;
+            return false;
+        }
+        started = true;
+
+        // Chunk size in hex, then optional extensions
+        long size = 0;
+        int digits = 0;
+        int c;
+        while ((c = sourceByte()) >= 0 && isxdigit(c)) {
+            size = size * 16 + (isdigit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+            digits++;
+        }
+        if (digits == 0 || size < 0 || (c != '\n' && !skipLine())) {
+            done = true;
+            return false;
+        }
+        if (size == 0) {
+            // Trailer fields, if any, up to an empty line
+            int first;
+            while ((first = sourceByte()) >= 0 && first != '\n' && !(first == '\r' && sourceByte() == '\n')) {
+                if (!skipLine()) {
+                    break;
+                }
+            }
+            done = true;
+            return false;
+        }
+        remaining = size;
+        return true;
+    }
+
+    Stream& source;
+    bool chunked;
+    long remaining;       // Bytes left in the chunk, or in the body; -1 if unknown
+    bool done;
+    bool started = false;  // A chunk has been read, so the next header follows a CRLF
+    int peeked = -1;
+};
+
+#endif
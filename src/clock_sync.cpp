@@ -0,0 +1,268 @@
+// clock_sync.cpp
+// The SNTP answer is timestamped against the soft clock, which follows the
+// DS3231 SQW edges, so the RTC offset is known to well under a millisecond
+// plus the network error. The offset since the last correction gives the
+// drift, which is trimmed with the aging register and sets the next interval.
+#include <Preferences.h>
+#include <Wire.h>
+#include <esp_sntp.h>
+#include <atomic>
+#include <math.h>
+#include "clock_sync.h"
+#include "soft_clock.h"
+
+#define CLOCK_SYNC_NAMESPACE "clockSync"
+
+// Kept in NVS; the DS3231 keeps counting on its battery while the ESP32 is off
+struct ClockSyncState {
+    uint32_t lastCorrection;
+    uint32_t intervalS;
+};
+
+// Filled in by the SNTP callback, then handed to the loop task through answerReady
+struct SntpAnswer {
+    int64_t ntpMicros;   // NTP time, local epoch
+    int64_t rtcMicros;   // RTC time at the same instant
+    uint32_t micros;     // micros() at the same instant
+    bool coarse;         // No SQW, so the RTC's phase within the second is unknown
+};
+
+static RTC_DS3231* syncRtc = nullptr;
+static long syncGmtOffsetSec = 0;
+static int syncDaylightOffsetSec = 0;
+static ClockSyncStats stats;
+static SntpAnswer answer;
+static std::atomic<bool> sntpPending(false);
+static std::atomic<bool> answerReady(false);
+static bool answerMeasured = false;  // Loop task only
+
+static int8_t readAgingOffset() {
+    Wire.beginTransmission(DS3231_I2C_ADDRESS);
+    Wire.write(DS3231_AGING_REGISTER);
+    if (Wire.endTransmission(false) != 0 || Wire.requestFrom((uint8_t)DS3231_I2C_ADDRESS, (uint8_t)1) != 1) {
+        return 0;
+    }
+    return (int8_t)Wire.read();
+}
+
+static bool writeAgingOffset(int8_t aging) {
+    Wire.beginTransmission(DS3231_I2C_ADDRESS);
+    Wire.write(DS3231_AGING_REGISTER);
+    Wire.write((uint8_t)aging);
+    if (Wire.endTransmission() != 0) {
+        return false;
+    }
+
+    // The offset is applied at the next temperature conversion; start one now instead of within 64 s
+    Wire.beginTransmission(DS3231_I2C_ADDRESS);
+    Wire.write(DS3231_CONTROL_REGISTER);
+    if (Wire.endTransmission(false) != 0 || Wire.requestFrom((uint8_t)DS3231_I2C_ADDRESS, (uint8_t)1) != 1) {
+        return false;
+    }
+    uint8_t control = Wire.read();
+    Wire.beginTransmission(DS3231_I2C_ADDRESS);
+    Wire.write(DS3231_CONTROL_REGISTER);
+    Wire.write(control | DS3231_CONTROL_CONV);
+    return Wire.endTransmission() == 0;
+}
+
+static void saveState() {
+    ClockSyncState state = {stats.lastCorrection, stats.intervalS};
+    Preferences preferences;
+    preferences.begin(CLOCK_SYNC_NAMESPACE, false);
+    preferences.putBytes("state", &state, sizeof(state));
+    preferences.end();
+}
+
+// Runs in the SNTP (lwIP) task right after it has set the system time
+static void onSntpAnswer(struct timeval* tv) {
+    bool expected = true;
+    if (answerReady || !sntpPending.compare_exchange_strong(expected, false)) {
+        return;  // SNTP polling again on its own while Wi-Fi stays up
+    }
+    answer.micros = micros();
+    answer.rtcMicros = softClockMicros();
+    answer.coarse = !softClockUsingSqw();
+    answer.ntpMicros = ((int64_t)tv->tv_sec + syncGmtOffsetSec + syncDaylightOffsetSec) * 1000000LL + tv->tv_usec;
+    answerReady = true;
+}
+
+void beginClockSync(RTC_DS3231* rtc, long gmtOffsetSec, int daylightOffsetSec) {
+    syncRtc = rtc;
+    syncGmtOffsetSec = gmtOffsetSec;
+    syncDaylightOffsetSec = daylightOffsetSec;
+    memset(&stats, 0, sizeof(stats));
+    stats.aging = readAgingOffset();
+
+    ClockSyncState state = {0, CLOCK_SYNC_MIN_INTERVAL_S};
+    Preferences preferences;
+    if (preferences.begin(CLOCK_SYNC_NAMESPACE, true)) {
+        preferences.getBytes("state", &state, sizeof(state));
+        preferences.end();
+    }
+    if (rtc->lostPower()) {
+        state.lastCorrection = 0;  // The RTC restarted from an arbitrary time
+    }
+
+    stats.lastCorrection = state.lastCorrection;
+    stats.intervalS = constrain(state.intervalS, CLOCK_SYNC_MIN_INTERVAL_S, CLOCK_SYNC_MAX_INTERVAL_S);
+    stats.nextSyncTime = stats.lastCorrection != 0 ? stats.lastCorrection + stats.intervalS : 0;
+    sntp_set_time_sync_notification_cb(onSntpAnswer);
+
+    if (stats.nextSyncTime == 0) {
+        Serial.printf("Clock sync: aging offset %d, RTC not synced yet\n", stats.aging);
+    } else {
+        Serial.printf("Clock sync: aging offset %d, next NTP sync in %ld s\n", stats.aging,
+                      (long)stats.nextSyncTime - (long)softClockNow().unixtime());
+    }
+}
+
+bool runSntpSync(const char* server) {
+    if (answerReady) {
+        return true;  // The previous answer has not been applied yet
+    }
+
+    sntpPending = true;
+    configTime(syncGmtOffsetSec, syncDaylightOffsetSec, server);  // Restarts SNTP, which polls in the background
+
+    unsigned long start = millis();
+    while (sntpPending && millis() - start < CLOCK_SYNC_TIMEOUT_MS) {
+        delay(20);
+    }
+    bool answered = !sntpPending.exchange(false);
+    sntp_stop();  // Syncs are scheduled here, not by SNTP's own poll timer
+    return answered;
+}
+
+// Function to turn an answer into an offset, a drift estimate, an aging trim and the next interval
+static void measureAnswer() {
+    ClockSyncRecord& record = stats.history[stats.historyNext];
+    int64_t offsetMicros = answer.ntpMicros - answer.rtcMicros;
+    record.rtcTime = (uint32_t)(answer.rtcMicros / 1000000LL);
+    record.offsetMs = (int32_t)(offsetMicros / 1000);
+    record.elapsedS = 0;
+    record.driftPpm = 0;
+
+    uint32_t interval = CLOCK_SYNC_MIN_INTERVAL_S;
+    if (stats.lastCorrection != 0 && record.rtcTime > stats.lastCorrection) {
+        record.elapsedS = record.rtcTime - stats.lastCorrection;
+        record.driftPpm = -(float)offsetMicros / record.elapsedS;  // Microseconds per second is ppm
+
+        float errorMs = answer.coarse ? CLOCK_SYNC_COARSE_ERROR_MS : CLOCK_SYNC_MEASUREMENT_ERROR_MS;
+        float uncertaintyPpm = errorMs * 1000.0f / record.elapsedS;
+        float residualPpm = fabsf(record.driftPpm);
+
+        // Trim only when the drift clearly stands out from the measurement error
+        if (residualPpm >= 2 * uncertaintyPpm && residualPpm >= DS3231_AGING_PPM_PER_LSB) {
+            int aging = constrain(stats.aging + (int)lroundf(record.driftPpm / DS3231_AGING_PPM_PER_LSB), -128, 127);
+            if (aging != stats.aging && writeAgingOffset((int8_t)aging)) {
+                residualPpm = fabsf(record.driftPpm - (aging - stats.aging) * DS3231_AGING_PPM_PER_LSB);
+                stats.aging = (int8_t)aging;
+            }
+        }
+
+        // Sync again when the expected error, plus the error of this measurement, reaches
+        // the target; growing at most twofold per sync
+        residualPpm = max(residualPpm, max(uncertaintyPpm, (float)CLOCK_SYNC_DRIFT_FLOOR_PPM));
+        float budgetMs = max(CLOCK_SYNC_TARGET_ERROR_MS - errorMs, CLOCK_SYNC_TARGET_ERROR_MS / 2.0f);
+        uint32_t previous = max(stats.intervalS, (uint32_t)CLOCK_SYNC_MIN_INTERVAL_S);
+        interval = (uint32_t)min(budgetMs * 1000.0f / residualPpm, 2.0f * previous);
+        if (abs(record.offsetMs) > CLOCK_SYNC_TARGET_ERROR_MS) {
+            interval = min(interval, previous / 2);
+        }
+        interval = constrain(interval, CLOCK_SYNC_MIN_INTERVAL_S, CLOCK_SYNC_MAX_INTERVAL_S);
+    }
+
+    record.aging = stats.aging;
+    record.intervalS = interval;
+    stats.intervalS = interval;
+    stats.syncs++;
+    stats.historyNext = (stats.historyNext + 1) % CLOCK_SYNC_HISTORY;
+    if (stats.historyCount < CLOCK_SYNC_HISTORY) {
+        stats.historyCount++;
+    }
+}
+
+// Function to get NTP time now: from the last SQW edge, or without SQW from micros(), as the
+// fallback soft clock only moves on in the loop
+static int64_t ntpMicrosNow() {
+    if (softClockUsingSqw()) {
+        return softClockMicros() + (answer.ntpMicros - answer.rtcMicros);
+    }
+    return answer.ntpMicros + (uint32_t)(micros() - answer.micros);
+}
+
+bool updateClockSync() {
+    if (!answerReady) {
+        return false;
+    }
+    if (!answerMeasured) {
+        measureAnswer();
+        answerMeasured = true;
+    }
+
+    // The DS3231 restarts its second on a write, so write just after a whole NTP second. That
+    // second lands at a fixed point between two SQW edges, which the soft clock interpolates.
+    // Further than CLOCK_SYNC_WRITE_WAIT_US away, try again on a later pass; closer, sleep
+    // until it, yielding the core for the whole milliseconds.
+    int64_t ntpNow = ntpMicrosNow();
+    uint32_t phase = (uint32_t)(ntpNow % 1000000LL);
+    if (phase > CLOCK_SYNC_WRITE_WINDOW_US) {
+        uint32_t wait = 1000000UL - phase;
+        if (wait > CLOCK_SYNC_WRITE_WAIT_US) {
+            return false;
+        }
+        delay(wait / 1000);
+        delayMicroseconds(wait % 1000);
+        ntpNow = ntpMicrosNow();
+        phase = (uint32_t)(ntpNow % 1000000LL);
+    }
+
+    DateTime ntpTime((uint32_t)(ntpNow / 1000000LL));
+    syncRtc->adjust(ntpTime);
+    setSoftClock(ntpTime);
+
+    const ClockSyncRecord& record = stats.history[(stats.historyNext + CLOCK_SYNC_HISTORY - 1) % CLOCK_SYNC_HISTORY];
+    stats.lastCorrection = ntpTime.unixtime();
+    stats.nextSyncTime = stats.lastCorrection + stats.intervalS;
+    saveState();
+
+    answerMeasured = false;
+    answerReady = false;
+    Serial.printf("RTC set from NTP (%u us late): was off by %d ms, drift %.2f ppm, aging %d, next sync in %u s\n",
+                  (unsigned)phase, (int)record.offsetMs, record.driftPpm, stats.aging, (unsigned)stats.intervalS);
+    return true;
+}
+
+bool clockSyncPending() {
+    return answerReady;
+}
+
+bool clockSyncDue(uint32_t rtcNow) {
+    return rtcNow >= stats.nextSyncTime;
+}
+
+void markClockSyncRequested(uint32_t rtcNow) {
+    stats.nextSyncTime = rtcNow + CLOCK_SYNC_RETRY_S;  // Pushed out again once the sync lands
+}
+
+void noteClockSyncFailed() {
+    stats.failures++;
+}
+
+const ClockSyncStats& clockSyncStats() {
+    return stats;
+}
+
+void printClockSyncReport(Print& out) {
+    out.printf("clock,syncs,%u,failures,%u,aging,%d,interval_s,%u,next_in_s,%ld\n", (unsigned)stats.syncs,
+               (unsigned)stats.failures, stats.aging, (unsigned)stats.intervalS,
+               (long)stats.nextSyncTime - (long)softClockNow().unixtime());
+    out.println("sync,rtc_time,offset_ms,elapsed_s,drift_ppm,aging,interval_s");
+    for (int i = 0; i < stats.historyCount; i++) {
+        const ClockSyncRecord& record =
+            stats.history[(stats.historyNext + CLOCK_SYNC_HISTORY - stats.historyCount + i) % CLOCK_SYNC_HISTORY];
+        out.printf("sync,%u,%d,%u,%.3f,%d,%u\n", (unsigned)record.rtcTime, (int)record.offsetMs,
+                   (unsigned)record.elapsedS, record.driftPpm, record.aging, (unsigned)record.intervalS);
+    }
+}
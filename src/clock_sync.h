@@ -0,0 +1,75 @@
+// clock_sync.h
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+// Background SNTP that disciplines the DS3231: each sync measures the RTC's
+// offset, estimates its drift, trims the aging-offset register and picks the
+// next sync as late as the target error allows.
+#define CLOCK_SYNC_TARGET_ERROR_MS 500        // Keep the RTC within this of NTP between syncs
+#define CLOCK_SYNC_MIN_INTERVAL_S 3600UL      // After boot, power loss or a large error
+#define CLOCK_SYNC_MAX_INTERVAL_S 2419200UL   // Four weeks
+#define CLOCK_SYNC_RETRY_S 1800UL             // After a failed or pending sync
+#define CLOCK_SYNC_TIMEOUT_MS 10000           // Wait this long for the SNTP answer
+#define CLOCK_SYNC_MEASUREMENT_ERROR_MS 30    // NTP over Wi-Fi plus the RTC write phase
+#define CLOCK_SYNC_COARSE_ERROR_MS 1000       // Without SQW the RTC phase is unknown
+#define CLOCK_SYNC_DRIFT_FLOOR_PPM 0.5f       // Temperature drift the aging offset cannot remove
+#define CLOCK_SYNC_WRITE_WINDOW_US 20000UL    // Write the RTC within this of a whole NTP second
+#define CLOCK_SYNC_WRITE_WAIT_US 100000UL     // Sleep the loop until the second only when it is this close
+#define CLOCK_SYNC_HISTORY 16
+
+#define DS3231_I2C_ADDRESS 0x68
+#define DS3231_CONTROL_REGISTER 0x0E
+#define DS3231_AGING_REGISTER 0x10
+#define DS3231_CONTROL_CONV 0x20            // Start a temperature conversion, which applies the aging offset
+#define DS3231_AGING_PPM_PER_LSB 0.1f       // At 25 C; positive values slow the oscillator
+
+struct ClockSyncRecord {
+    uint32_t rtcTime;     // RTC time (local) when the answer arrived
+    int32_t offsetMs;     // NTP minus RTC before the correction
+    uint32_t elapsedS;    // Since the previous correction, 0 if unknown
+    float driftPpm;       // Measured drift, positive when the RTC runs fast; 0 if unknown
+    int8_t aging;         // Aging offset in force after this sync
+    uint32_t intervalS;   // Chosen time until the next sync
+};
+
+struct ClockSyncStats {
+    uint32_t syncs;
+    uint32_t failures;
+    uint32_t lastCorrection;  // RTC time of the last write, 0 if none since power loss
+    uint32_t intervalS;
+    uint32_t nextSyncTime;
+    int8_t aging;
+    uint8_t historyCount;
+    uint8_t historyNext;      // Ring index of the next record
+    ClockSyncRecord history[CLOCK_SYNC_HISTORY];
+};
+
+// Read the aging register and the last correction from NVS. Call after the
+// soft clock is running.
+void beginClockSync(RTC_DS3231* rtc, long gmtOffsetSec, int daylightOffsetSec);
+
+// Network task: start SNTP and keep the radio up until it answers or times out.
+// The answer is timestamped against the RTC in the SNTP callback.
+bool runSntpSync(const char* server);
+
+// Loop task, every pass: once an answer is in, write the RTC at the next whole
+// NTP second and update the drift estimate. Returns true when the RTC was set,
+// false while the second is still more than CLOCK_SYNC_WRITE_WAIT_US away.
+bool updateClockSync();
+
+// True while an SNTP answer waits for its whole second; do not sleep then
+bool clockSyncPending();
+
+// True when the adaptive interval has run out. Mark the request so it is
+// not repeated every second while the network task works on it.
+bool clockSyncDue(uint32_t rtcNow);
+void markClockSyncRequested(uint32_t rtcNow);
+void noteClockSyncFailed();
+
+const ClockSyncStats& clockSyncStats();
+void printClockSyncReport(Print& out);
+
+#endif
@@ -0,0 +1,227 @@
+// config_cache.cpp
+// In-RAM copy of the settings kept in Preferences. Everything is read once
+// at boot; changes are written back lazily and only when the value differs.
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config_cache.h"
+
+// Stored as one blob, so the counts cost no write of their own except at a new month
+struct LocationRecord {
+    CachedLocation location;
+    LocationLookupStats stats;
+    LocationLookupStats previous;    // The last completed month
+    bool valid;
+};
+
+struct ConfigCache {
+    char city[CONFIG_CITY_SIZE];
+    char wifiSsid[CONFIG_SSID_SIZE];
+    char wifiPassword[CONFIG_PASSWORD_SIZE];
+    LocationRecord location;
+    bool cityDirty;
+    bool wifiDirty;
+    bool locationDirty;
+    unsigned long lastChangeMillis;
+};
+
+static ConfigCache cache;
+static FlashWriteStats writeStats = {0, 0, 0, 0};
+static SemaphoreHandle_t cacheLock = nullptr;
+static Preferences cachePreferences;
+
+static void lockCache() {
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+}
+
+static void unlockCache() {
+    xSemaphoreGive(cacheLock);
+}
+
+static void copyString(char* out, size_t size, const char* value) {
+    strncpy(out, value, size - 1);
+    out[size - 1] = '\0';
+}
+
+void loadConfigCache() {
+    if (cacheLock == nullptr) {
+        cacheLock = xSemaphoreCreateMutex();
+    }
+
+    lockCache();
+    memset(&cache, 0, sizeof(cache));
+
+    cachePreferences.begin("cityData", true);
+    cachePreferences.getString("city", cache.city, sizeof(cache.city));
+    cachePreferences.end();
+
+    cachePreferences.begin("WiFiCreds", true);
+    cachePreferences.getString("ssid", cache.wifiSsid, sizeof(cache.wifiSsid));
+    cachePreferences.getString("password", cache.wifiPassword, sizeof(cache.wifiPassword));
+    cachePreferences.end();
+
+    cachePreferences.begin("location", true);
+    if (cachePreferences.getBytes("record", &cache.location, sizeof(cache.location)) != sizeof(cache.location)) {
+        memset(&cache.location, 0, sizeof(cache.location));
+    }
+    cachePreferences.end();
+    unlockCache();
+
+    Serial.println("Configuration loaded from Preferences.");
+}
+
+void copyCachedCity(char* out, size_t size) {
+    lockCache();
+    copyString(out, size, cache.city);
+    unlockCache();
+}
+
+void copyCachedWifiCredentials(char* ssid, size_t ssidSize, char* password, size_t passwordSize) {
+    lockCache();
+    copyString(ssid, ssidSize, cache.wifiSsid);
+    copyString(password, passwordSize, cache.wifiPassword);
+    unlockCache();
+}
+
+bool copyCachedLocation(CachedLocation& location) {
+    lockCache();
+    location = cache.location.location;
+    bool valid = cache.location.valid;
+    unlockCache();
+    return valid;
+}
+
+LocationLookupStats locationLookupStats() {
+    lockCache();
+    LocationLookupStats stats = cache.location.stats;
+    unlockCache();
+    return stats;
+}
+
+LocationLookupStats previousLocationLookupStats() {
+    lockCache();
+    LocationLookupStats stats = cache.location.previous;
+    unlockCache();
+    return stats;
+}
+
+void setCachedCity(const char* city) {
+    lockCache();
+    if (strncmp(cache.city, city, sizeof(cache.city) - 1) != 0) {
+        copyString(cache.city, sizeof(cache.city), city);
+        cache.cityDirty = true;
+        cache.lastChangeMillis = millis();
+    } else {
+        writeStats.skipped++;
+    }
+    unlockCache();
+}
+
+void setCachedWifiCredentials(const char* ssid, const char* password) {
+    lockCache();
+    if (strncmp(cache.wifiSsid, ssid, sizeof(cache.wifiSsid) - 1) != 0 ||
+        strncmp(cache.wifiPassword, password, sizeof(cache.wifiPassword) - 1) != 0) {
+        copyString(cache.wifiSsid, sizeof(cache.wifiSsid), ssid);
+        copyString(cache.wifiPassword, sizeof(cache.wifiPassword), password);
+        cache.wifiDirty = true;
+        cache.lastChangeMillis = millis();
+    } else {
+        writeStats.skipped++;
+    }
+    unlockCache();
+}
+
+void setCachedLocation(const CachedLocation& location) {
+    lockCache();
+    if (!cache.location.valid || memcmp(&cache.location.location, &location, sizeof(location)) != 0) {
+        cache.location.location = location;
+        cache.location.valid = true;
+        cache.locationDirty = true;
+        cache.lastChangeMillis = millis();
+    } else {
+        writeStats.skipped++;
+    }
+    unlockCache();
+}
+
+void noteLocationLookups(uint16_t month, int made, int saved) {
+    lockCache();
+    LocationLookupStats& stats = cache.location.stats;
+    if (stats.month != month) {
+        // Stored once per month; within it the counts ride along with the next location write
+        cache.locationDirty = true;
+        cache.lastChangeMillis = millis();
+        if (stats.month != 0) {
+            Serial.printf("Location lookups in month %u: %u made, %u skipped\n", (unsigned)(stats.month % 12 + 1),
+                          (unsigned)stats.made, (unsigned)stats.saved);
+            cache.location.previous = stats;
+        }
+        stats.month = month;
+        stats.made = 0;
+        stats.saved = 0;
+    }
+    stats.made += made;
+    stats.saved += saved;
+    unlockCache();
+}
+
+void flushConfigCache(unsigned long nowMillis, bool force) {
+    if (cacheLock == nullptr) {
+        return;
+    }
+
+    lockCache();
+    bool due = (cache.cityDirty || cache.wifiDirty || cache.locationDirty) &&
+               (force || nowMillis - cache.lastChangeMillis >= CONFIG_FLUSH_DELAY_MS);
+    if (!due) {
+        unlockCache();
+        return;
+    }
+
+    // Snapshot under the lock, write outside it
+    ConfigCache pending = cache;
+    cache.cityDirty = false;
+    cache.wifiDirty = false;
+    cache.locationDirty = false;
+    unlockCache();
+
+    if (pending.cityDirty) {
+        cachePreferences.begin("cityData", false);
+        recordFlashWrite(cachePreferences.putString("city", pending.city));
+        cachePreferences.end();
+        Serial.println("City name stored in Preferences.");
+    }
+    if (pending.wifiDirty) {
+        cachePreferences.begin("WiFiCreds", false);
+        recordFlashWrite(cachePreferences.putString("ssid", pending.wifiSsid));
+        recordFlashWrite(cachePreferences.putString("password", pending.wifiPassword));
+        cachePreferences.end();
+        Serial.println("WiFi credentials stored in Preferences.");
+    }
+    if (pending.locationDirty) {
+        cachePreferences.begin("location", false);
+        recordFlashWrite(cachePreferences.putBytes("record", &pending.location, sizeof(pending.location)));
+        cachePreferences.end();
+        Serial.println("Location stored in Preferences.");
+    }
+}
+
+void recordFlashWrite(size_t bytes) {
+    writeStats.writes++;
+    writeStats.writesToday++;
+    writeStats.bytes += bytes;
+}
+
+void recordSkippedFlashWrite() {
+    writeStats.skipped++;
+}
+
+void resetDailyFlashWrites() {
+    Serial.printf("NVS writes yesterday: %u (total %u writes, %u bytes, %u skipped)\n",
+                  (unsigned)writeStats.writesToday, (unsigned)writeStats.writes,
+                  (unsigned)writeStats.bytes, (unsigned)writeStats.skipped);
+    writeStats.writesToday = 0;
+}
+
+const FlashWriteStats& flashWriteStats() {
+    return writeStats;
+}
@@ -0,0 +1,67 @@
+// config_cache.h
+#ifndef CONFIG_CACHE_H
+#define CONFIG_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONFIG_CITY_SIZE 32
+#define CONFIG_SSID_SIZE 33
+#define CONFIG_PASSWORD_SIZE 65
+#define CONFIG_IP_SIZE 16
+#define CONFIG_FLUSH_DELAY_MS 5000  // Coalesce changes made within this window into one write
+#define CONFIG_LOCATION_TTL_S 2592000UL  // Look the public IP up again after 30 days on the same network
+
+// Where the clock is, and the network it was found through
+struct CachedLocation {
+    double latitude;
+    double longitude;
+    uint32_t ssidHash;               // CRC-32 of the SSID
+    uint8_t bssid[6];                // Access point
+    char publicIp[CONFIG_IP_SIZE];
+    uint32_t checkedAt;              // RTC time the public IP was last looked up
+};
+
+// Location round-trips (public IP, geolocation) made and skipped in one calendar month
+struct LocationLookupStats {
+    uint16_t month;                  // year * 12 + month - 1
+    uint16_t made;
+    uint16_t saved;
+};
+
+struct FlashWriteStats {
+    uint32_t writes;         // NVS writes since boot
+    uint32_t bytes;          // Bytes written since boot
+    uint32_t writesToday;    // Reset at midnight
+    uint32_t skipped;        // Writes avoided because the value was unchanged
+};
+
+// Read every cached setting from NVS once at boot
+void loadConfigCache();
+
+// Reads are served from RAM and safe from either task
+void copyCachedCity(char* out, size_t size);
+void copyCachedWifiCredentials(char* ssid, size_t ssidSize, char* password, size_t passwordSize);
+bool copyCachedLocation(CachedLocation& location);  // False if no location is stored
+LocationLookupStats locationLookupStats();          // This month
+LocationLookupStats previousLocationLookupStats();  // The last completed month; month 0 if none
+
+// Updates only mark the entry dirty if the value actually changed
+void setCachedCity(const char* city);
+void setCachedWifiCredentials(const char* ssid, const char* password);
+void setCachedLocation(const CachedLocation& location);
+
+// Count the round-trips of one location lookup, in RAM; a new month keeps the finished
+// month's counts as the previous ones, starts over and stores both. Within a month they reach NVS with the next setCachedLocation() change.
+void noteLocationLookups(uint16_t month, int made, int saved);
+
+// Write dirty entries once they have settled; call from the loop task
+void flushConfigCache(unsigned long nowMillis, bool force = false);
+
+// Account for NVS writes made outside the cache (e.g. the schedule blob)
+void recordFlashWrite(size_t bytes);
+void recordSkippedFlashWrite();
+void resetDailyFlashWrites();
+const FlashWriteStats& flashWriteStats();
+
+#endif
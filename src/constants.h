@@ -5,4 +5,11 @@
 const char* WIFI_SSID = "";          // Your WiFi SSID
 const char* WIFI_PASSWORD = "";  // Your WiFi Password
 
+const char* LOCATION_LATITUDE = "";   // Optional, e.g. "12.9716"; leave empty to geolocate by IP
+const char* LOCATION_LONGITUDE = "";  // Optional, e.g. "77.5946"
+
+const bool LARGE_CLOCK_FULL_PANEL = false;  // Clock screen: hours and minutes across the whole panel
+
+const bool STATUS_SERVER = false;  // Keep Wi-Fi up and serve /status and /schedule as JSON over HTTP
+
 #endif
@@ -0,0 +1,36 @@
+// counting_stream.h
+#ifndef COUNTING_STREAM_H
+#define COUNTING_STREAM_H
+
+#include <Arduino.h>
+
+// Read-only Stream wrapper that counts the bytes pulled through it
+class CountingStream : public Stream {
+public:
+    CountingStream(Stream& source, uint32_t& counter) : source(source), counter(counter) {}
+
+    int available() override { return source.available(); }
+    int peek() override { return source.peek(); }
+
+    int read() override {
+        int c = source.read();
+        if (c >= 0) {
+            counter++;
+        }
+        return c;
+    }
+
+    size_t readBytes(char* buffer, size_t length) override {
+        size_t n = source.readBytes(buffer, length);
+        counter += n;
+        return n;
+    }
+
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    Stream& source;
+    uint32_t& counter;
+};
+
+#endif
@@ -0,0 +1,78 @@
+// digit_font.cpp
+#include "digit_font.h"
+#include "digit_atlas.h"
+#include "display_flush.h"
+
+const DigitFont DIGIT_FONT_SMALL = {12, 6, 2, DIGIT_ATLAS_SMALL_DIGITS, DIGIT_ATLAS_SMALL_COLON};
+const DigitFont DIGIT_FONT_LARGE = {28, 12, 6, DIGIT_ATLAS_LARGE_DIGITS, DIGIT_ATLAS_LARGE_COLON};
+
+int digitTextWidth(const DigitFont& font, const char* text) {
+    int width = 0;
+    for (; *text != '\0'; text++) {
+        width += *text == ':' ? font.colonWidth : font.width;
+    }
+    return width;
+}
+
+// Function to copy one glyph cell (width columns, one byte each per page) into the framebuffer
+static void blitCell(uint8_t* buffer, const uint8_t* glyph, int width, int pages, int x, int y) {
+    int first = max(0, -x);
+    int last = min(width, DISPLAY_COLUMNS - x);
+    if (first >= last) {
+        return;
+    }
+
+    int shift = y & 7;
+    int page = y >> 3;  // Arithmetic shift, so rows above the panel give negative pages
+    for (int p = 0; p < pages; p++) {
+        const uint8_t* source = glyph + p * width;
+        int top = page + p;
+        if (shift == 0) {
+            if (top >= 0 && top < DISPLAY_PAGES) {
+                memcpy(buffer + top * DISPLAY_COLUMNS + x + first, source + first, last - first);
+            }
+            continue;
+        }
+
+        // Straddles two pages: the low bits land in this page, the high bits in the next
+        uint8_t lowMask = 0xFF << shift;
+        uint8_t highMask = 0xFF >> (8 - shift);
+        for (int c = first; c < last; c++) {
+            uint8_t bits = source[c];
+            if (top >= 0 && top < DISPLAY_PAGES) {
+                uint8_t& target = buffer[top * DISPLAY_COLUMNS + x + c];
+                target = (target & ~lowMask) | (uint8_t)(bits << shift);
+            }
+            if (top + 1 >= 0 && top + 1 < DISPLAY_PAGES) {
+                uint8_t& target = buffer[(top + 1) * DISPLAY_COLUMNS + x + c];
+                target = (target & ~highMask) | (uint8_t)(bits >> (8 - shift));
+            }
+        }
+    }
+}
+
+// Function to clear a blank cell, so spaces overwrite like glyphs do
+static void clearCell(uint8_t* buffer, int width, int pages, int x, int y) {
+    static const uint8_t blank[DISPLAY_COLUMNS] = {0};
+    for (int p = 0; p < pages; p++) {
+        blitCell(buffer, blank, width, 1, x, y + p * 8);
+    }
+}
+
+int drawDigits(uint8_t* buffer, const DigitFont& font, int x, int y, const char* text) {
+    int cellBytes = font.width * font.pages;
+    for (; *text != '\0'; text++) {
+        char c = *text;
+        if (c >= '0' && c <= '9') {
+            blitCell(buffer, font.digits + (c - '0') * cellBytes, font.width, font.pages, x, y);
+            x += font.width;
+        } else if (c == ':') {
+            blitCell(buffer, font.colon, font.colonWidth, font.pages, x, y);
+            x += font.colonWidth;
+        } else {
+            clearCell(buffer, font.width, font.pages, x, y);
+            x += font.width;
+        }
+    }
+    return x;
+}
@@ -0,0 +1,29 @@
+// digit_font.h
+#ifndef DIGIT_FONT_H
+#define DIGIT_FONT_H
+
+#include <Arduino.h>
+
+// Pre-rendered clock digits (src/digit_atlas.h) in the SSD1306 framebuffer's
+// own page-major layout. On a page-aligned row a glyph is copied in with one
+// memcpy per page instead of being drawn pixel by pixel through Adafruit GFX.
+struct DigitFont {
+    uint8_t width;           // Digit cell width, spacing included
+    uint8_t colonWidth;
+    uint8_t pages;           // Height in 8-pixel pages
+    const uint8_t* digits;   // '0' to '9', width * pages bytes each
+    const uint8_t* colon;
+};
+
+extern const DigitFont DIGIT_FONT_SMALL;  // 12x16, the size of setTextSize(2)
+extern const DigitFont DIGIT_FONT_LARGE;  // 28x48, "12:59" spans the panel
+
+// Width in pixels of text made of digits, colons and spaces (a space is a digit wide)
+int digitTextWidth(const DigitFont& font, const char* text);
+
+// Draw text into a 128-column SSD1306 framebuffer with its top-left corner at
+// (x, y). Glyph cells overwrite what is under them; anything off the panel is
+// clipped. A y that is a multiple of 8 is the fast path. Returns the x after the text.
+int drawDigits(uint8_t* buffer, const DigitFont& font, int x, int y, const char* text);
+
+#endif
@@ -0,0 +1,200 @@
+// display_flush.cpp
+// Diffing flush for the SSD1306. A shadow copy of what the panel currently
+// shows is kept; each flush finds the changed column range of every 8-pixel
+// page and sends only that window using page/column addressing.
+//
+// The loop renders into the Adafruit framebuffer and flushDisplay() copies it
+// into a frame of its own, then swaps that with the pending frame. The flush
+// task swaps the pending frame with the one it sends, so the loop draws the
+// next frame while the previous one is on the bus. Only pointers are swapped
+// under the spinlock; the copy and the transfer happen outside it.
+#include <atomic>
+#include "display_flush.h"
+#include "telemetry.h"
+
+static Adafruit_SSD1306* flushDisplayTarget = nullptr;
+static TwoWire* flushWire = nullptr;
+static uint8_t flushAddress = 0;
+
+static uint8_t shadowBuffer[DISPLAY_FRAME_SIZE];
+static std::atomic<bool> shadowValid(false);
+static DisplayFlushStats flushStats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static uint8_t frames[3][DISPLAY_FRAME_SIZE];
+static uint8_t* fillFrame = frames[0];     // Written by flushDisplay() only
+static uint8_t* pendingFrame = frames[1];  // Handed over, under frameMux
+static uint8_t* sendingFrame = frames[2];  // Read by the flush task only
+static bool framePending = false;
+static std::atomic<bool> flushBusy(false);  // A frame is pending or on the bus
+static TaskHandle_t flushWaiter = nullptr;  // Blocked in waitDisplayFlush(), notified when idle
+static portMUX_TYPE frameMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t flushTask = nullptr;
+
+void invalidateDisplay() {
+    shadowValid = false;
+}
+
+const DisplayFlushStats& displayFlushStats() {
+    return flushStats;
+}
+
+// Send one page window; returns the I2C payload bytes used
+static uint32_t sendWindow(uint8_t page, uint8_t firstColumn, uint8_t lastColumn, const uint8_t* data) {
+    // Addressing in one transaction, so a command from another task cannot split it
+    flushWire->beginTransmission(flushAddress);
+    flushWire->write((uint8_t)0x00);  // Command stream
+    flushWire->write((uint8_t)SSD1306_PAGEADDR);
+    flushWire->write(page);
+    flushWire->write(page);
+    flushWire->write((uint8_t)SSD1306_COLUMNADDR);
+    flushWire->write(firstColumn);
+    flushWire->write(lastColumn);
+    flushWire->endTransmission();
+    uint32_t bytes = 6 + 1;
+
+    int remaining = lastColumn - firstColumn + 1;
+    while (remaining > 0) {
+        int chunk = remaining < DISPLAY_I2C_CHUNK ? remaining : DISPLAY_I2C_CHUNK;
+        flushWire->beginTransmission(flushAddress);
+        flushWire->write((uint8_t)0x40);  // Data stream
+        flushWire->write(data, chunk);
+        flushWire->endTransmission();
+        bytes += chunk + 1;
+        data += chunk;
+        remaining -= chunk;
+    }
+    return bytes;
+}
+
+// Function to push the difference between frame and the shadow copy to the panel
+static void sendFrame(const uint8_t* frame) {
+    unsigned long start = micros();
+    uint32_t bytes = 0;
+    uint32_t dirtyPages = 0;
+    bool diff = shadowValid.exchange(true);
+
+    for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
+        const uint8_t* row = frame + page * DISPLAY_COLUMNS;
+        uint8_t* shadowRow = shadowBuffer + page * DISPLAY_COLUMNS;
+
+        int first = 0;
+        int last = DISPLAY_COLUMNS - 1;
+        if (diff) {
+            while (first < DISPLAY_COLUMNS && row[first] == shadowRow[first]) first++;
+            if (first == DISPLAY_COLUMNS) {
+                continue;  // Page unchanged
+            }
+            while (row[last] == shadowRow[last]) last--;
+        }
+
+        bytes += sendWindow(page, first, last, row + first);
+        memcpy(shadowRow + first, row + first, last - first + 1);
+        dirtyPages++;
+    }
+
+    flushStats.frames++;
+    flushStats.lastFrameBytes = bytes;
+    flushStats.lastDirtyPages = dirtyPages;
+    flushStats.lastFrameMicros = micros() - start;
+    flushStats.totalBytes += bytes;
+    flushStats.totalMicros += flushStats.lastFrameMicros;
+    telemetryRecord(TELEMETRY_FLUSH, start);
+}
+
+static void flushTaskMain(void* parameter) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (;;) {
+            portENTER_CRITICAL(&frameMux);
+            if (!framePending) {
+                flushBusy = false;
+                TaskHandle_t waiter = flushWaiter;
+                flushWaiter = nullptr;
+                portEXIT_CRITICAL(&frameMux);
+                if (waiter != nullptr) {
+                    xTaskNotifyGive(waiter);
+                }
+                break;
+            }
+            uint8_t* frame = pendingFrame;
+            pendingFrame = sendingFrame;
+            sendingFrame = frame;
+            framePending = false;
+            portEXIT_CRITICAL(&frameMux);
+
+            sendFrame(sendingFrame);
+        }
+    }
+}
+
+void beginDisplayFlush(Adafruit_SSD1306* display, TwoWire* wire, uint8_t address) {
+    flushDisplayTarget = display;
+    flushWire = wire;
+    flushAddress = address;
+    shadowValid = false;
+    wire->setClock(DISPLAY_I2C_CLOCK_HZ);
+
+    if (flushTask == nullptr &&
+        xTaskCreatePinnedToCore(flushTaskMain, "flush", DISPLAY_FLUSH_TASK_STACK, nullptr,
+                                DISPLAY_FLUSH_TASK_PRIORITY, &flushTask, DISPLAY_FLUSH_TASK_CORE) != pdPASS) {
+        flushTask = nullptr;
+        Serial.println("Display flush task failed to start, flushing in the loop.");
+    }
+}
+
+void flushDisplay() {
+    if (flushDisplayTarget == nullptr) {
+        return;
+    }
+    if (flushTask == nullptr) {
+        sendFrame(flushDisplayTarget->getBuffer());
+        return;
+    }
+
+    unsigned long start = micros();
+    memcpy(fillFrame, flushDisplayTarget->getBuffer(), DISPLAY_FRAME_SIZE);
+    portENTER_CRITICAL(&frameMux);
+    uint8_t* frame = pendingFrame;
+    pendingFrame = fillFrame;
+    fillFrame = frame;
+    if (framePending) {
+        flushStats.superseded++;
+    }
+    framePending = true;
+    flushBusy = true;
+    portEXIT_CRITICAL(&frameMux);
+    xTaskNotifyGive(flushTask);
+
+    uint32_t elapsed = micros() - start;
+    flushStats.handoffs++;
+    flushStats.totalHandoffMicros += elapsed;
+    if (elapsed > flushStats.maxHandoffMicros) {
+        flushStats.maxHandoffMicros = elapsed;
+    }
+}
+
+void waitDisplayFlush() {
+    portENTER_CRITICAL(&frameMux);
+    bool busy = flushBusy;
+    if (busy) {
+        flushWaiter = xTaskGetCurrentTaskHandle();
+    }
+    portEXIT_CRITICAL(&frameMux);
+    while (busy) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        busy = flushBusy;  // A notification left over from an earlier wait: block again
+    }
+}
+
+// Function to print what the flushes cost the bus and the loop, as CSV
+void printDisplayFlushReport(Print& out) {
+    out.printf("display,clock_hz,%u,frames,%u,superseded,%u\n", (unsigned)DISPLAY_I2C_CLOCK_HZ,
+               (unsigned)flushStats.frames, (unsigned)flushStats.superseded);
+    out.printf("frame,mean_us,%u,mean_bytes,%u,last_us,%u,last_bytes,%u\n",
+               (unsigned)(flushStats.frames > 0 ? flushStats.totalMicros / flushStats.frames : 0),
+               (unsigned)(flushStats.frames > 0 ? flushStats.totalBytes / flushStats.frames : 0),
+               (unsigned)flushStats.lastFrameMicros, (unsigned)flushStats.lastFrameBytes);
+    out.printf("handoff,mean_us,%u,max_us,%u\n",
+               (unsigned)(flushStats.handoffs > 0 ? flushStats.totalHandoffMicros / flushStats.handoffs : 0),
+               (unsigned)flushStats.maxHandoffMicros);
+}
@@ -0,0 +1,59 @@
+// display_flush.h
+#ifndef DISPLAY_FLUSH_H
+#define DISPLAY_FLUSH_H
+
+#include <Adafruit_SSD1306.h>
+#include <Wire.h>
+
+#define DISPLAY_PAGES 8
+#define DISPLAY_COLUMNS 128
+#define DISPLAY_FRAME_SIZE (DISPLAY_PAGES * DISPLAY_COLUMNS)
+#define DISPLAY_I2C_CHUNK 64  // Data bytes per I2C transaction (Wire buffer is 128)
+
+// Fast mode. The SSD1306 and the DS3231 on the same bus are both rated to
+// 400 kHz; build with -DDISPLAY_I2C_CLOCK_HZ=100000 to compare standard mode.
+#ifndef DISPLAY_I2C_CLOCK_HZ
+#define DISPLAY_I2C_CLOCK_HZ 400000UL
+#endif
+
+// The flush task sits above the loop task on its core, so a handed-off frame
+// starts at once; while the I2C driver waits on the bus the loop runs again.
+#define DISPLAY_FLUSH_TASK_STACK 2048
+#define DISPLAY_FLUSH_TASK_PRIORITY 2
+#define DISPLAY_FLUSH_TASK_CORE 1
+
+struct DisplayFlushStats {
+    uint32_t frames;           // Flushes performed
+    uint32_t lastFrameBytes;   // I2C payload bytes sent by the last flush
+    uint32_t lastFrameMicros;  // Time spent in the last flush
+    uint32_t lastDirtyPages;   // Pages touched by the last flush
+    uint64_t totalBytes;       // Payload bytes since boot
+    uint64_t totalMicros;
+    uint32_t handoffs;         // Frames handed over by flushDisplay()
+    uint32_t superseded;       // Handed-off frames replaced by a newer one before being sent
+    uint32_t maxHandoffMicros; // Longest the caller was held up by flushDisplay()
+    uint64_t totalHandoffMicros;
+};
+
+// Run the bus at DISPLAY_I2C_CLOCK_HZ and start the flush task. Construct the
+// display with the same clock as clkAfter, or each command drops it back.
+void beginDisplayFlush(Adafruit_SSD1306* display, TwoWire* wire, uint8_t address);
+
+// Copy the framebuffer for the flush task and return; the task pushes only the
+// bytes that changed since the last flush, page by page. A frame still waiting
+// when the next one arrives is dropped. Without the task, flushes in place.
+void flushDisplay();
+
+// Block until the panel shows the last frame handed over (before sleeping, or
+// to read the statistics). Sleeps on a task notification from the flush task;
+// call from the task that draws, one waiter at a time.
+void waitDisplayFlush();
+
+// Force the next flush to resend the whole framebuffer
+void invalidateDisplay();
+
+// Updated by the flush task; call waitDisplayFlush() first for settled numbers
+const DisplayFlushStats& displayFlushStats();
+void printDisplayFlushReport(Print& out);
+
+#endif
@@ -0,0 +1,50 @@
+// event_scheduler.cpp
+#include "event_scheduler.h"
+
+static void addEvent(EventQueue& queue, int minute, uint8_t prayer, AlertKind kind, uint32_t firedMask) {
+    if (minute < 0 || queue.count >= MAX_SCHEDULED_EVENTS || (firedMask & eventBit(kind, prayer))) {
+        return;
+    }
+
+    // Insertion sort keeps the queue ordered; ties keep insertion order
+    int i = queue.count++;
+    while (i > 0 && queue.events[i - 1].minute > minute) {
+        queue.events[i] = queue.events[i - 1];
+        i--;
+    }
+    queue.events[i].minute = minute;
+    queue.events[i].prayer = prayer;
+    queue.events[i].kind = kind;
+}
+
+void clearEventQueue(EventQueue& queue, uint8_t day) {
+    queue.count = 0;
+    queue.head = 0;
+    queue.day = day;
+}
+
+void buildEventQueue(EventQueue& queue, const PrayerTimes& times, uint8_t day, int currentMinute, uint32_t firedMask) {
+    clearEventQueue(queue, day);
+
+    for (int i = 0; i < MAIN_TIMING_COUNT; i++) {
+        int prayerMinute = times.minutes[i];
+        if (prayerMinute < 0) {
+            continue;
+        }
+        // No reminder for Sunrise and Dhuhr, and Sunrise is not a prayer
+        if (i != PRAYER_SUNRISE && i != PRAYER_DHUHR) {
+            addEvent(queue, prayerMinute - REMINDER_LEAD_MINUTES, i, ALERT_REMINDER, firedMask);
+        }
+        if (i != PRAYER_SUNRISE) {
+            addEvent(queue, prayerMinute, i, ALERT_PRAYER, firedMask);
+        }
+    }
+
+    if (times.minutes[PRAYER_SUNRISE] >= 0) {
+        addEvent(queue, times.minutes[PRAYER_SUNRISE] - REMINDER_LEAD_MINUTES, PRAYER_FAJR, ALERT_FAJR_ENDING, firedMask);
+    }
+
+    while (queue.head < queue.count && queue.events[queue.head].minute < currentMinute) {
+        queue.head++;
+    }
+}
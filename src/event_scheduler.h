@@ -0,0 +1,57 @@
+// event_scheduler.h
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include <stdint.h>
+#include "prayer_times.h"
+
+#define REMINDER_LEAD_MINUTES 10
+#define MAX_SCHEDULED_EVENTS 16
+
+enum AlertKind : uint8_t {
+    ALERT_REMINDER,     // Ten minutes before a prayer
+    ALERT_PRAYER,       // At the prayer time
+    ALERT_FAJR_ENDING   // Ten minutes before sunrise
+};
+
+struct ScheduledEvent {
+    uint16_t minute;    // Minutes since midnight
+    uint8_t prayer;     // Index into mainTimingNames
+    AlertKind kind;
+};
+
+// Today's alerts sorted by time; head is the next one to fire
+struct EventQueue {
+    ScheduledEvent events[MAX_SCHEDULED_EVENTS];
+    uint8_t count;
+    uint8_t head;
+    uint8_t day;        // Day of month the queue was built for
+};
+
+// Bit of an event in the firedMask passed to buildEventQueue
+inline uint32_t eventBit(AlertKind kind, uint8_t prayer) {
+    return 1UL << (kind * MAIN_TIMING_COUNT + prayer);
+}
+
+// Compile the day's alerts. Events before currentMinute are skipped, and so are
+// events in firedMask, which have already gone off when the queue is rebuilt.
+void buildEventQueue(EventQueue& queue, const PrayerTimes& times, uint8_t day, int currentMinute,
+                     uint32_t firedMask = 0);
+
+void clearEventQueue(EventQueue& queue, uint8_t day);
+
+// Pop the head if it is due; a single comparison when nothing is
+inline bool popDueEvent(EventQueue& queue, int currentMinute, ScheduledEvent& event) {
+    if (queue.head >= queue.count || queue.events[queue.head].minute > currentMinute) {
+        return false;
+    }
+    event = queue.events[queue.head++];
+    return true;
+}
+
+// Minutes since midnight of the next pending event, -1 if none remain today
+inline int nextEventTime(const EventQueue& queue) {
+    return queue.head < queue.count ? queue.events[queue.head].minute : -1;
+}
+
+#endif
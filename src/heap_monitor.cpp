@@ -0,0 +1,65 @@
+// heap_monitor.cpp
+#include <Arduino.h>
+#include "heap_monitor.h"
+
+#ifdef HEAP_ALLOC_COUNTING
+// Allocation hooks, enabled with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+static uint32_t allocationCount = 0;
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+}
+
+uint32_t heapAllocationCount() {
+    return __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+}
+#else
+uint32_t heapAllocationCount() {
+    return 0;
+}
+#endif
+
+static HeapSample heapSample = {0, 0, 0, 0};
+static unsigned long lastSampleMillis = 0;
+static uint32_t lastAllocationCount = 0;
+static bool sampledOnce = false;
+
+void updateHeapMonitor(unsigned long nowMillis) {
+    if (sampledOnce && nowMillis - lastSampleMillis < HEAP_SAMPLE_INTERVAL_MS) {
+        return;
+    }
+    lastSampleMillis = nowMillis;
+    sampledOnce = true;
+
+    uint32_t allocations = heapAllocationCount();
+    heapSample.freeHeap = ESP.getFreeHeap();
+    heapSample.largestBlock = ESP.getMaxAllocHeap();
+    heapSample.minFreeHeap = ESP.getMinFreeHeap();
+    heapSample.allocations = allocations - lastAllocationCount;
+    lastAllocationCount = allocations;
+
+    Serial.printf("Heap: free=%u largest=%u min=%u allocs/h=%u\n",
+                  (unsigned)heapSample.freeHeap, (unsigned)heapSample.largestBlock,
+                  (unsigned)heapSample.minFreeHeap, (unsigned)heapSample.allocations);
+}
+
+const HeapSample& lastHeapSample() {
+    return heapSample;
+}
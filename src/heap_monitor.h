@@ -0,0 +1,24 @@
+// heap_monitor.h
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <stdint.h>
+
+#define HEAP_SAMPLE_INTERVAL_MS 3600000UL  // Log once per hour
+
+struct HeapSample {
+    uint32_t freeHeap;
+    uint32_t largestBlock;     // Largest single allocation possible
+    uint32_t minFreeHeap;      // Low-water mark since boot
+    uint32_t allocations;      // Heap allocations during the last interval
+};
+
+// Sample the heap once per interval and log it over Serial
+void updateHeapMonitor(unsigned long nowMillis);
+
+const HeapSample& lastHeapSample();
+
+// Total heap allocations since boot; 0 unless built with HEAP_ALLOC_COUNTING
+uint32_t heapAllocationCount();
+
+#endif
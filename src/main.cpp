@@ -3,33 +3,74 @@
 #include <Adafruit_SSD1306.h>
 #include <WiFi.h>
 #include <HTTPClient.h>
-#include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include <time.h>  // Include the time library
 #include <RTClib.h>  // Add the RTClib library for RTC
 #include "constants.h"
+#include "prayer_times.h"
+#include "schedule_store.h"
+#include "event_scheduler.h"
+#include "heap_monitor.h"
+#include "display_flush.h"
+#include "alert_player.h"
+#include "audio_player.h"
+#include "network_task.h"
+#include "counting_stream.h"
+#include "chunked_stream.h"
+#include "config_cache.h"
+#include "soft_clock.h"
+#include "button_gestures.h"
+#include "power_manager.h"
+#include "telemetry.h"
+#include "clock_sync.h"
+#include "tls_client.h"
+#include "digit_font.h"
+#include "table_layer.h"
+#include "provisioning.h"
+#include "status_server.h"
+#include <atomic>
 #include <Preferences.h>  
 
+// Unit tests (pio test) bring their own setup() and loop(), or main() on the PC, and start
+// the firmware through these when they need it running
+#ifdef PIO_UNIT_TESTING
+#define setup firmwareSetup
+#define loop firmwareLoop
+#endif
+
 
 // Create an RTC object
 RTC_DS3231 rtc;
-
-String apiUrl;
+#define RTC_SQW_PIN 4  // DS3231 SQW output, ticks the in-RAM clock once per second
 
 // OLED display settings
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define SSD1306_I2C_ADDRESS  0x3C
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1, DISPLAY_I2C_CLOCK_HZ, DISPLAY_I2C_CLOCK_HZ);
+
+// Names of the main and other timings; values live in todayTimes as minutes since midnight
+constexpr const char* mainTimingNames[MAIN_TIMING_COUNT] = {"Fajr", "Sunrise", "Dhuhr", "Asr", "Maghrib", "Isha"};
+constexpr const char* otherTimingNames[OTHER_TIMING_COUNT] = {"Sunset", "Imsak", "Midnight", "1/3rd", "2/3rd"};
 
-// Arrays to hold main and other timings
-String mainTimingNames[] = {"Fajr", "Sunrise", "Dhuhr", "Asr", "Maghrib", "Isha"};
-String mainTimingValues[6];
+#define TIME_TEXT_SIZE 9  // "12:59 PM" plus terminator
 
-String otherTimingNames[] = {"Sunset", "Imsak", "Midnight", "1/3rd", "2/3rd"};
-String otherTimingValues[5];
+char hijriDate[HIJRI_DATE_SIZE] = "";  // DD-MM-YYYY, published with the schedule by an API fetch
 
-String city = "";
+// Aladhan timing keys in PrayerTimeIndex order
+constexpr const char* aladhanTimingKeys[PRAYER_TIME_COUNT] = {"Fajr", "Sunrise", "Dhuhr", "Asr", "Maghrib", "Isha",
+                                                              "Sunset", "Imsak", "Midnight", "Firstthird", "Lastthird"};
+#define SCHEDULE_MIN_FETCH_DAYS 7   // Also fetch next month when fewer days than this remain
+#define SCHEDULE_REFILL_DAYS 3      // Refresh in the background when the stored window gets this short
+#define PROVISION_MAX_DISTANCE_DEG 0.5  // Ignore a provisioned schedule made for somewhere further away
+
+// Packed schedule blob, loaded with a single NVS read
+alignas(4) uint8_t scheduleBlob[scheduleBlobSize(SCHEDULE_DAYS)];
+size_t scheduleSize = 0;
+PrayerTimes todayTimes;  // Today's row, minutes since midnight
+bool scheduleLoaded = false;  // todayTimes holds a valid row
+ScheduleHeader storedScheduleHeader = {};  // Header of the blob currently in NVS
+EventQueue eventQueue;  // Today's reminders and prayer alerts, compiled when the schedule loads
 
 bool showMainTimings = false;  // Toggle between screens
 bool showOtherTimings = false;  // Toggle between screens
@@ -39,18 +80,20 @@ bool changePressed = false;
 bool dontChange = false;
 bool alwaysConnectWifi = false;
 
-bool fetchingAzanTimes = true;  // Flag to indicate fetching state
-unsigned long previousMillis = 0;
-const long interval = 1000;  // 1 seconds interval for switching screens
+volatile bool fetchingAzanTimes = false;  // Flag to indicate fetching state
+volatile int8_t lastFetchResult = -1;  // Last schedule refresh: -1 none yet, 0 failed, 1 succeeded
+volatile uint32_t lastFetchMillis = 0;
 int dotCount = 0;  // Number of dots for animation
 
 // NTP settings
 const char* ntpServer = "time.google.com";
 const long gmtOffsetSec = 19800;  // GMT offset for IST (in seconds)
 const int daylightOffsetSec = 0;  // No daylight savings in India
-// Define a time interval for NTP synchronization (e.g., every 60 seconds)
-unsigned long previousNtpSyncMillis = 0;
-const long ntpSyncInterval = 60000; // 60 seconds
+// NTP syncs are scheduled by clock_sync from the RTC's measured drift
+
+// Prayer time calculation settings
+bool calculateOnDevice = true;  // Compute Azan times locally instead of calling the Aladhan API
+const int calculationMethod = 16;  // Aladhan method id (16 = Dubai)
 
 // Buzzer pin
 const int BUZZER_PIN = 32; // Replace with your buzzer pin
@@ -61,59 +104,99 @@ bool azanTimesUpdated = false;
 
 bool prayerTimeTriggered[6] = {false, false, false, false, false, false};  // Flags for each main prayer time
 bool remiderTimeTriggered[6] = {false, false, false, false, false, false};  // Flags for each main prayer time
+bool fajrEndingTriggered = false;  // The "Fajr ending soon" alert before sunrise
 
 Preferences preferences;
 
-unsigned long lastButtonPress = 0;
-unsigned long debounceDelay = 50;  // Debounce delay in milliseconds
-unsigned long patternTimeout = 1000;  // Max time to detect multiple presses
-int buttonPressCount = 0;
 #define BUTTON_PIN 0  // BOOT button pin (GPIO0 on ESP32)
-
-String latitude = "";
-String longitude = "";
+// Debounce, max gap between multiple presses, long press and press-and-hold, in milliseconds
+const ButtonGestureConfig buttonConfig = {50, 1000, 1000, 5000};
+unsigned long lastUserActivityMillis = 0;
+
+// Overnight mode: from a while after Isha until just before the Fajr reminder
+// the OLED is switched off and the chip light-sleeps between checks
+#define OVERNIGHT_START_AFTER_ISHA 30       // Minutes after Isha
+#define OVERNIGHT_WAKE_LEAD 2               // Minutes before the Fajr reminder
+#define OVERNIGHT_MAX_SLEEP_MINUTES 30      // Wake at least this often
+#define OVERNIGHT_AWAKE_AFTER_BUTTON_MS 60000UL
+#define SCHEDULE_REFRESH_MINUTE 61          // 01:01, see checkForMidnightUpdate()
+
+// Coordinates the schedule is calculated or fetched for. Network task only; the loop shows the
+// cached city and never reads them.
+struct Coordinates {
+    bool known;
+    double latitude;
+    double longitude;
+};
+Coordinates coordinates = {false, 0, 0};
 
 // Function declarations
 // Declare the syncTimeFromNTP function before using it in loop()
-void syncTimeFromNTP();
+bool syncTimeFromNTP(const NetworkRequest& request);
 void connectToWiFi();
 // void initializeTime();
-void fetchAzanTimes();
+bool fetchAzanTimes(const NetworkRequest& request);
+bool calculateAzanTimes(const NetworkRequest& request, uint8_t* blob, size_t capacity, size_t& size);
+bool loadProvisionedSchedule(const NetworkRequest& request, uint8_t* blob, size_t capacity, size_t& size);
+void requestNetwork(NetworkRequestType type);
+bool handleNetworkRequest(const NetworkRequest& request);
+void onNetworkRequestDone(const NetworkRequest& request, bool success);
+void applyNetworkResults();
+void handleSerialCommands();
 void displayTimings();
 void displayOtherTimings();
 void displayLargeTime();
 void showWelcomeMessage();
 // void showConnectingMessage();
 void displayFetchingAnimation();
-String getFormattedDate();
-String convertTo12HourFormat(const String &time24);
-void soundBuzzer(String prayerTime, String prayerName, String flag); // Function to sound the buzzer
+void getFormattedDate(char* dateBuffer, size_t size);
+void formatMinutesAs12Hour(int minutes, char* out, size_t size);
+void soundBuzzer(const char* prayerTime, const char* prayerName, const char* flag); // Function to sound the buzzer
+void drawAlertFrame(const char* prayerTime, const char* prayerName, bool on);
 void checkAndTriggerBuzzer(); // Function to check time and trigger buzzer
-int getXPos(String text);
+int getXPos(const char* text);
 int getYPos();
 void readAzanTimesFromEEPROM();
-void writeAzanTimesFromEEPROM();
+void writeAzanTimesToEEPROM();
+bool loadTodayFromSchedule();
+void resetTriggeredFlags();
+int scheduleDaysRemaining();
+int parseTime24(const char* time24);
+bool fetchAzanCalendar(HTTPClient& https, TlsSessionClient& client, int year, int month, int firstDay,
+                       PrayerTimes* days, int& dayCount, char* hijri);
+int parseAzanCalendar(Stream& stream, int firstDay, PrayerTimes* days, int& dayCount, char* hijri);
 void checkForMidnightUpdate();
 void clearPreferences();
-void getGeoLocation();
+bool resolveLocation();
+bool storedLocationFresh();
+bool getGeoLocation(const String& publicIP);
 String getPublicIP();
-void dynamicMessage(String msg1, String msg2 = "");
+void dynamicMessage(const char* msg1, const char* msg2 = "");
 bool initializeRTC(int maxRetries, int retryDelayMs);
 void handleButtonPress();
 void whenToBuzzer();
-void changeScreen();
+void handleButtonGesture(const ButtonGesture& gesture);
+bool inOvernightWindow(int minute);
+void updateOvernightMode(unsigned long nowMillis);
 void updateDisplay();
 void toggleScreens();
+bool writeStatusPage(StatusBody& body);
+void writeScheduleTimes(StatusBody& body, const PrayerTimes& times);
+bool writeSchedulePage(StatusBody& body);
 
 void setup() {
     Serial.begin(115200);
 
+    // Settings are read from NVS once here and served from RAM afterwards
+    loadConfigCache();
+
     // clearPreferences();
     // Initialize OLED display
     if (!display.begin(SSD1306_I2C_ADDRESS, 0x3C)) {  // Use 0x3C as the I2C address
         Serial.println("SSD1306 allocation failed");
         while (true); // Loop forever
     }
+    beginDisplayFlush(&display, &Wire, SSD1306_I2C_ADDRESS);
     // display.clearDisplay();
     // display.display();
 
@@ -122,17 +205,22 @@ void setup() {
         Serial.println("RTC failed to initialize. Check connections or replace RTC module.");
         while (1);
     }
+    beginSoftClock(&rtc, RTC_SQW_PIN);
+    beginClockSync(&rtc, gmtOffsetSec, daylightOffsetSec);
+    beginPowerManager(&display);
 
 
     // Set the buzzer pin mode
     pinMode(BUZZER_PIN, OUTPUT);
 
-    // Initialize button pin
-    pinMode(BUTTON_PIN, INPUT_PULLUP);
+    // Initialize button pin; presses are captured by interrupt even while loop() is busy
+    beginButtonGestures(BUTTON_PIN, buttonConfig);
 
     // Configure the LEDC to generate a PWM signal for the buzzer
     ledcSetup(BUZZER_CHANNEL, 2000, 8); // 2000 Hz frequency, 8-bit resolution
     ledcAttachPin(BUZZER_PIN, BUZZER_CHANNEL); // Attach the pin to the channel
+    beginAlertPlayer(BUZZER_CHANNEL, drawAlertFrame);
+    beginAudioPlayer();  // Azan and reminder clips from LittleFS; the buzzer stands in without them
     
     // noTone(BUZZER_PIN);
 
@@ -140,51 +228,69 @@ void setup() {
     showWelcomeMessage();
     delay(1000);  // Show for 2 seconds
 
-    if(alwaysConnectWifi){
+    if(alwaysConnectWifi || STATUS_SERVER){
         connectToWiFi();
     }
 
-    // Check if the RTC lost power and set the time
+    // Answered from loop(); starts listening once Wi-Fi is up
+    if (STATUS_SERVER) {
+        beginStatusServer(STATUS_SERVER_PORT);
+        setStatusPageWriter(STATUS_PAGE_STATUS, writeStatusPage, true);
+        setStatusPageWriter(STATUS_PAGE_SCHEDULE, writeSchedulePage, false);
+    }
+
+    // Wi-Fi and fetches run on core 0 from here on
+    if (!startNetworkTask(handleNetworkRequest, onNetworkRequestDone)) {
+        Serial.println("Failed to start the network task.");
+    }
+
+    // Check if the RTC lost power; clock sync then fetches the time on the first tick
     if (rtc.lostPower()) {
         Serial.println("RTC lost power, setting the time!");
-        syncTimeFromNTP();
     }
 
 
     // Read stored Azan times from EEPROM
     readAzanTimesFromEEPROM();
-
 }
 
 void loop() {
+    telemetryLoopBegin();
 
-    int buzzerState = digitalRead(BUZZER_PIN);
+    checkForMidnightUpdate();
 
-    DateTime now = rtc.now();
-    String currentTime = String(now.hour()) + ":" + (now.minute() < 10 ? "0" : "") + String(now.minute());
+    applyNetworkResults();
 
-    checkForMidnightUpdate();
+    // Sets the RTC on the whole second once an SNTP answer is in
+    updateClockSync();
 
-    static int lastButtonState = HIGH;
-    int buttonState = digitalRead(BUTTON_PIN);
+    updateAlertPlayer(millis());
 
-    // Detect button press (active LOW)
-    if (buttonState == LOW && lastButtonState == HIGH && (millis() - lastButtonPress) > debounceDelay) {
-        lastButtonPress = millis();
-        buttonPressCount++;
-        Serial.printf("Button pressed! Count: %d\n", buttonPressCount);
+    // Act on button gestures as soon as they are decoded
+    ButtonGesture gesture;
+    while (nextButtonGesture(millis(), gesture)) {
+        handleButtonGesture(gesture);
     }
-    lastButtonState = buttonState;
 
 
     unsigned long currentMillis = millis();
 
 
-    if (currentMillis - previousMillis >= interval) {
-        previousMillis = currentMillis;
+    // Runs once per second, on the RTC's second edge
+    if (updateSoftClock(currentMillis)) {
 
-        // Show the appropriate screen
-        if(autoChange){
+        // Show the appropriate screen; an active alert owns the display
+        uint32_t renderStart = telemetryStart();
+        bool rendered = true;
+        if(alertActive()){
+            // Frames are drawn by the alert player
+            rendered = false;
+        }else if(!displayPowered()){
+            // Nothing to draw while the panel is off overnight
+            rendered = false;
+        }else if(fetchingAzanTimes && !scheduleLoaded){
+            displayFetchingAnimation();
+        }else if(autoChange){
 
             // Toggle between screens
             toggleScreens();
@@ -193,15 +299,31 @@ void loop() {
 
         }else if(!dontChange){
             displayLargeTime();
+        }else{
+            rendered = false;
+        }
+        if (rendered) {
+            telemetryRecord(TELEMETRY_RENDER, renderStart);
         }
-
-        // Check for timeout between presses
-        changeScreen();
 
         // soundBuzzer();
 
         whenToBuzzer();
 
+        updateHeapMonitor(currentMillis);
+
+        sampleTelemetryGauges();
+
+        flushConfigCache(currentMillis);
+
+        // Resync when the drift estimate says the RTC may be near the target error
+        uint32_t rtcNow = softClockNow().unixtime();
+        if (clockSyncDue(rtcNow)) {
+            markClockSyncRequested(rtcNow);
+            requestNetwork(NETWORK_SYNC_TIME);
+        }
+
+        updateOvernightMode(currentMillis);
     }
 
     // Handle manual button press
@@ -209,7 +331,13 @@ void loop() {
         handleButtonPress();
     }
 
-    
+    // Single-letter commands on the serial console
+    handleSerialCommands();
+
+    // HTTP status clients; returns at once when none are waiting
+    serviceStatusServer(millis());
+
+    telemetryLoopEnd();
 }
 
 void updateDisplay() {
@@ -245,30 +373,63 @@ void handleButtonPress() {
     changePressed = false;  // Reset the change flag
 }
 
-void changeScreen(){
-    if (millis() - lastButtonPress > patternTimeout && buttonPressCount > 0) {
-            
-            if (buttonPressCount == 1) {
-                dynamicMessage("Changing screen");
-                handleButtonPress();
-                dontChange = true;
-
-            } else if (buttonPressCount == 2) {
-                dynamicMessage("Fetching Azan Times");
-                
-                fetchAzanTimes();
-            } else if (buttonPressCount == 3) {
-                dynamicMessage("Clearing Wifi", "Preferences");
-                clearPreferences();
-            } else if (buttonPressCount == 4){
-                dynamicMessage("Fetching current time", "from NTP");
-                syncTimeFromNTP();
-            }else {
-                dynamicMessage("Invalid Button");
-                Serial.println("Invalid button press pattern.");
-            }
-            buttonPressCount = 0;  // Reset the counter
+// Function to act on a decoded button gesture
+void handleButtonGesture(const ButtonGesture& gesture) {
+    static bool pressCancelledAlert = false;
+
+    lastUserActivityMillis = millis();
+
+    if (gesture.type == GESTURE_DOWN) {
+        // A gesture that starts during an alert silences it instead of counting
+        if (gesture.count == 1 && alertActive()) {
+            pressCancelledAlert = true;
+            cancelAlert();
+            Serial.println("Alert cancelled by button.");
+        } else if (gesture.count == 1 && !displayPowered()) {
+            // Overnight, the first press only wakes the screen
+            pressCancelledAlert = true;
+            setDisplayPower(true);
+        } else {
+            Serial.printf("Button pressed! Count: %d\n", gesture.count);
         }
+        return;
+    }
+
+    if (pressCancelledAlert) {
+        pressCancelledAlert = false;
+        return;
+    }
+
+    if (gesture.type == GESTURE_LONG_PRESS) {
+        dynamicMessage("Showing clock");
+        showLargeTime = true;
+        showMainTimings = false;
+        showOtherTimings = false;
+        dontChange = false;
+        return;
+    } else if (gesture.type == GESTURE_HOLD) {
+        dynamicMessage("Fetching current time", "from NTP");
+        requestNetwork(NETWORK_SYNC_TIME);
+        return;
+    }
+
+    if (gesture.count == 1) {
+        dynamicMessage("Changing screen");
+        handleButtonPress();
+        dontChange = true;
+    } else if (gesture.count == 2) {
+        dynamicMessage("Fetching Azan Times");
+        requestNetwork(NETWORK_REFRESH_SCHEDULE);
+    } else if (gesture.count == 3) {
+        dynamicMessage("Clearing Wifi", "Preferences");
+        clearPreferences();
+    } else if (gesture.count == 4) {
+        dynamicMessage("Fetching current time", "from NTP");
+        requestNetwork(NETWORK_SYNC_TIME);
+    } else {
+        dynamicMessage("Invalid Button");
+        Serial.println("Invalid button press pattern.");
+    }
 }
 
 void whenToBuzzer(){
@@ -281,8 +442,7 @@ void whenToBuzzer(){
 
 
         // Get the current time
-        DateTime now = rtc.now();
-        String currentTime = String(now.hour()) + ":" + (now.minute() < 10 ? "0" : "") + String(now.minute());
+        DateTime now = softClockNow();
 
         int currentHour = now.hour();
         int currentMinute = now.minute();
@@ -293,58 +453,124 @@ void whenToBuzzer(){
         // Calculate the total minutes from midnight for the current time
         int currentTotalMinutes = currentHour * 60 + currentMinute;
 
-        // Check each main prayer time
-        for (int i = 0; i < 6; i++) {
-            int prayerHour, prayerMinute;
-            sscanf(mainTimingValues[i].c_str(), "%d:%d", &prayerHour, &prayerMinute);
-
-            // Convert prayerHour to 24-hour format if necessary
-            bool isPM = (mainTimingValues[i].endsWith("PM"));; // You may need to modify this if there's a way to check AM/PM
-            if (isPM && prayerHour < 12) {
-                prayerHour += 12; // Convert PM hours to 24-hour format
+        // Compile the new day's events once the date rolls over
+        if (now.day() != eventQueue.day) {
+            if (!loadTodayFromSchedule()) {
+                resetTriggeredFlags();
+                clearEventQueue(eventQueue, now.day());
             }
-            if (!isPM && prayerHour == 12) {
-                prayerHour = 0; // Convert 12:00 AM to 00:00 in 24-hour format
+            resetDailyFlashWrites();
+        }
+
+        // Fire every event that is due; usually a single comparison against the head
+        ScheduledEvent event;
+        while (popDueEvent(eventQueue, currentTotalMinutes, event)) {
+            int i = event.prayer;
+            char timeText[TIME_TEXT_SIZE];
+            if (event.kind == ALERT_REMINDER) {
+                Serial.printf("Reminder: %s is coming up!\n", mainTimingNames[i]);
+                formatMinutesAs12Hour(todayTimes.minutes[i], timeText, sizeof(timeText));
+                soundBuzzer("Reminder", timeText, "rem");  // Sound buzzer for the reminder
+                remiderTimeTriggered[i] = true;
+            } else if (event.kind == ALERT_PRAYER) {
+                Serial.printf("It's time for: %s\n", mainTimingNames[i]);
+                formatMinutesAs12Hour(todayTimes.minutes[i], timeText, sizeof(timeText));
+                soundBuzzer(mainTimingNames[i], timeText, "time");  // Sound buzzer for the prayer
+                prayerTimeTriggered[i] = true;  // Mark this prayer time as triggered
+            } else if (event.kind == ALERT_FAJR_ENDING) {
+                Serial.println("Reminder: Fajr is ending soon!");
+                formatMinutesAs12Hour(todayTimes.minutes[PRAYER_SUNRISE], timeText, sizeof(timeText));
+                soundBuzzer("Fajr Ending Soon", timeText, "rem");  // Sound buzzer for Fajr reminder
+                fajrEndingTriggered = true;
             }
+            invalidateStatusPage(STATUS_PAGE_SCHEDULE);
+        }
+}
 
+// Function to clear the day's alert flags; the queue is rebuilt for a new day right after
+void resetTriggeredFlags() {
+    memset(prayerTimeTriggered, false, sizeof(prayerTimeTriggered));
+    memset(remiderTimeTriggered, false, sizeof(remiderTimeTriggered));
+    fajrEndingTriggered = false;
+    invalidateStatusPage(STATUS_PAGE_SCHEDULE);
+}
 
-            // Serial.println("Prayer Time: " + String(prayerHour) + ":"+ String(prayerMinute) + " & current time: "+ String(currentHour) + ":" + String(currentMinute) + "prayertimetriggered:" + prayerTimeTriggered[i]);
+// Function to collect the alerts that have already gone off today, so a rebuilt queue skips them
+uint32_t firedEventMask() {
+    uint32_t mask = fajrEndingTriggered ? eventBit(ALERT_FAJR_ENDING, PRAYER_FAJR) : 0;
+    for (int i = 0; i < MAIN_TIMING_COUNT; i++) {
+        if (remiderTimeTriggered[i]) {
+            mask |= eventBit(ALERT_REMINDER, i);
+        }
+        if (prayerTimeTriggered[i]) {
+            mask |= eventBit(ALERT_PRAYER, i);
+        }
+    }
+    return mask;
+}
 
-            int prayerTotalMinutes = prayerHour * 60 + prayerMinute;
+// True between OVERNIGHT_START_AFTER_ISHA after Isha and just before the Fajr reminder
+bool inOvernightWindow(int minute) {
+    if (!scheduleLoaded || todayTimes.minutes[PRAYER_ISHA] < 0 || todayTimes.minutes[PRAYER_FAJR] < 0) {
+        return false;
+    }
+    int start = todayTimes.minutes[PRAYER_ISHA] + OVERNIGHT_START_AFTER_ISHA;
+    int end = todayTimes.minutes[PRAYER_FAJR] - REMINDER_LEAD_MINUTES - OVERNIGHT_WAKE_LEAD;
+    return minute >= start || minute < end;
+}
 
-            // Reminder 10 minutes before the next prayer time
-            if (currentTotalMinutes == prayerTotalMinutes - 10 && !remiderTimeTriggered[i] && (i != 1 && i != 2)) {
-                Serial.println("Reminder: " + mainTimingNames[i] + " is coming up!");
-                soundBuzzer("Reminder", mainTimingValues[i], "rem");  // Sound buzzer for the reminder
-                remiderTimeTriggered[i] = true;
-            }
+// Switch the OLED off overnight and light-sleep until the next thing that needs the CPU
+void updateOvernightMode(unsigned long nowMillis) {
+    static bool overnight = false;
 
-            // Special case: Check for the exact prayer time
-            if (currentTotalMinutes == prayerTotalMinutes && !prayerTimeTriggered[i] && i != 1) {
-                Serial.println("It's time for: " + mainTimingNames[i]);
-                soundBuzzer(mainTimingNames[i], mainTimingValues[i], "time");  // Sound buzzer for the prayer
-                prayerTimeTriggered[i] = true;  // Mark this prayer time as triggered
-            }
+    DateTime now = softClockNow();
+    int minute = now.hour() * 60 + now.minute();
 
-            // Special consideration for Fajr: Use sunrise time for the reminder
-            if (i == 0) {  // Fajr is the first prayer
-                int sunriseHour, sunriseMinute;
-                sscanf(mainTimingValues[1].c_str(), "%d:%d", &sunriseHour, &sunriseMinute);
-                int sunriseTotalMinutes = sunriseHour * 60 + sunriseMinute;
-
-                if (currentTotalMinutes == sunriseTotalMinutes - 10 && !remiderTimeTriggered[i]) {
-                    Serial.println("Reminder: Fajr is ending soon!");
-                    soundBuzzer("Fajr Ending Soon", mainTimingValues[1], "rem");  // Sound buzzer for Fajr reminder
-                    remiderTimeTriggered[i] = true;
-                }
-            }
+    if (!inOvernightWindow(minute)) {
+        if (overnight) {
+            overnight = false;
+            setDisplayPower(true);
+            Serial.println("Leaving overnight mode.");
+            printPowerReport();
         }
+        return;
+    }
 
-        // Reset the flags at midnight (00:00) to allow buzzing for the next day's prayer times
-        if (currentHour == 0 && currentMinute == 0) {
-            memset(prayerTimeTriggered, false, sizeof(prayerTimeTriggered));
-            memset(remiderTimeTriggered, false, sizeof(remiderTimeTriggered));
-        }
+    // Stay up for a while after the button is used or while an alert plays
+    if (alertActive() || nowMillis - lastUserActivityMillis < OVERNIGHT_AWAKE_AFTER_BUTTON_MS) {
+        setDisplayPower(true);
+        return;
+    }
+
+    if (!overnight) {
+        overnight = true;
+        Serial.println("Entering overnight mode.");
+    }
+    setDisplayPower(false);
+
+    // The status server has to stay reachable, so the chip only sleeps without it
+    if (STATUS_SERVER || networkBusy() || fetchingAzanTimes || buttonGesturePending() || clockSyncPending()) {
+        return;
+    }
+
+    // Wake for the morning reminder, the day rollover and the 01:01 schedule check
+    int end = todayTimes.minutes[PRAYER_FAJR] - REMINDER_LEAD_MINUTES - OVERNIGHT_WAKE_LEAD;
+    int wakeMinute = minute < end ? end : 24 * 60;
+    if (minute < SCHEDULE_REFRESH_MINUTE && wakeMinute > SCHEDULE_REFRESH_MINUTE) {
+        wakeMinute = SCHEDULE_REFRESH_MINUTE;
+    }
+    if (wakeMinute > minute + OVERNIGHT_MAX_SLEEP_MINUTES) {
+        wakeMinute = minute + OVERNIGHT_MAX_SLEEP_MINUTES;
+    }
+
+    long seconds = (long)(wakeMinute - minute) * 60 - now.second();
+    if (seconds < 60) {
+        return;
+    }
+    if (lightSleepFor(seconds)) {
+        lastUserActivityMillis = millis();
+    }
+    requestSoftClockResync();  // SQW edges were not counted while asleep
 }
 
 // Function to initialize the RTC with retry logic
@@ -362,18 +588,214 @@ bool initializeRTC(int maxRetries, int retryDelayMs) {
     return false;
 }
 
-// Function to sync time from NTP and update RTC
-void syncTimeFromNTP() {
-    connectToWiFi();
-    configTime(gmtOffsetSec, daylightOffsetSec, ntpServer);
-    struct tm timeInfo;
-    if (!getLocalTime(&timeInfo)) {
+// Function to get the time from NTP (network task); the RTC is updated from
+// the loop task in updateClockSync()
+bool syncTimeFromNTP(const NetworkRequest& request) {
+    if (WiFi.status() != WL_CONNECTED) {
+        connectToWiFi();
+    }
+    uint32_t syncStart = telemetryStart();
+    bool synced = runSntpSync(ntpServer);
+    telemetryRecord(TELEMETRY_NTP_SYNC, syncStart);
+    if (!synced) {
         Serial.println("Failed to obtain time");
+        return false;
+    }
+    Serial.println("Time synchronized successfully");
+    return true;
+}
+
+// Queue a network job for the current date
+void requestNetwork(NetworkRequestType type) {
+    DateTime now = softClockNow();
+    NetworkRequest request;
+    request.type = type;
+    request.year = now.year();
+    request.month = now.month();
+    request.day = now.day();
+
+    if (!queueNetworkRequest(request)) {
+        Serial.println("Network queue full, request dropped.");
+        return;
+    }
+    if (type == NETWORK_REFRESH_SCHEDULE) {
+        fetchingAzanTimes = true;
+    }
+}
+
+// Network task entry point for queued requests
+bool handleNetworkRequest(const NetworkRequest& request) {
+    unsigned long start = millis();
+    bool success = false;
+    if (request.type == NETWORK_REFRESH_SCHEDULE) {
+        success = fetchAzanTimes(request);
+    } else if (request.type == NETWORK_SYNC_TIME) {
+        success = syncTimeFromNTP(request);
+    }
+
+    // Count the time the radio was up and switch it off until the next request
+    if (WiFi.status() == WL_CONNECTED) {
+        networkStatsForUpdate().radioOnMs += millis() - start;
+        if (!alwaysConnectWifi && !STATUS_SERVER) {
+            WiFi.disconnect(true);
+            WiFi.mode(WIFI_OFF);
+        }
+    }
+    return success;
+}
+
+// Completion callback, runs on the network task
+void onNetworkRequestDone(const NetworkRequest& request, bool success) {
+    const NetworkStats& stats = networkStats();
+    Serial.printf("Network request %d %s (total: %u requests, radio on %u ms, %u bytes)\n",
+                  request.type, success ? "completed" : "failed", (unsigned)stats.requests,
+                  (unsigned)stats.radioOnMs, (unsigned)stats.bytesReceived);
+    if (request.type == NETWORK_REFRESH_SCHEDULE) {
+        lastFetchResult = success ? 1 : 0;
+        lastFetchMillis = millis();
+    }
+    if (request.type == NETWORK_REFRESH_SCHEDULE && !success) {
+        fetchingAzanTimes = false;
+    } else if (request.type == NETWORK_SYNC_TIME && !success) {
+        noteClockSyncFailed();
+    }
+}
+
+// Pick up results published by the network task (loop task only)
+void applyNetworkResults() {
+    if (takePublishedSchedule(scheduleBlob, sizeof(scheduleBlob), scheduleSize, hijriDate)) {
+        writeAzanTimesToEEPROM();
+        loadTodayFromSchedule();
+        fetchingAzanTimes = false; // Stop fetching animation
+        if (!alertActive()) {
+            displayTimings();
+        }
+    }
+}
+
+// Function to handle single-letter serial commands: 't' / 'b' / 'z' telemetry, 'c' clock sync report,
+// 's' TLS handshake report, 'g' location lookups this month, 'd' display flush report,
+// 'a' audio playback report
+void handleSerialCommands() {
+    while (Serial.available() > 0) {
+        int command = Serial.read();
+        if (command == 'c') {
+            printClockSyncReport(Serial);
+        } else if (command == 's') {
+            printTlsReport(Serial);
+        } else if (command == 'd') {
+            printDisplayFlushReport(Serial);
+        } else if (command == 'a') {
+            printAudioReport(Serial);
+        } else if (command == 'g') {
+            LocationLookupStats previous = previousLocationLookupStats();
+            if (previous.month != 0) {
+                Serial.printf("location,month,%u,made,%u,saved,%u\n", (unsigned)(previous.month % 12 + 1),
+                              (unsigned)previous.made, (unsigned)previous.saved);
+            }
+            LocationLookupStats lookups = locationLookupStats();
+            Serial.printf("location,month,%u,made,%u,saved,%u\n", (unsigned)(lookups.month % 12 + 1),
+                          (unsigned)lookups.made, (unsigned)lookups.saved);
+        } else {
+            handleTelemetryCommand(command, Serial);
+        }
+    }
+}
+
+// Function to write the /status page: clock and NTP state, the last schedule fetch and perf counters.
+// Times are local seconds since 1970, as kept by the RTC.
+bool writeStatusPage(StatusBody& body) {
+    DateTime now = softClockNow();
+    const ClockSyncStats& sync = clockSyncStats();
+    const NetworkStats& network = networkStats();
+    const StatusServerStats& server = statusServerStats();
+    TelemetryHistogram loopTimes = telemetryHistogram(TELEMETRY_LOOP);
+    TelemetryGauges gauges = telemetryGauges();
+    char cityName[CONFIG_CITY_SIZE];
+    copyCachedCity(cityName, sizeof(cityName));
+    int8_t fetchResult = lastFetchResult;
+
+    statusPrintf(body, "{\"uptime_ms\":%lu,\"time\":\"%04d-%02d-%02dT%02d:%02d:%02d\",\"city\":",
+                 (unsigned long)millis(), now.year(), now.month(), now.day(), now.hour(), now.minute(), now.second());
+    statusPrintString(body, cityName);
+    statusPrintf(body, ",\"rtc\":{\"sqw\":%s,\"set_since_power_loss\":%s,\"aging\":%d},",
+                 softClockUsingSqw() ? "true" : "false", sync.lastCorrection != 0 ? "true" : "false", sync.aging);
+    statusPrintf(body,
+                 "\"ntp\":{\"syncs\":%u,\"failures\":%u,\"last_correction\":%u,\"next_sync\":%u,\"interval_s\":%u,"
+                 "\"pending\":%s},",
+                 (unsigned)sync.syncs, (unsigned)sync.failures, (unsigned)sync.lastCorrection,
+                 (unsigned)sync.nextSyncTime, (unsigned)sync.intervalS, clockSyncPending() ? "true" : "false");
+    statusPrintf(body, "\"wifi\":{\"connected\":%s,\"rssi\":%d},", WiFi.status() == WL_CONNECTED ? "true" : "false",
+                 (int)WiFi.RSSI());
+    statusPrintf(body, "\"schedule\":{\"loaded\":%s,\"days_left\":%d,\"fetching\":%s,\"last_fetch\":\"%s\"",
+                 scheduleLoaded ? "true" : "false", scheduleDaysRemaining(), fetchingAzanTimes ? "true" : "false",
+                 fetchResult < 0 ? "none" : fetchResult > 0 ? "ok" : "failed");
+    if (fetchResult >= 0) {
+        statusPrintf(body, ",\"last_fetch_age_s\":%lu", (unsigned long)((millis() - lastFetchMillis) / 1000));
+    }
+    statusPrintf(body, "},\"network\":{\"requests\":%u,\"radio_on_ms\":%u,\"bytes_received\":%u},",
+                 (unsigned)network.requests, (unsigned)network.radioOnMs, (unsigned)network.bytesReceived);
+    statusPrintf(body, "\"loop\":{\"passes\":%u,\"mean_us\":%u,\"max_us\":%u,\"max_gap_us\":%u},",
+                 (unsigned)loopTimes.count,
+                 (unsigned)(loopTimes.count > 0 ? loopTimes.totalMicros / loopTimes.count : 0),
+                 (unsigned)loopTimes.maxMicros, (unsigned)gauges.maxLoopGapMicros);
+    statusPrintf(body, "\"heap\":{\"free\":%u,\"min_free\":%u,\"largest_block\":%u,\"allocations\":%u},",
+                 (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMinFreeHeap(), (unsigned)ESP.getMaxAllocHeap(),
+                 (unsigned)heapAllocationCount());
+    statusPrintf(body,
+                 "\"http\":{\"requests\":%u,\"errors\":%u,\"page_builds\":%u,\"max_build_us\":%u,"
+                 "\"max_pass_us\":%u,\"bytes_sent\":%llu}}",
+                 (unsigned)server.requests, (unsigned)server.errors, (unsigned)server.pageBuilds,
+                 (unsigned)server.maxBuildMicros, (unsigned)server.maxPassMicros,
+                 (unsigned long long)server.bytesSent);
+    return true;
+}
+
+// Function to write one day's timings as a JSON object keyed by the Aladhan names, HH:MM or null
+void writeScheduleTimes(StatusBody& body, const PrayerTimes& times) {
+    for (int i = 0; i < PRAYER_TIME_COUNT; i++) {
+        int minutes = times.minutes[i];
+        if (minutes < 0) {
+            statusPrintf(body, "%s\"%s\":null", i == 0 ? "{" : ",", aladhanTimingKeys[i]);
+        } else {
+            statusPrintf(body, "%s\"%s\":\"%02d:%02d\"", i == 0 ? "{" : ",", aladhanTimingKeys[i], minutes / 60,
+                         minutes % 60);
+        }
+    }
+    statusPrintf(body, "}");
+}
+
+// Function to write the /schedule page: today's and tomorrow's times and which alerts have gone off today.
+// Rebuilt only when the schedule loads or an alert fires.
+bool writeSchedulePage(StatusBody& body) {
+    if (!scheduleLoaded) {
+        statusPrintf(body, "{\"today\":null,\"tomorrow\":null}");
+        return true;
+    }
+
+    DateTime now = softClockNow();
+    statusPrintf(body, "{\"today\":{\"date\":\"%04d-%02d-%02d\",\"hijri\":", now.year(), now.month(), now.day());
+    statusPrintString(body, hijriDate);
+    statusPrintf(body, ",\"times\":");
+    writeScheduleTimes(body, todayTimes);
+    statusPrintf(body, ",\"triggered\":{");
+    for (int i = 0; i < MAIN_TIMING_COUNT; i++) {
+        statusPrintf(body, "%s\"%s\":{\"reminder\":%s,\"prayer\":%s}", i == 0 ? "" : ",", mainTimingNames[i],
+                     remiderTimeTriggered[i] ? "true" : "false", prayerTimeTriggered[i] ? "true" : "false");
+    }
+    statusPrintf(body, ",\"fajr_ending\":%s", fajrEndingTriggered ? "true" : "false");
+
+    DateTime tomorrow = now + TimeSpan(1, 0, 0, 0);
+    PrayerTimes tomorrowTimes;
+    if (readScheduleDay(scheduleBlob, tomorrow.year(), tomorrow.month(), tomorrow.day(), tomorrowTimes)) {
+        statusPrintf(body, "}},\"tomorrow\":{\"date\":\"%04d-%02d-%02d\",\"times\":", tomorrow.year(),
+                     tomorrow.month(), tomorrow.day());
+        writeScheduleTimes(body, tomorrowTimes);
+        statusPrintf(body, "}}");
     } else {
-        // Successfully synchronized, update RTC with the new time
-        rtc.adjust(DateTime(timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday, timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec));
-        Serial.println("Time synchronized successfully");
+        statusPrintf(body, "}},\"tomorrow\":null}");
     }
+    return true;
 }
 
 // Function to display a welcome message
@@ -382,21 +804,21 @@ void showWelcomeMessage() {
     display.setTextSize(1.5);  // Small font size
     display.setTextColor(SSD1306_WHITE);
     // Display the date below the time
-    String msg1 = "Welcome to";
-    int xPos = (SCREEN_WIDTH - (msg1.length() * 6)) / 2; // Center the date
+    const char* msg1 = "Welcome to";
+    int xPos = getXPos(msg1); // Center the date
     int yPos = SCREEN_HEIGHT /3; // Position the date below the time
     display.setCursor(xPos, yPos);  // Center the text
     display.println(msg1);
-    String msg2 = "Azan Reminder!";
-    int xPos2 = (SCREEN_WIDTH - (msg2.length() * 6)) / 2; // Center the date
+    const char* msg2 = "Azan Reminder!";
+    int xPos2 = getXPos(msg2); // Center the date
     int yPos2 = SCREEN_HEIGHT /2 + 10; // Position the date below the time
     display.setCursor(xPos2, yPos2);  // Center the text
     display.println(msg2);
-    display.display();
+    flushDisplay();
 }
 
 // Function to display a connecting to WiFi message
-void dynamicMessage(String msg1, String msg2) {
+void dynamicMessage(const char* msg1, const char* msg2) {
     display.clearDisplay();
     display.setTextSize(1.5);  // Small font size
     display.setTextColor(SSD1306_WHITE);
@@ -405,67 +827,36 @@ void dynamicMessage(String msg1, String msg2) {
     display.println(msg1);
     display.setCursor(getXPos(msg2), getYPos() + 9);  // Center the text
     display.println(msg2);
-    display.display();
+    flushDisplay();
 }
 
-// Connect to WiFi
+// Connect to WiFi (runs on the network task, so it must not draw)
 void connectToWiFi() {
-
-    preferences.begin("WiFiCreds", false);  // Open Preferences in read-only mode
-    preferences.putString("ssid", WIFI_SSID); 
-    preferences.putString("password", WIFI_PASSWORD); 
-    preferences.end();
-    // Add Wifi Name and Secret in Constant
-    preferences.begin("WiFiCreds", true);  // Open Preferences in read-only mode
-    String savedSSID = preferences.getString("ssid", ""); 
-    String savedPassword = preferences.getString("password", ""); 
-    preferences.end();
-
-    if (savedSSID.length() > 0) {
+    // Add Wifi Name and Secret in Constant; only written to flash if they changed
+    setCachedWifiCredentials(WIFI_SSID, WIFI_PASSWORD);
+    char savedSSID[CONFIG_SSID_SIZE];
+    char savedPassword[CONFIG_PASSWORD_SIZE];
+    copyCachedWifiCredentials(savedSSID, sizeof(savedSSID), savedPassword, sizeof(savedPassword));
+
+    if (strlen(savedSSID) > 0) {
+        uint32_t connectStart = telemetryStart();
         Serial.println("Connecting to saved WiFi...");
         Serial.print("SSID: ");
         Serial.println(savedSSID);
 
-        String msg1 = "Connecting to WiFi...";
-
-        // Display the "Connecting to WiFi..." message on the OLED
-        display.clearDisplay();
-        display.setTextSize(1);
-        display.setTextColor(SSD1306_WHITE);
-        display.setCursor(getXPos(msg1), getYPos());
-        display.print(msg1);  // Display the WiFi connection message
-        display.display();
-
-        WiFi.begin(savedSSID.c_str(), savedPassword.c_str());
+        WiFi.begin(savedSSID, savedPassword);
 
-        String msg2 = "Connecting.";
-        display.clearDisplay();
-        display.setTextSize(1);
-        display.setTextColor(SSD1306_WHITE);
-        display.setCursor(getXPos(msg2), getYPos());
-        display.print(msg2);
-        display.display();
         unsigned long startTime = millis();
         while (WiFi.status() != WL_CONNECTED && millis() - startTime < 20000) {
             delay(500);
-            display.print(".");
-            display.display();  // Update the display with the new message
             Serial.print(".");
         }
+        telemetryRecord(TELEMETRY_WIFI_CONNECT, connectStart);
 
         if (WiFi.status() == WL_CONNECTED) {
             Serial.println("\nConnected to WiFi!");
             Serial.print("IP Address: ");
             Serial.println(WiFi.localIP());
-            // Once connected, display success message
-            display.clearDisplay();
-            display.setTextSize(1);
-            display.setTextColor(SSD1306_WHITE);
-            String msg3 = "WiFi Connected!";
-            display.setCursor(getXPos(msg3), getYPos());
-            display.println(msg3);  // Show the success message
-            display.display();
-            delay(2000);  // Show for 2 seconds before continuing
             return;
         } else {
             Serial.println("\nFailed to connect to saved WiFi.");
@@ -477,19 +868,16 @@ void connectToWiFi() {
 
 
 
-// Function to get the formatted date (DD-MM-YYYY)
-String getFormattedDate() {
-    struct tm timeInfo;
-    DateTime now = rtc.now(); // Get current time from RTC
-    char dateBuffer[11];
-    snprintf(dateBuffer, sizeof(dateBuffer), "%02d-%02d-%04d", now.day(), now.month(), now.year());
-    return String(dateBuffer);
+// Function to get the formatted date (DD-MM-YYYY); dateBuffer needs 11 bytes
+void getFormattedDate(char* dateBuffer, size_t size) {
+    DateTime now = softClockNow(); // Get current time from the RTC-driven clock
+    snprintf(dateBuffer, size, "%02d-%02d-%04d", now.day(), now.month(), now.year());
 }
 
 // Function to get the formatted date (DD-MM-YYYY)
 String getDate() {
     struct tm timeInfo;
-    DateTime now = rtc.now(); // Get current time from RTC
+    DateTime now = softClockNow(); // Get current time from the RTC-driven clock
     char dateBuffer[11];
     snprintf(dateBuffer, sizeof(dateBuffer), "%02d-%02d-%04d", now.day(), now.month(), now.year());
     return String(dateBuffer);
@@ -498,199 +886,362 @@ String getDate() {
 
 
 void readAzanTimesFromEEPROM() {
-    preferences.begin("azanTimes", false);  // Open Preferences with the namespace "azanTimes"
+    preferences.begin("azanTimes", true);  // Open Preferences in read-only mode
     Serial.println("Reading Azan times from Preferences...");
-
-    // Read main timings
-    for (int i = 0; i < 6; i++) {
-        // Create the key by concatenating the base string and the index
-        String key = "mainTiming" + String(i);  // Concatenate "mainTiming" with the index
-        String timing = preferences.getString(key.c_str(), "");  // Use the key to fetch the timing
-        mainTimingValues[i] = timing;
-    }
-
-    // Read other timings
-    for (int i = 0; i < 5; i++) {
-        // Create the key for other timings
-        String key = "otherTiming" + String(i);  // Concatenate "otherTiming" with the index
-        String timing = preferences.getString(key.c_str(), "");  // Use the key to fetch the timing
-        otherTimingValues[i] = timing;
+    scheduleSize = preferences.getBytes("schedule", scheduleBlob, sizeof(scheduleBlob));
+    preferences.end();  // Close Preferences
+    if (validateSchedule(scheduleBlob, scheduleSize)) {
+        memcpy(&storedScheduleHeader, scheduleBlob, sizeof(storedScheduleHeader));
     }
 
-    // Check if the first timing value is empty or invalid
-    if (mainTimingValues[0].isEmpty() || mainTimingValues[0] == "0:00") {
+    if (!loadTodayFromSchedule()) {
         Serial.println("Azan times not found in Preferences, fetching from API...");
-        fetchAzanTimes();  // Fetch new Azan times and store in Preferences
+        requestNetwork(NETWORK_REFRESH_SCHEDULE);  // Fetch new Azan times and store in Preferences
     } else {
         Serial.println("Azan times loaded from Preferences.");
-        // displayTimings();
     }
+}
 
-    preferences.end();  // Close Preferences
+// Days stored after today in the in-RAM schedule
+int scheduleDaysRemaining() {
+    if (!scheduleLoaded) {
+        return 0;
+    }
+    DateTime now = softClockNow();
+    const ScheduleHeader* header = (const ScheduleHeader*)scheduleBlob;
+    return header->dayCount - 1 - scheduleDayIndex(scheduleBlob, now.year(), now.month(), now.day());
+}
+
+// Decode today's row from the in-RAM schedule into the timing arrays
+bool loadTodayFromSchedule() {
+    if (!validateSchedule(scheduleBlob, scheduleSize)) {
+        return false;
+    }
+
+    DateTime now = softClockNow();
+    if (!readScheduleDay(scheduleBlob, now.year(), now.month(), now.day(), todayTimes)) {
+        return false;
+    }
+
+    // Alerts that went off earlier today stay fired when the queue is rebuilt during the day
+    if (now.day() != eventQueue.day) {
+        resetTriggeredFlags();
+    }
+    buildEventQueue(eventQueue, todayTimes, now.day(), now.hour() * 60 + now.minute(), firedEventMask());
+    scheduleLoaded = true;
+    invalidateStatusPage(STATUS_PAGE_SCHEDULE);
+    return true;
 }
 
 void writeAzanTimesToEEPROM() {
+    if (scheduleSize == 0) {
+        return;
+    }
+
+    // Same dates, length and CRC as what is already stored: nothing to write
+    if (memcmp(&storedScheduleHeader, scheduleBlob, sizeof(storedScheduleHeader)) == 0) {
+        recordSkippedFlashWrite();
+        return;
+    }
+
     preferences.begin("azanTimes", false);  // Open Preferences with the namespace "azanTimes"
     Serial.println("Writing Azan times to Preferences...");
 
-    // Write main timings
-    for (int i = 0; i < 6; i++) {
-        String key = "mainTiming" + String(i);  // Create the key
-        String timing = mainTimingValues[i];
-        preferences.putString(key.c_str(), timing);  // Store the timing in Preferences
+    // Drop the per-timing string keys used by older firmware
+    if (preferences.isKey("mainTiming0")) {
+        for (int i = 0; i < 6; i++) {
+            preferences.remove(("mainTiming" + String(i)).c_str());
+        }
+        for (int i = 0; i < 5; i++) {
+            preferences.remove(("otherTiming" + String(i)).c_str());
+        }
     }
 
-    // Write other timings
-    for (int i = 0; i < 5; i++) {
-        String key = "otherTiming" + String(i);  // Create the key
-        String timing = otherTimingValues[i];
-        preferences.putString(key.c_str(), timing);  // Store the timing in Preferences
+    if (preferences.putBytes("schedule", scheduleBlob, scheduleSize) == scheduleSize) {
+        memcpy(&storedScheduleHeader, scheduleBlob, sizeof(storedScheduleHeader));
+        recordFlashWrite(scheduleSize);
+        Serial.printf("Azan times successfully written to Preferences (%u bytes).\n", (unsigned)scheduleSize);
+    } else {
+        Serial.println("Failed to write Azan times to Preferences.");
     }
 
-    Serial.println("Azan times successfully written to Preferences.");
-
     preferences.end();  // Close Preferences
 }
 
-void storeCityInPreferences(const String& cityName) {
-    preferences.begin("cityData", false);  // Open Preferences with the namespace "cityData"
-    preferences.putString("city", cityName);  // Store the city name as a string
-    preferences.end();  // Close Preferences
-    Serial.println("City name stored in Preferences.");
+void storeCityInPreferences(const char* cityName) {
+    setCachedCity(cityName);  // Written back by flushConfigCache() if it changed
 }
 
-String readCityFromPreferences() {
-    preferences.begin("cityData", false);  // Open Preferences with the namespace "cityData"
-    String city = preferences.getString("city", "");  // Get the city name, default is empty string if not found
-    preferences.end();  // Close Preferences
-    return city;
+// Function to read the coordinates pinned in constants.h; false when the clock geolocates
+bool readPinnedCoordinates(Coordinates& out) {
+    if (LOCATION_LATITUDE[0] == '\0' || LOCATION_LONGITUDE[0] == '\0') {
+        return false;
+    }
+    out.known = true;
+    out.latitude = atof(LOCATION_LATITUDE);
+    out.longitude = atof(LOCATION_LONGITUDE);
+    return true;
 }
 
 
-// Fetch Azan times from Aladhan API and store them
-void fetchAzanTimes() {
-
-    if (WiFi.status() != WL_CONNECTED) {
-        connectToWiFi();
+// Calculate Azan times on the device from the known coordinates
+bool calculateAzanTimes(const NetworkRequest& request, uint8_t* blob, size_t capacity, size_t& size) {
+    if (!coordinates.known) {
+        readPinnedCoordinates(coordinates);
     }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-        // Get location and fetch prayer times
-            String publicIP = getPublicIP();
-        if (publicIP == "") {
-            Serial.println("Cannot fetch geolocation without IP.");
-            return;
+    if (!coordinates.known) {
+        Serial.println("No coordinates available for on-device calculation.");
+        return false;
+    }
+
+    DateTime today(request.year, request.month, request.day);
+    PrayerTimes days[SCHEDULE_DAYS];
+    for (int d = 0; d < SCHEDULE_DAYS; d++) {
+        DateTime date = today + TimeSpan(d, 0, 0, 0);
+        if (!computePrayerTimes(date.year(), date.month(), date.day(), coordinates.latitude, coordinates.longitude,
+                                gmtOffsetSec / 3600.0, calculationMethod, days[d])) {
+            Serial.println("On-device Azan time calculation failed.");
+            return false;
         }
+    }
 
-        dynamicMessage("Fetching Geolocation");
+    size = encodeSchedule(days, SCHEDULE_DAYS, today.year(), today.month(), today.day(), blob, capacity);
+    if (size == 0) {
+        Serial.println("Failed to encode the Azan schedule.");
+        return false;
+    }
+    Serial.printf("Azan times calculated on device for %.4f, %.4f\n", coordinates.latitude, coordinates.longitude);
+    return true;
+}
 
-        HTTPClient http;
-        String url = "http://ip-api.com/json/" + publicIP;
-        http.begin(url);
-        int locRes = http.GET();
+// Function to take the days from the request date onwards out of the schedule image flashed at
+// provisioning. A clock with no coordinates yet adopts the image's, so once the image runs out
+// the on-device calculation carries on without geolocating.
+bool loadProvisionedSchedule(const NetworkRequest& request, uint8_t* blob, size_t capacity, size_t& size) {
+    ProvisionHeader header;
+    const uint8_t* schedule = provisionedScheduleImage(header);
+    if (schedule == nullptr) {
+        return false;
+    }
+    if (header.timezoneMinutes * 60L != gmtOffsetSec || header.method != calculationMethod) {
+        Serial.println("Provisioned schedule is for another time zone or method, ignored.");
+        return false;
+    }
 
-        if (locRes == 200) {
-            String payload = http.getString();
-            Serial.println("Geolocation Response: " + payload);
+    // Compare with where the clock thinks it is: pinned, looked up this boot or cached
+    Coordinates known = coordinates;
+    CachedLocation stored;
+    if (!known.known && !readPinnedCoordinates(known) && copyCachedLocation(stored)) {
+        known.known = true;
+        known.latitude = stored.latitude;
+        known.longitude = stored.longitude;
+    }
+    if (known.known && (fabs(known.latitude - header.latitude) > PROVISION_MAX_DISTANCE_DEG ||
+                        fabs(known.longitude - header.longitude) > PROVISION_MAX_DISTANCE_DEG)) {
+        Serial.println("Provisioned schedule is for another location, ignored.");
+        return false;
+    }
+    if (!known.known) {
+        coordinates.known = true;
+        coordinates.latitude = header.latitude;
+        coordinates.longitude = header.longitude;
+        char city[CONFIG_CITY_SIZE];
+        copyCachedCity(city, sizeof(city));
+        if (city[0] == '\0' && header.name[0] != '\0') {
+            storeCityInPreferences(header.name);
+        }
+    }
 
-            // Parse JSON response
-            StaticJsonDocument<1024> doc;
-            deserializeJson(doc, payload);
+    // A short tail is left to the calculation or the API, which return a full window
+    size = copyScheduleWindow(schedule, request.year, request.month, request.day, SCHEDULE_DAYS, blob, capacity);
+    if (size == 0 || ((const ScheduleHeader*)blob)->dayCount < SCHEDULE_MIN_FETCH_DAYS) {
+        size = 0;
+        return false;
+    }
+    Serial.printf("Azan times from the provisioned schedule for %s (%u days).\n", header.name,
+                  (unsigned)((const ScheduleHeader*)blob)->dayCount);
+    return true;
+}
 
-            latitude = doc["lat"].as<String>();
-            longitude = doc["lon"].as<String>();
-            city = doc["city"].as<String>();
+// Fetch one month from the Aladhan calendar endpoint, appending days from firstDay onwards
+// (and the hijri date of firstDay). https and client are kept by the caller, so a second
+// month reuses the connection.
+bool fetchAzanCalendar(HTTPClient& https, TlsSessionClient& client, int year, int month, int firstDay,
+                       PrayerTimes* days, int& dayCount, char* hijri) {
+    char apiUrl[128];
+    snprintf(apiUrl, sizeof(apiUrl),
+             "https://api.aladhan.com/v1/calendar/%d/%d?latitude=%.6f&longitude=%.6f&method=%d", year, month,
+             coordinates.latitude, coordinates.longitude, calculationMethod);
+
+    Serial.printf("API URL%s\n", apiUrl);
+    Serial.println("Fetching Azan calendar...");
+    https.begin(client, apiUrl);
+    const char* headerKeys[] = {"Transfer-Encoding"};
+    https.collectHeaders(headerKeys, 1);  // Also clears the previous response's value
+    client.noteRequest();
+
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint32_t downloadStart = telemetryStart();
+    int httpResponseCode = https.GET();
+    if (httpResponseCode != HTTP_CODE_OK) {
+        Serial.print("Error fetching Azan times: ");
+        Serial.println(httpResponseCode);
+        https.end();
+        telemetryRecord(TELEMETRY_DOWNLOAD, downloadStart);
+        return false;
+    }
 
-            storeCityInPreferences(city);
+    CountingStream counted(https.getStream(), networkStatsForUpdate().bytesReceived);
+    ChunkedStream body(counted, https.header("Transfer-Encoding").equalsIgnoreCase("chunked"), https.getSize());
+    int dayOfMonth = parseAzanCalendar(body, firstDay, days, dayCount, hijri);
+    Serial.printf("Azan calendar: %d days, heap used %u, network stack free %u\n",
+                  dayOfMonth, (unsigned)(heapBefore - ESP.getFreeHeap()),
+                  (unsigned)uxTaskGetStackHighWaterMark(nullptr));
 
-            Serial.println("Latitude: " + latitude + ", Longitude: " + longitude + ", City: " + city);
-        } else {
-            Serial.println("Error fetching geolocation.");
-        }
-        http.end();
+    // Read the rest of the body so the connection is ready for the next request
+    char skip[64];
+    while (!body.finished() && body.readBytes(skip, sizeof(skip)) > 0) {
+    }
+    https.end();
+    telemetryRecord(TELEMETRY_DOWNLOAD, downloadStart);
+    return dayOfMonth >= firstDay;
+}
 
-        dynamicMessage("Fetching Latest", "Azan Times");
-        // Get the current date and update the API URL
-        String currentDate = getFormattedDate();
-        // apiUrl = "https://api.aladhan.com/v1/timingsByCity/" + currentDate + "?city=" + String(city) + "&country=" + String(country) + "&method=16";
-        apiUrl = "https://api.aladhan.com/v1/timings/" + currentDate + "?latitude=" + latitude + "&longitude=" + longitude + "&method=16";
+// Function to walk the calendar's data array one day at a time, keeping only the timings
+// (and firstDay's hijri date, HIJRI_DATE_SIZE bytes). Returns the calendar days read, or -1 if
+// the JSON is malformed.
+int parseAzanCalendar(Stream& stream, int firstDay, PrayerTimes* days, int& dayCount, char* hijri) {
+    // The filter's keys are literals, so only its objects take pool space: 2 members in the
+    // root, 1 each in date and hijri
+    StaticJsonDocument<JSON_OBJECT_SIZE(2) + 2 * JSON_OBJECT_SIZE(1)> filter;
+    filter["timings"] = true;
+    filter["date"]["hijri"]["date"] = true;
+    StaticJsonDocument<768> jsonDoc;
+
+    int dayOfMonth = 0;
+    if (!stream.find("\"data\":[")) {
+        return -1;
+    }
+    while (dayCount < SCHEDULE_DAYS) {
+        DeserializationError error = deserializeJson(jsonDoc, stream, DeserializationOption::Filter(filter));
+        if (error) {
+            Serial.print("JSON deserialization failed: ");
+            Serial.println(error.c_str());
+            return -1;
+        }
 
-        Serial.println("API URL"+ apiUrl);
-        WiFiClientSecure client;
-        client.setInsecure();  // Bypass SSL verification
-        HTTPClient https;
+        if (++dayOfMonth >= firstDay) {
+            JsonObject timings = jsonDoc["timings"];
+            PrayerTimes& today = days[dayCount++];
+            for (int i = 0; i < PRAYER_TIME_COUNT; i++) {
+                // Calendar values carry a zone suffix, e.g. "05:21 (IST)"; parseTime24 ignores it
+                today.minutes[i] = parseTime24(timings[aladhanTimingKeys[i]] | "");
+            }
+            if (dayOfMonth == firstDay) {
+                strncpy(hijri, jsonDoc["date"]["hijri"]["date"] | "", HIJRI_DATE_SIZE - 1);
+                hijri[HIJRI_DATE_SIZE - 1] = '\0';
+            }
+        }
 
-        Serial.println("Fetching Azan times...");
-        https.begin(client, apiUrl);
+        if (!stream.findUntil(",", "]")) {
+            break;  // End of the data array
+        }
+    }
+    return dayOfMonth;
+}
 
-        int httpResponseCode = https.GET();
-        if (httpResponseCode > 0) {
-            String payload = https.getString();
-            Serial.println("Azan times fetched successfully:");
-            Serial.println(payload);
+// Fetch Azan times from Aladhan API and publish them (runs on the network task)
+bool fetchAzanTimes(const NetworkRequest& request) {
+    size_t capacity;
+    uint8_t* blob = scheduleBackBuffer(capacity);
+    size_t size = 0;
 
-            // Parse JSON response
-            StaticJsonDocument<2000> jsonDoc;
-            DeserializationError error = deserializeJson(jsonDoc, payload);
+    // A provisioned clock needs neither the network nor the calculation until its image runs out
+    if (loadProvisionedSchedule(request, blob, capacity, size)) {
+        publishSchedule(size, "");
+        return true;
+    }
 
-            if (error) {
-                Serial.print("JSON deserialization failed: ");
-                Serial.println(error.c_str());
-                return;
+    // Prefer the on-device calculation; the network is only needed to find the location
+    if (calculateOnDevice) {
+        if (!coordinates.known && !readPinnedCoordinates(coordinates)) {
+            // Within its TTL the stored location is used as is; Wi-Fi only to check it or find one
+            if (WiFi.status() != WL_CONNECTED && !storedLocationFresh()) {
+                connectToWiFi();
             }
+            resolveLocation();
+        }
+        uint32_t calculateStart = telemetryStart();
+        bool calculated = calculateAzanTimes(request, blob, capacity, size);
+        telemetryRecord(TELEMETRY_CALCULATE, calculateStart);
+        if (calculated) {
+            publishSchedule(size, "");
+            return true;
+        }
+        Serial.println("Falling back to the Aladhan API.");
+    }
 
-            // Extract and store main timings
-            JsonObject timings = jsonDoc["data"]["timings"];
-            mainTimingValues[0] = convertTo12HourFormat(timings["Fajr"].as<const char*>());
-            mainTimingValues[1] = convertTo12HourFormat(timings["Sunrise"].as<const char*>());
-            mainTimingValues[2] = convertTo12HourFormat(timings["Dhuhr"].as<const char*>());
-            mainTimingValues[3] = convertTo12HourFormat(timings["Asr"].as<const char*>());
-            mainTimingValues[4] = convertTo12HourFormat(timings["Maghrib"].as<const char*>());
-            mainTimingValues[5] = convertTo12HourFormat(timings["Isha"].as<const char*>());
-
-            // Extract and store other timings
-            otherTimingValues[0] = convertTo12HourFormat(timings["Sunset"].as<const char*>());
-            otherTimingValues[1] = convertTo12HourFormat(timings["Imsak"].as<const char*>());
-            otherTimingValues[2] = convertTo12HourFormat(timings["Midnight"].as<const char*>());
-            otherTimingValues[3] = convertTo12HourFormat(timings["Firstthird"].as<const char*>());
-            otherTimingValues[4] = convertTo12HourFormat(timings["Lastthird"].as<const char*>());
-
-            // Write updated timings to EEPROM
-            writeAzanTimesToEEPROM();
-            readAzanTimesFromEEPROM();
-            displayTimings();
+    if (WiFi.status() != WL_CONNECTED) {
+        connectToWiFi();
+    }
+    
+    if (WiFi.status() == WL_CONNECTED) {
+        // Get location and fetch prayer times
+        if (!resolveLocation()) {
+            return false;
+        }
 
-            fetchingAzanTimes = false; // Stop fetching animation
-        } else {
-            Serial.print("Error fetching Azan times: ");
-            Serial.println(httpResponseCode);
+        // Fetch this month's calendar, and the next month's too when few days are left in this one
+        PrayerTimes days[SCHEDULE_DAYS];
+        int dayCount = 0;
+        char hijri[HIJRI_DATE_SIZE] = "";
+        int year = request.year;
+        int month = request.month;
+        TlsSessionClient client;
+        HTTPClient https;
+        https.setReuse(true);  // HTTP/1.1 keep-alive, so the second month skips the handshake
+        if (!fetchAzanCalendar(https, client, year, month, request.day, days, dayCount, hijri)) {
+            return false;
+        }
+        if (dayCount < SCHEDULE_MIN_FETCH_DAYS) {
+            month = month % 12 + 1;
+            year += month == 1 ? 1 : 0;
+            fetchAzanCalendar(https, client, year, month, 1, days, dayCount, hijri);
+        }
+
+        size = encodeSchedule(days, dayCount, request.year, request.month, request.day, blob, capacity);
+        if (size > 0) {
+            publishSchedule(size, hijri);  // Stored and shown by the loop task
         }
-        https.end();
     } else {
         Serial.println("Not connected to WiFi. Cannot fetch Azan times.");
     }
+    return size > 0;
 }
 
 
-// Function to convert 24-hour format to 12-hour format
-String convertTo12HourFormat(const String &time24) {
-    int hour = time24.substring(0, 2).toInt();
-    int minute = time24.substring(3, 5).toInt();
-    String period = "AM";
+// Function to parse "HH:MM" into minutes since midnight, -1 if invalid
+int parseTime24(const char* time24) {
+    int hour, minute;
+    if (sscanf(time24, "%d:%d", &hour, &minute) != 2 || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+        return -1;
+    }
+    return hour * 60 + minute;
+}
 
-    if (hour >= 12) {
-        period = "PM";
-        if (hour > 12) {
-            hour -= 12;
-        }
-    } else if (hour == 0) {
+// Function to format minutes since midnight in 12-hour format ("h:mm AM"), empty if undefined
+void formatMinutesAs12Hour(int minutes, char* out, size_t size) {
+    if (minutes < 0) {
+        out[0] = '\0';
+        return;
+    }
+    int hour = minutes / 60;
+    const char* period = hour >= 12 ? "PM" : "AM";
+    hour %= 12;
+    if (hour == 0) {
         hour = 12;
     }
-
-    String hourString = String(hour);
-    String minuteString = (minute < 10) ? "0" + String(minute) : String(minute);
-
-    return hourString + ":" + minuteString + " " + period;
+    snprintf(out, size, "%d:%02d %s", hour, minutes % 60, period);
 }
 
 // Function to display fetching animation
@@ -704,129 +1255,56 @@ void displayFetchingAnimation() {
         display.print(".");
     }
     dotCount = (dotCount + 1) % 4;  // Cycle through 0, 1, 2, 3
-    display.display();
+    flushDisplay();
 }
 
 
-void displayTimings() {
-    readAzanTimesFromEEPROM();
-    display.clearDisplay();
-    display.setTextColor(SSD1306_WHITE);
-    
-
-    // Define table dimensions
-    int tableWidth = 128;  // Display width
-    int tableHeight = 64;  // Display height
-    int startY = 2;  // Starting Y position for the first row
-    int columnSpacing = 60;  // Space between columns
-    int rowHeight = 8;  // Height of each row
-    int extraRowSpacing = 2;  // Extra space after the line (you can adjust this value)
-
-    int labelColumnX = 5;  // X position for labels
-    int valueColumnX = tableWidth / 2 + 5;  // X position for values
-
-    // Draw table borders
-    display.drawRect(0, 0, tableWidth, tableHeight, SSD1306_WHITE);
-    display.drawLine(tableWidth / 2, 0, tableWidth / 2, tableHeight, SSD1306_WHITE);
-
-    for (int i = 0; i < 6; i++) {
-        int labelWidth = mainTimingNames[i].length() * 6;
-        int labelX = labelColumnX + (columnSpacing - labelWidth) / 2;
-
-        display.setTextSize(1);
-        // Print the timing name (centered)
-        display.setCursor(labelX, startY);
-        display.print(mainTimingNames[i]);
-
-        String value = mainTimingValues[i];
-        int valueWidth = value.length() * 6;
-        int valueX = valueColumnX + (columnSpacing - valueWidth) / 2;
-
-        display.setTextSize(1);
-        // Print the value (centered)
-        display.setCursor(valueX, startY);
-        display.print(value);
-
-        // Draw a line under each row for separation, except the last row
-        if (i != 5) {  // Skip the last row
-            display.drawLine(0, startY + rowHeight, tableWidth, startY + rowHeight, SSD1306_WHITE);
-        }
+// Static chrome of the two timing tables, drawn on first use
+static TableLayer mainTimingsLayer;
+static TableLayer otherTimingsLayer;
 
-        // Add extra space after the line for subsequent rows
-        startY += rowHeight + extraRowSpacing;
+void displayTimings() {
+    if (!mainTimingsLayer.built) {
+        buildTableLayer(mainTimingsLayer, display, mainTimingNames, MAIN_TIMING_COUNT);
     }
 
-
-    display.display();
+    char values[MAIN_TIMING_COUNT][TIME_TEXT_SIZE];
+    const char* cells[MAIN_TIMING_COUNT];
+    for (int i = 0; i < MAIN_TIMING_COUNT; i++) {
+        formatMinutesAs12Hour(todayTimes.minutes[i], values[i], sizeof(values[i]));
+        cells[i] = values[i];
+    }
+    composeTable(mainTimingsLayer, display, cells);
+    flushDisplay();
 }
 
-// Function to display either main or other timings based on the flag
+// Function to display the other timings (sunset, imsak, midnight and the night thirds)
 void displayOtherTimings() {
-    readAzanTimesFromEEPROM();
-     display.clearDisplay();
-    display.setTextColor(SSD1306_WHITE);
-    
-
-    // Define table dimensions
-    int tableWidth = 128;  // Display width
-    int tableHeight = 64;  // Display height
-    int startY = 2;  // Starting Y position for the first row
-    int columnSpacing = 60;  // Space between columns
-    int rowHeight = 8;  // Height of each row
-    int extraRowSpacing = 2;  // Extra space after the line (you can adjust this value)
-
-    int labelColumnX = 5;  // X position for labels
-    int valueColumnX = tableWidth / 2 + 5;  // X position for values
-
-    // Draw table borders
-    display.drawRect(0, 0, tableWidth, tableHeight, SSD1306_WHITE);
-    display.drawLine(tableWidth / 2, 0, tableWidth / 2, tableHeight, SSD1306_WHITE);
-
-
-    for (int i = 0; i < 5; i++) {
-        int labelWidth = otherTimingNames[i].length() * 6;
-        int labelX = labelColumnX + (columnSpacing - labelWidth) / 2;
-
-        display.setTextSize(1);
-        // Print the timing name (centered)
-        display.setCursor(labelX, startY);
-        display.print(otherTimingNames[i]);
-
-        String value = otherTimingValues[i];
-        int valueWidth = value.length() * 6;
-        int valueX = valueColumnX + (columnSpacing - valueWidth) / 2;
-
-        display.setTextSize(1);
-        // Print the value (centered)
-        display.setCursor(valueX, startY);
-        display.print(value);
-
-        // Draw a line under each row for separation, except the last row
-        if (i != 4) {  // Skip the last row
-            display.drawLine(0, startY + rowHeight, tableWidth, startY + rowHeight, SSD1306_WHITE);
-        }
-
-        // Add extra space after the line for subsequent rows
-        startY += rowHeight + extraRowSpacing;
+    if (!otherTimingsLayer.built) {
+        buildTableLayer(otherTimingsLayer, display, otherTimingNames, OTHER_TIMING_COUNT);
     }
-    
 
-    display.display();
+    char values[OTHER_TIMING_COUNT][TIME_TEXT_SIZE];
+    const char* cells[OTHER_TIMING_COUNT];
+    for (int i = 0; i < OTHER_TIMING_COUNT; i++) {
+        formatMinutesAs12Hour(todayTimes.minutes[PRAYER_SUNSET + i], values[i], sizeof(values[i]));
+        cells[i] = values[i];
+    }
+    composeTable(otherTimingsLayer, display, cells);
+    flushDisplay();
 }
 
 void displayLargeTime() {
     display.clearDisplay();
-    
-    // Set large font for time
-    display.setTextSize(2); // Large font size for time
+    display.setTextSize(1);
     display.setTextColor(SSD1306_WHITE);
 
-    // Get current time from RTC
-    DateTime now = rtc.now();
+    // Get current time from the RTC-driven clock
+    DateTime now = softClockNow();
     int hour = now.hour();
     int minute = now.minute();
     int sec = now.second();
-    String period = "AM";
+    const char* period = "AM";
 
     if (hour >= 12) {
         period = "PM";
@@ -835,33 +1313,37 @@ void displayLargeTime() {
         hour = 12;
     }
 
-    // Format the time string
-    String hourString = String(hour);
-    String minuteString = (minute < 10) ? "0" + String(minute) : String(minute);
-    String secString = (sec < 10) ? "0" + String(sec) : String(sec);
-    String timeString = hourString + ":" + minuteString + ":" + secString + " ";
-
-    // Calculate position for time
-    int timeX = (SCREEN_WIDTH - (timeString.length() * 12)) / 2;
-    int timeY = SCREEN_HEIGHT / 3;
-
-    // Display the time at the center of the screen
-    display.setCursor(timeX, timeY);
-    display.print(timeString);
+    char dateString[11];
+    getFormattedDate(dateString, sizeof(dateString));  // Get the current date
+
+    // The digits are blitted from the pre-rendered atlas straight into the framebuffer
+    uint8_t* buffer = display.getBuffer();
+    char timeString[12];
+    if (LARGE_CLOCK_FULL_PANEL) {
+        // Hours and minutes across the top six pages, seconds, AM/PM and the date underneath
+        snprintf(timeString, sizeof(timeString), "%d:%02d", hour, minute);
+        drawDigits(buffer, DIGIT_FONT_LARGE, (SCREEN_WIDTH - digitTextWidth(DIGIT_FONT_LARGE, timeString)) / 2, 0,
+                   timeString);
+
+        char footer[24];
+        snprintf(footer, sizeof(footer), "%02d %s  %s", sec, period, dateString);
+        display.setCursor(getXPos(footer), SCREEN_HEIGHT - 8);
+        display.print(footer);
+        flushDisplay();
+        return;
+    }
 
-    // Display the period (AM/PM) as superscript
-    display.setTextSize(1); // Smaller font size for period
-    int periodX = timeX + timeString.length() * 11; // Position to the right of the time
-    int periodY = timeY - 2; // Position above the time
-    display.setCursor(periodX, periodY);
+    // Time on pages 2 and 3, with the period (AM/PM) as superscript to its right
+    snprintf(timeString, sizeof(timeString), "%d:%02d:%02d", hour, minute, sec);
+    int timeWidth = digitTextWidth(DIGIT_FONT_SMALL, timeString);
+    int timeX = (SCREEN_WIDTH - (timeWidth + 2 + 12)) / 2;
+    int timeY = 16;
+    int periodX = drawDigits(buffer, DIGIT_FONT_SMALL, timeX, timeY, timeString) + 2;
+    display.setCursor(periodX, timeY);
     display.print(period);
 
-    // Set small font for the date
-    display.setTextSize(1); // Small font size for the date
-    String dateString = getFormattedDate();  // Get the current date
-
     // Calculate position for the date
-    int dateX = (SCREEN_WIDTH - (dateString.length() * 6)) / 2;
+    int dateX = getXPos(dateString);
     int dateY = timeY + 16 + 10; // Position the date below the time
 
     // Display the date
@@ -874,13 +1356,11 @@ void displayLargeTime() {
     int indicatorX = (SCREEN_WIDTH - totalIndicatorWidth) / 2; // Center the indicators
     int indicatorY = 0; // Top of the screen
 
-    String storedCity = readCityFromPreferences();
-
-    // Set small font for the city
-    display.setTextSize(1); // Small font size for the city
+    char storedCity[CONFIG_CITY_SIZE];
+    copyCachedCity(storedCity, sizeof(storedCity));
 
     // Calculate position for the city
-    int cityX = (SCREEN_WIDTH - (storedCity.length() * 6)) / 2;
+    int cityX = getXPos(storedCity);
     int cityY = 0; // Position at the top of the screen
 
     // Display the city
@@ -888,15 +1368,15 @@ void displayLargeTime() {
     display.print(storedCity);
 
     // Display everything on the screen
-    display.display();
+    flushDisplay();
 }
 
 
 
 
 // Function to calculate x position for centering text
-int getXPos(String text) {
-    return (SCREEN_WIDTH - (text.length() * 6)) / 2; // Adjust based on character width
+int getXPos(const char* text) {
+    return (SCREEN_WIDTH - ((int)strlen(text) * 6)) / 2; // Adjust based on character width
 }
 
 // Function to calculate y position
@@ -905,14 +1385,15 @@ int getYPos() {
 }
 
 void checkForMidnightUpdate() {
-    DateTime now = rtc.now(); // Get current time from RTC
+    DateTime now = softClockNow(); // Get current time from the RTC-driven clock
 
     if (now.hour() == 1 && now.minute() >= 1 && now.minute() <= 5 && !azanTimesUpdated) { 
         // It's 12:00 AM and Azan times haven't been updated yet
-        fetchAzanTimes();  // Fetch new Azan times from the API
+        // Advance to today's row of the stored schedule; only refetch when it has run out
+        if (!loadTodayFromSchedule() || scheduleDaysRemaining() < SCHEDULE_REFILL_DAYS) {
+            requestNetwork(NETWORK_REFRESH_SCHEDULE);  // Fetch new Azan times from the API
+        }
         azanTimesUpdated = true;  // Set the flag to prevent multiple updates
-        // Read stored Azan times from EEPROM
-        readAzanTimesFromEEPROM();
     } 
     else if (now.hour() == 0 && now.minute() >= 6) {
         // Reset the flag after 12:00 AM passes
@@ -941,28 +1422,23 @@ bool isValidAzanTime(const String& time) {
 }
 
 // Function to sound the buzzer and display the current prayer time and name
-void soundBuzzer(String prayerTime, String prayerName, String flag) {
+// The pattern plays in the background; see updateAlertPlayer() in loop()
+void soundBuzzer(const char* prayerTime, const char* prayerName, const char* flag) {
     Serial.println("Buzzer is sounding!");
+    setDisplayPower(true);
+    startAlert(findAlertPattern(flag), prayerTime, prayerName);
+}
 
-    int loopCount = 15;
-    int duration = 400;
-    if(flag == "rem"){
-        loopCount = 5;
-        duration = 1000;
-    }
-    // Flash the prayer time and name on the screen and sound the buzzer
-    for (int i = 0; i < loopCount; i++) {  // Three sets of beeps and flashes
-        // Sound the buzzer
-        tone(BUZZER_PIN, 1000);  // Set buzzer frequency (1000 Hz)
-        // Flash the current prayer time and name on the OLED
-        display.clearDisplay();  // Clear the display
-
+// Draw one flash of the alert screen
+void drawAlertFrame(const char* prayerTime, const char* prayerName, bool on) {
+    display.clearDisplay();  // Clear the display
+    if (on) {
         // Set large font for the prayer time
         display.setTextSize(2);  // Large font size for the time
         display.setTextColor(SSD1306_WHITE);
 
         // Calculate position for the time
-        int timeX = (SCREEN_WIDTH - (prayerTime.length() * 12)) / 2;
+        int timeX = (SCREEN_WIDTH - ((int)strlen(prayerTime) * 12)) / 2;
         int timeY = SCREEN_HEIGHT / 3;
 
         // Display the prayer time at the center of the screen
@@ -973,22 +1449,14 @@ void soundBuzzer(String prayerTime, String prayerName, String flag) {
         display.setTextSize(1);  // Small font size for the prayer name
 
         // Calculate position for the prayer name
-        int nameX = (SCREEN_WIDTH - (prayerName.length() * 6)) / 2;
+        int nameX = getXPos(prayerName);
         int nameY = timeY + 16 + 10;  // Position the name below the time
 
         // Display the prayer name
         display.setCursor(nameX, nameY);
         display.print(prayerName);
-
-        display.display();     
-        delay(duration);              // Beep duration (500 ms)
-        // Clear the display to create the flash effect
-        display.clearDisplay();
-        display.display();
-        noTone(BUZZER_PIN);      // Stop the buzzer
-        delay(200);              // Pause between beeps
-
     }
+    flushDisplay();
 }
 
 
@@ -1003,17 +1471,16 @@ void  clearPreferences() {
 
 // Function to get public IP
 String getPublicIP() {
-    delay(500);
+    TlsSessionClient client;
     HTTPClient http;
-    dynamicMessage("Fetching Public IP");
-    http.begin("https://api.ipify.org");  // Use icanhazip.com as an alternative
+    Serial.println("Fetching Public IP");
+    http.begin(client, "https://api.ipify.org");  // Use icanhazip.com as an alternative
     int httpResponseCode = http.GET();
     String publicIP = "";
 
     if (httpResponseCode == 200) {
         publicIP = http.getString();
-        dynamicMessage("Public IP Detected", publicIP);
-        delay(500);
+        publicIP.trim();
         Serial.println("Public IP: " + publicIP);
     } else {
         Serial.println("Error getting public IP");
@@ -1022,32 +1489,145 @@ String getPublicIP() {
     return publicIP;
 }
 
-// Function to fetch geolocation from IP
-void getGeoLocation() {
+// Function to fingerprint the network the clock is on: the SSID and the access point
+static void fingerprintNetwork(CachedLocation& location) {
+    String ssid = WiFi.SSID();
+    location.ssidHash = crc32((const uint8_t*)ssid.c_str(), ssid.length());
+    const uint8_t* bssid = WiFi.BSSID();
+    if (bssid != nullptr) {
+        memcpy(location.bssid, bssid, sizeof(location.bssid));
+    }
+}
+
+// Function to tell whether the stored location is younger than CONFIG_LOCATION_TTL_S, so it can
+// be used without going online to check the network fingerprint
+bool storedLocationFresh() {
+    CachedLocation stored;
+    return copyCachedLocation(stored) && softClockNow().unixtime() - stored.checkedAt < CONFIG_LOCATION_TTL_S;
+}
+
+static void useLocation(const CachedLocation& location) {
+    coordinates.known = true;
+    coordinates.latitude = location.latitude;
+    coordinates.longitude = location.longitude;
+}
+
+// Function to find the coordinates (runs on the network task). Pinned coordinates need no
+// network at all; otherwise the stored location is used offline, or while the network
+// fingerprint matches and the TTL has not run out, and geolocation is skipped while the public
+// IP is unchanged.
+bool resolveLocation() {
+    if (readPinnedCoordinates(coordinates)) {
+        return true;
+    }
+
+    DateTime now = softClockNow();
+    uint16_t month = now.year() * 12 + now.month() - 1;
+    CachedLocation stored;
+    memset(&stored, 0, sizeof(stored));
+    bool haveStored = copyCachedLocation(stored);
+
+    if (WiFi.status() != WL_CONNECTED) {
+        if (!haveStored) {
+            return false;
+        }
+        useLocation(stored);  // Offline, or not worth going online for: the clock has most likely not moved
+        if (now.unixtime() - stored.checkedAt < CONFIG_LOCATION_TTL_S) {
+            noteLocationLookups(month, 0, 2);
+        }
+        return true;
+    }
+
+    CachedLocation current;
+    memset(&current, 0, sizeof(current));
+    fingerprintNetwork(current);
+    bool sameNetwork = haveStored && current.ssidHash == stored.ssidHash &&
+                       memcmp(current.bssid, stored.bssid, sizeof(current.bssid)) == 0;
+    if (sameNetwork && now.unixtime() - stored.checkedAt < CONFIG_LOCATION_TTL_S) {
+        useLocation(stored);
+        noteLocationLookups(month, 0, 2);
+        Serial.printf("Location from cache: %.4f, %.4f\n", coordinates.latitude, coordinates.longitude);
+        return true;
+    }
+
     String publicIP = getPublicIP();
     if (publicIP == "") {
-        Serial.println("Cannot fetch geolocation without IP.");
-        return;
+        noteLocationLookups(month, 1, 0);
+        if (!haveStored) {
+            Serial.println("Cannot fetch geolocation without IP.");
+            return false;
+        }
+        useLocation(stored);
+        return true;
     }
 
+    current.checkedAt = now.unixtime();
+    strncpy(current.publicIp, publicIP.c_str(), sizeof(current.publicIp) - 1);
+    if (haveStored && strcmp(current.publicIp, stored.publicIp) == 0) {
+        // New access point or TTL out, but the same connection: the location still holds
+        current.latitude = stored.latitude;
+        current.longitude = stored.longitude;
+        setCachedLocation(current);
+        noteLocationLookups(month, 1, 1);
+        useLocation(stored);
+        Serial.printf("Public IP unchanged, location from cache: %.4f, %.4f\n", coordinates.latitude,
+                      coordinates.longitude);
+        return true;
+    }
+
+    if (!getGeoLocation(publicIP)) {
+        noteLocationLookups(month, 2, 0);
+        coordinates.known = false;
+        if (haveStored) {
+            useLocation(stored);
+        }
+        return haveStored;
+    }
+    current.latitude = coordinates.latitude;
+    current.longitude = coordinates.longitude;
+    setCachedLocation(current);
+    noteLocationLookups(month, 2, 0);
+    return true;
+}
+
+// Function to fetch geolocation from IP
+bool getGeoLocation(const String& publicIP) {
+    Serial.println("Fetching Geolocation");
+
+    uint32_t locateStart = telemetryStart();
     HTTPClient http;
-    String url = "http://ip-api.com/json/" + publicIP;
+    String url = "http://ip-api.com/json/" + publicIP + "?fields=lat,lon,city";
+    http.useHTTP10(true);
     http.begin(url);
     int httpResponseCode = http.GET();
 
+    bool located = false;
     if (httpResponseCode == 200) {
-        String payload = http.getString();
-        Serial.println("Geolocation Response: " + payload);
+        // Parse JSON response straight from the stream, keeping only what we use
+        StaticJsonDocument<JSON_OBJECT_SIZE(3)> filter;
+        filter["lat"] = true;
+        filter["lon"] = true;
+        filter["city"] = true;
+
+        StaticJsonDocument<192> doc;
+        deserializeJson(doc, http.getStream(), DeserializationOption::Filter(filter));
+
+        located = !doc["lat"].isNull() && !doc["lon"].isNull();
+        if (located) {
+            coordinates.known = true;
+            coordinates.latitude = doc["lat"].as<double>();
+            coordinates.longitude = doc["lon"].as<double>();
+        }
+        const char* cityName = doc["city"] | "";
 
-        // Parse JSON response
-        StaticJsonDocument<1024> doc;
-        deserializeJson(doc, payload);
+        storeCityInPreferences(cityName);
 
-        latitude = doc["lat"].as<String>();
-        longitude = doc["lon"].as<String>();
-        Serial.println("Latitude: " + latitude + ", Longitude: " + longitude);
+        Serial.printf("Latitude: %.4f, Longitude: %.4f, City: %s\n", coordinates.latitude, coordinates.longitude,
+                      cityName);
     } else {
         Serial.println("Error fetching geolocation.");
     }
     http.end();
+    telemetryRecord(TELEMETRY_GEOLOCATE, locateStart);
+    return located;
 }
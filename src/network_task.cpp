@@ -0,0 +1,113 @@
+// network_task.cpp
+// Wi-Fi, geolocation, schedule refresh and NTP run on a task pinned to
+// core 0 so the loop task on core 1 keeps drawing and alerting.
+#include <Arduino.h>
+#include <atomic>
+#include "network_task.h"
+#include "telemetry.h"
+
+static QueueHandle_t requestQueue = nullptr;
+static NetworkHandler networkHandler = nullptr;
+static NetworkCompletion networkCompletion = nullptr;
+
+static std::atomic<uint32_t> pendingTypes(0);   // Bit per NetworkRequestType
+static std::atomic<bool> running(false);
+static NetworkStats stats = {0, 0, 0};
+
+// Two schedule buffers; the one not published is written by the network task.
+// A refresh takes seconds and the loop copies the published one right away,
+// so the writer never catches up with a buffer still being read.
+struct ScheduleSnapshot {
+    alignas(4) uint8_t blob[scheduleBlobSize(SCHEDULE_DAYS)];
+    size_t size;
+    char hijriDate[HIJRI_DATE_SIZE];
+};
+static ScheduleSnapshot snapshots[2];
+static std::atomic<uint32_t> publishedGeneration(0);
+static uint32_t takenGeneration = 0;  // Loop task only
+
+static void networkTask(void* parameter) {
+    NetworkRequest request;
+    for (;;) {
+        if (xQueueReceive(requestQueue, &request, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        running = true;
+        pendingTypes &= ~(1UL << request.type);
+        stats.requests++;
+        bool success = networkHandler(request);
+        noteNetworkStackFree();
+        if (networkCompletion != nullptr) {
+            networkCompletion(request, success);
+        }
+        running = false;
+    }
+}
+
+bool startNetworkTask(NetworkHandler handler, NetworkCompletion completion) {
+    networkHandler = handler;
+    networkCompletion = completion;
+    requestQueue = xQueueCreate(NETWORK_QUEUE_DEPTH, sizeof(NetworkRequest));
+    if (requestQueue == nullptr) {
+        return false;
+    }
+    return xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK, nullptr,
+                                   NETWORK_TASK_PRIORITY, nullptr, NETWORK_TASK_CORE) == pdPASS;
+}
+
+bool queueNetworkRequest(const NetworkRequest& request) {
+    if (requestQueue == nullptr) {
+        return false;
+    }
+    uint32_t bit = 1UL << request.type;
+    if (pendingTypes.fetch_or(bit) & bit) {
+        return true;  // Already waiting in the queue
+    }
+    if (xQueueSend(requestQueue, &request, 0) != pdTRUE) {
+        pendingTypes &= ~bit;
+        return false;
+    }
+    return true;
+}
+
+bool networkBusy() {
+    return running || pendingTypes != 0;
+}
+
+const NetworkStats& networkStats() {
+    return stats;
+}
+
+NetworkStats& networkStatsForUpdate() {
+    return stats;
+}
+
+uint8_t* scheduleBackBuffer(size_t& capacity) {
+    capacity = sizeof(snapshots[0].blob);
+    return snapshots[(publishedGeneration.load() + 1) & 1].blob;
+}
+
+void publishSchedule(size_t size, const char* hijriDate) {
+    uint32_t next = publishedGeneration.load() + 1;
+    snapshots[next & 1].size = size;
+    strncpy(snapshots[next & 1].hijriDate, hijriDate, HIJRI_DATE_SIZE - 1);
+    snapshots[next & 1].hijriDate[HIJRI_DATE_SIZE - 1] = '\0';
+    publishedGeneration.store(next, std::memory_order_release);
+}
+
+bool takePublishedSchedule(uint8_t* out, size_t capacity, size_t& size, char* hijriDate) {
+    uint32_t generation = publishedGeneration.load(std::memory_order_acquire);
+    if (generation == takenGeneration) {
+        return false;
+    }
+    takenGeneration = generation;
+
+    const ScheduleSnapshot& snapshot = snapshots[generation & 1];
+    if (snapshot.size > capacity) {
+        return false;
+    }
+    memcpy(out, snapshot.blob, snapshot.size);
+    size = snapshot.size;
+    memcpy(hijriDate, snapshot.hijriDate, HIJRI_DATE_SIZE);
+    return true;
+}
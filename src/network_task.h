@@ -0,0 +1,60 @@
+// network_task.h
+#ifndef NETWORK_TASK_H
+#define NETWORK_TASK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "schedule_store.h"
+
+#define NETWORK_TASK_CORE 0
+#define NETWORK_TASK_STACK 12288
+#define NETWORK_TASK_PRIORITY 1
+#define NETWORK_QUEUE_DEPTH 4
+
+enum NetworkRequestType : uint8_t {
+    NETWORK_REFRESH_SCHEDULE,   // Locate, calculate or fetch, then publish a schedule
+    NETWORK_SYNC_TIME,          // Fetch the time over NTP
+    NETWORK_REQUEST_TYPES
+};
+
+struct NetworkRequest {
+    NetworkRequestType type;
+    uint16_t year;   // Date the request is for, captured on the loop task
+    uint8_t month;
+    uint8_t day;
+};
+
+// Radio and transfer accounting, updated by the network task
+struct NetworkStats {
+    uint32_t requests;
+    uint32_t radioOnMs;       // Time Wi-Fi was up for requests
+    uint32_t bytesReceived;   // Response bodies read from the network
+};
+
+// Runs on the network task; returns true on success
+typedef bool (*NetworkHandler)(const NetworkRequest& request);
+// Runs on the network task after each request; must only touch thread-safe state
+typedef void (*NetworkCompletion)(const NetworkRequest& request, bool success);
+
+bool startNetworkTask(NetworkHandler handler, NetworkCompletion completion);
+
+// Queue a request without blocking. A request of a type that is already
+// pending is merged with it. Returns false if the queue is full.
+bool queueNetworkRequest(const NetworkRequest& request);
+
+// True while any request is queued or running
+bool networkBusy();
+
+const NetworkStats& networkStats();
+NetworkStats& networkStatsForUpdate();  // Network task only
+
+#define HIJRI_DATE_SIZE 11  // DD-MM-YYYY plus terminator
+
+// Schedule snapshot handoff. The network task encodes into the back buffer
+// and publishes it with the hijri date of its first day ("" when only the
+// API knows it); the loop task picks both up with a single atomic load.
+uint8_t* scheduleBackBuffer(size_t& capacity);
+void publishSchedule(size_t size, const char* hijriDate);
+bool takePublishedSchedule(uint8_t* out, size_t capacity, size_t& size, char* hijriDate);
+
+#endif
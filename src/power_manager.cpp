@@ -0,0 +1,86 @@
+// power_manager.cpp
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include "power_manager.h"
+#include "button_gestures.h"
+#include "display_flush.h"
+#include "telemetry.h"
+
+static const char* const powerStateNames[POWER_STATE_COUNT] = {"active", "display off", "light sleep"};
+static const float powerStateMa[POWER_STATE_COUNT] = {POWER_ACTIVE_MA, POWER_DISPLAY_OFF_MA, POWER_LIGHT_SLEEP_MA};
+
+static Adafruit_SSD1306* powerDisplay = nullptr;
+static PowerStats stats = {{0, 0, 0}, 0, 0};
+static PowerState currentState = POWER_ACTIVE;
+static unsigned long stateSinceMillis = 0;
+static bool displayOn = true;
+
+// Charge the time since the last change to the current state and switch
+static void enterState(PowerState state) {
+    unsigned long now = millis();
+    stats.stateMs[currentState] += now - stateSinceMillis;
+    stateSinceMillis = now;
+    currentState = state;
+}
+
+void beginPowerManager(Adafruit_SSD1306* display) {
+    powerDisplay = display;
+    stateSinceMillis = millis();
+}
+
+void setDisplayPower(bool on) {
+    if (on == displayOn) {
+        return;
+    }
+    displayOn = on;
+    powerDisplay->ssd1306_command(on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF);
+    enterState(on ? POWER_ACTIVE : POWER_DISPLAY_OFF);
+}
+
+bool displayPowered() {
+    return displayOn;
+}
+
+bool lightSleepFor(uint32_t seconds) {
+    Serial.printf("Light sleep for %u s\n", (unsigned)seconds);
+    Serial.flush();
+
+    waitDisplayFlush();  // The flush task is frozen while asleep
+    enterState(POWER_LIGHT_SLEEP);
+    esp_sleep_enable_timer_wakeup((uint64_t)seconds * 1000000ULL);
+    enableButtonWakeup();
+    esp_light_sleep_start();  // millis() keeps counting across the sleep
+    disableButtonWakeup();
+    telemetrySkipLoop();  // The sleep is not a stall
+    bool byButton = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+    enterState(displayOn ? POWER_ACTIVE : POWER_DISPLAY_OFF);
+
+    stats.sleeps++;
+    if (byButton) {
+        stats.buttonWakes++;
+    }
+    return byButton;
+}
+
+const PowerStats& powerStats() {
+    enterState(currentState);  // Bring the current state's time up to date
+    return stats;
+}
+
+float powerChargeMah(const PowerStats& stats) {
+    float mah = 0;
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        mah += powerStateMa[i] * (float)stats.stateMs[i] / 3600000.0f;
+    }
+    return mah;
+}
+
+void printPowerReport() {
+    const PowerStats& current = powerStats();
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        Serial.printf("Power: %-11s %8u s %7.1f mAh\n", powerStateNames[i], (unsigned)(current.stateMs[i] / 1000),
+                      powerStateMa[i] * (float)current.stateMs[i] / 3600000.0f);
+    }
+    Serial.printf("Power: %u sleeps (%u woken by button), %.1f mAh total\n", (unsigned)current.sleeps,
+                  (unsigned)current.buttonWakes, powerChargeMah(current));
+}
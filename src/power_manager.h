@@ -0,0 +1,45 @@
+// power_manager.h
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <stdint.h>
+#include <Adafruit_SSD1306.h>
+
+// Nominal supply current per state, in mA, used for the charge estimate
+#define POWER_ACTIVE_MA 60.0f        // CPU running, OLED lit
+#define POWER_DISPLAY_OFF_MA 45.0f   // CPU running, OLED off
+#define POWER_LIGHT_SLEEP_MA 1.0f    // Light sleep, OLED off, DS3231 running
+
+enum PowerState : uint8_t {
+    POWER_ACTIVE,
+    POWER_DISPLAY_OFF,
+    POWER_LIGHT_SLEEP,
+    POWER_STATE_COUNT
+};
+
+struct PowerStats {
+    uint64_t stateMs[POWER_STATE_COUNT];  // Time spent in each state since boot
+    uint32_t sleeps;
+    uint32_t buttonWakes;
+};
+
+void beginPowerManager(Adafruit_SSD1306* display);
+
+// Send the SSD1306 display on/off command; the framebuffer is kept
+void setDisplayPower(bool on);
+
+bool displayPowered();
+
+// Light sleep for up to the given time; wakes early on a button press.
+// Returns true if the button woke the chip.
+bool lightSleepFor(uint32_t seconds);
+
+const PowerStats& powerStats();
+
+// Estimated charge drawn, from the per-state times and the nominal currents
+float powerChargeMah(const PowerStats& stats);
+
+// Log time and charge per state over Serial
+void printPowerReport();
+
+#endif
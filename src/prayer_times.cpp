@@ -0,0 +1,229 @@
+// prayer_times.cpp
+// On-device prayer time calculation. Follows the same solar model as the
+// Aladhan API (PrayTimes.org algorithm, one refinement pass, angle-based
+// high latitude rule) so the results match the API to the minute.
+#include "prayer_times.h"
+#include <math.h>
+
+// Aladhan calculation methods. Method 6 is a custom method in the API and is
+// not listed; method 15 uses plain 18 degree angles without seasonal tuning.
+static constexpr CalculationMethod calculationMethods[] = {
+    // id  fajr   isha   isMin  maghrib isMin  jafari  offsets (Fajr..Isha)
+    {  0, 16.0f, 14.0f, false,  4.0f, false, true,  {0, 0, 0, 0, 0, 0} },  // Shia Ithna-Ashari
+    {  1, 18.0f, 18.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Karachi
+    {  2, 15.0f, 15.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // ISNA
+    {  3, 18.0f, 17.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Muslim World League
+    {  4, 18.5f, 90.0f, true,   0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Umm Al-Qura, Makkah
+    {  5, 19.5f, 17.5f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Egyptian
+    {  7, 17.7f, 14.0f, false,  4.5f, false, true,  {0, 0, 0, 0, 0, 0} },  // Tehran
+    {  8, 19.5f, 90.0f, true,   0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Gulf Region
+    {  9, 18.0f, 17.5f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Kuwait
+    { 10, 18.0f, 90.0f, true,   0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Qatar
+    { 11, 20.0f, 18.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Singapore
+    { 12, 12.0f, 12.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // France
+    { 13, 18.0f, 17.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Turkey
+    { 14, 16.0f, 15.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Russia
+    { 15, 18.0f, 18.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Moonsighting Committee
+    { 16, 18.2f, 18.2f, false,  0.0f, true,  false, {0, -3, 3, 3, 3, 0} }, // Dubai
+    { 17, 20.0f, 18.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // JAKIM, Malaysia
+    { 18, 18.0f, 18.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Tunisia
+    { 19, 18.0f, 17.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Algeria
+    { 20, 20.0f, 18.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // KEMENAG, Indonesia
+    { 21, 19.0f, 17.0f, false,  0.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Morocco
+    { 22, 18.0f, 77.0f, true,   3.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Portugal
+    { 23, 18.0f, 18.0f, false,  5.0f, true,  false, {0, 0, 0, 0, 0, 0} },  // Jordan
+};
+
+// Solar coordinate coefficients (USNO low precision formulas)
+static constexpr double J2000 = 2451545.0;
+static constexpr double MEAN_ANOMALY[2] = {357.529, 0.98560028};
+static constexpr double MEAN_LONGITUDE[2] = {280.459, 0.98564736};
+static constexpr double ECLIPTIC_TERMS[2] = {1.915, 0.020};
+static constexpr double OBLIQUITY[2] = {23.439, -0.00000036};
+static constexpr double RISE_SET_ANGLE = 0.833;
+static constexpr int IMSAK_MINUTES = 10;
+
+// First-guess times of day (hours) used for the single refinement pass
+static constexpr double defaultHours[] = {5, 6, 12, 13, 18, 18, 18, 5};
+
+static constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+static double dsin(double d) { return sin(d * DEG_TO_RAD); }
+static double dcos(double d) { return cos(d * DEG_TO_RAD); }
+static double dtan(double d) { return tan(d * DEG_TO_RAD); }
+static double darcsin(double x) { return asin(x) / DEG_TO_RAD; }
+static double darccos(double x) { return acos(x) / DEG_TO_RAD; }
+static double darctan2(double y, double x) { return atan2(y, x) / DEG_TO_RAD; }
+static double darccot(double x) { return atan(1.0 / x) / DEG_TO_RAD; }
+
+static double fixRange(double value, double range) {
+    value = value - range * floor(value / range);
+    return value < 0 ? value + range : value;
+}
+
+// Hours from t1 forward to t2, wrapping through midnight
+static double timeDiff(double t1, double t2) {
+    return fixRange(t2 - t1, 24.0);
+}
+
+static double julianDate(int year, int month, int day) {
+    if (month <= 2) {
+        year -= 1;
+        month += 12;
+    }
+    double a = floor(year / 100.0);
+    double b = 2 - a + floor(a / 4.0);
+    return floor(365.25 * (year + 4716)) + floor(30.6001 * (month + 1)) + day + b - 1524.5;
+}
+
+// Solar declination (degrees) and equation of time (hours)
+static void sunPosition(double jd, double& declination, double& equation) {
+    double d = jd - J2000;
+    double g = fixRange(MEAN_ANOMALY[0] + MEAN_ANOMALY[1] * d, 360.0);
+    double q = fixRange(MEAN_LONGITUDE[0] + MEAN_LONGITUDE[1] * d, 360.0);
+    double l = fixRange(q + ECLIPTIC_TERMS[0] * dsin(g) + ECLIPTIC_TERMS[1] * dsin(2 * g), 360.0);
+    double e = OBLIQUITY[0] + OBLIQUITY[1] * d;
+
+    double ra = darctan2(dcos(e) * dsin(l), dcos(l)) / 15.0;
+    equation = q / 15.0 - fixRange(ra, 24.0);
+    declination = darcsin(dsin(e) * dsin(l));
+}
+
+struct SolarContext {
+    double julian;
+    double latitude;
+};
+
+static double midDay(const SolarContext& ctx, double dayPortion) {
+    double decl, eqt;
+    sunPosition(ctx.julian + dayPortion, decl, eqt);
+    return fixRange(12.0 - eqt, 24.0);
+}
+
+// Time at which the sun reaches the given depression angle; NAN if it never does
+static double sunAngleTime(const SolarContext& ctx, double angle, double dayPortion, bool beforeNoon) {
+    double decl, eqt;
+    sunPosition(ctx.julian + dayPortion, decl, eqt);
+    double noon = midDay(ctx, dayPortion);
+    double cosT = (-dsin(angle) - dsin(decl) * dsin(ctx.latitude)) /
+                  (dcos(decl) * dcos(ctx.latitude));
+    if (cosT < -1.0 || cosT > 1.0) {
+        return NAN;
+    }
+    double t = darccos(cosT) / 15.0;
+    return noon + (beforeNoon ? -t : t);
+}
+
+static double asrTime(const SolarContext& ctx, int factor, double dayPortion) {
+    double decl, eqt;
+    sunPosition(ctx.julian + dayPortion, decl, eqt);
+    double angle = -darccot(factor + dtan(fabs(ctx.latitude - decl)));
+    return sunAngleTime(ctx, angle, dayPortion, false);
+}
+
+// Angle-based rule: clamp a twilight time to a fraction of the night
+static double adjustHighLatitude(double time, double base, double angle, double night, bool beforeBase) {
+    double portion = angle / 60.0 * night;
+    double diff = beforeBase ? timeDiff(time, base) : timeDiff(base, time);
+    if (isnan(time) || diff > portion) {
+        return base + (beforeBase ? -portion : portion);
+    }
+    return time;
+}
+
+static int16_t toMinutes(double hours) {
+    if (isnan(hours)) {
+        return -1;
+    }
+    // Round to the nearest minute like the API does
+    return (int16_t)((int)floor(fixRange(hours + 0.5 / 60.0, 24.0) * 60.0) % 1440);
+}
+
+const CalculationMethod* findCalculationMethod(uint8_t id) {
+    for (const CalculationMethod& method : calculationMethods) {
+        if (method.id == id) {
+            return &method;
+        }
+    }
+    return nullptr;
+}
+
+bool computePrayerTimes(int year, int month, int day, double latitude, double longitude,
+                        double timezoneHours, uint8_t methodId, PrayerTimes& out,
+                        int asrFactor) {
+    const CalculationMethod* method = findCalculationMethod(methodId);
+    if (method == nullptr || latitude < -90.0 || latitude > 90.0 ||
+        longitude < -180.0 || longitude > 180.0) {
+        return false;
+    }
+
+    SolarContext ctx;
+    ctx.julian = julianDate(year, month, day) - longitude / (15.0 * 24.0);
+    ctx.latitude = latitude;
+
+    double portion[8];
+    for (int i = 0; i < 8; i++) {
+        portion[i] = defaultHours[i] / 24.0;
+    }
+
+    double fajr = sunAngleTime(ctx, method->fajrAngle, portion[0], true);
+    double sunrise = sunAngleTime(ctx, RISE_SET_ANGLE, portion[1], true);
+    double dhuhr = midDay(ctx, portion[2]);
+    double asr = asrTime(ctx, asrFactor, portion[3]);
+    double sunset = sunAngleTime(ctx, RISE_SET_ANGLE, portion[4], false);
+    double maghrib = method->maghribIsMinutes
+                         ? sunset
+                         : sunAngleTime(ctx, method->maghribValue, portion[5], false);
+    double isha = method->ishaIsMinutes
+                      ? NAN
+                      : sunAngleTime(ctx, method->ishaValue, portion[6], false);
+
+    // Shift from solar time at the meridian to the local time zone
+    double shift = timezoneHours - longitude / 15.0;
+    fajr += shift;
+    sunrise += shift;
+    dhuhr += shift;
+    asr += shift;
+    sunset += shift;
+    maghrib += shift;
+    isha += shift;
+
+    if (isnan(sunrise) || isnan(sunset)) {
+        return false;  // Polar day or night
+    }
+
+    double night = timeDiff(sunset, sunrise);
+    fajr = adjustHighLatitude(fajr, sunrise, method->fajrAngle, night, true);
+    if (!method->ishaIsMinutes) {
+        isha = adjustHighLatitude(isha, sunset, method->ishaValue, night, false);
+    }
+    if (!method->maghribIsMinutes) {
+        maghrib = adjustHighLatitude(maghrib, sunset, method->maghribValue, night, false);
+    }
+
+    if (method->maghribIsMinutes) {
+        maghrib = sunset + method->maghribValue / 60.0;
+    }
+    if (method->ishaIsMinutes) {
+        isha = maghrib + method->ishaValue / 60.0;
+    }
+    double imsak = fajr - IMSAK_MINUTES / 60.0;
+
+    // Night runs from sunset to sunrise (or to Fajr for Jafari midnight)
+    double nightEnd = method->jafariMidnight ? fajr : sunrise;
+    double nightLength = timeDiff(sunset, nightEnd);
+    double midnight = sunset + nightLength / 2.0;
+    double firstThird = sunset + nightLength / 3.0;
+    double lastThird = sunset + nightLength * 2.0 / 3.0;
+
+    double mainTimes[MAIN_TIMING_COUNT] = {fajr, sunrise, dhuhr, asr, maghrib, isha};
+    for (int i = 0; i < MAIN_TIMING_COUNT; i++) {
+        out.minutes[i] = toMinutes(mainTimes[i] + method->offsets[i] / 60.0);
+    }
+    out.minutes[PRAYER_SUNSET] = toMinutes(sunset);
+    out.minutes[PRAYER_IMSAK] = toMinutes(imsak);
+    out.minutes[PRAYER_MIDNIGHT] = toMinutes(midnight);
+    out.minutes[PRAYER_FIRST_THIRD] = toMinutes(firstThird);
+    out.minutes[PRAYER_LAST_THIRD] = toMinutes(lastThird);
+    return true;
+}
@@ -0,0 +1,51 @@
+// prayer_times.h
+#ifndef PRAYER_TIMES_H
+#define PRAYER_TIMES_H
+
+#include <stdint.h>
+
+// Indexes into PrayerTimes::minutes. The first six match mainTimingNames and
+// the rest match otherTimingNames (offset by PRAYER_SUNSET).
+enum PrayerTimeIndex {
+    PRAYER_FAJR = 0,
+    PRAYER_SUNRISE,
+    PRAYER_DHUHR,
+    PRAYER_ASR,
+    PRAYER_MAGHRIB,
+    PRAYER_ISHA,
+    PRAYER_SUNSET,
+    PRAYER_IMSAK,
+    PRAYER_MIDNIGHT,
+    PRAYER_FIRST_THIRD,
+    PRAYER_LAST_THIRD,
+    PRAYER_TIME_COUNT
+};
+
+#define MAIN_TIMING_COUNT 6
+#define OTHER_TIMING_COUNT 5
+
+// Calculation method parameters, numbered like the Aladhan API "method" argument
+struct CalculationMethod {
+    uint8_t id;
+    float fajrAngle;
+    float ishaValue;         // Degrees, or minutes after Maghrib when ishaIsMinutes
+    bool ishaIsMinutes;
+    float maghribValue;      // Degrees, or minutes after sunset when maghribIsMinutes
+    bool maghribIsMinutes;
+    bool jafariMidnight;     // Midnight measured from sunset to Fajr instead of sunrise
+    int8_t offsets[MAIN_TIMING_COUNT];  // Per-prayer minute tune, as applied by Aladhan
+};
+
+// Computed times in minutes since local midnight (0..1439), -1 if undefined
+struct PrayerTimes {
+    int16_t minutes[PRAYER_TIME_COUNT];
+};
+
+const CalculationMethod* findCalculationMethod(uint8_t id);
+
+// Compute all times for one date. asrFactor is 1 (Shafi) or 2 (Hanafi).
+bool computePrayerTimes(int year, int month, int day, double latitude, double longitude,
+                        double timezoneHours, uint8_t methodId, PrayerTimes& out,
+                        int asrFactor = 1);
+
+#endif
@@ -0,0 +1,30 @@
+// provisioning.cpp
+// The image is read in place through the flash cache, so looking up a window
+// costs no RAM beyond the decoded days.
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "provisioning.h"
+
+static const uint8_t* mappedImage = nullptr;
+static size_t mappedSize = 0;
+static bool mapAttempted = false;
+
+const uint8_t* provisionedScheduleImage(ProvisionHeader& header) {
+    if (!mapAttempted) {
+        mapAttempted = true;
+        const esp_partition_t* partition =
+            esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PROVISION_PARTITION_LABEL);
+        const void* mapped = nullptr;
+        spi_flash_mmap_handle_t handle;
+        if (partition != nullptr &&
+            esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &mapped, &handle) == ESP_OK) {
+            mappedImage = (const uint8_t*)mapped;
+            mappedSize = partition->size;
+            Serial.printf("Schedule partition mapped (%u bytes).\n", (unsigned)partition->size);
+        }
+    }
+    if (mappedImage == nullptr) {
+        return nullptr;
+    }
+    return provisionedSchedule(mappedImage, mappedSize, header);
+}
@@ -0,0 +1,12 @@
+// provisioning.h
+#ifndef PROVISIONING_H
+#define PROVISIONING_H
+
+#include "schedule_store.h"
+
+// Map the schedule partition (PROVISION_PARTITION_LABEL) once and keep it
+// mapped. Returns the schedule blob of a valid image and fills in its header,
+// or nullptr when the partition is missing, blank or corrupt.
+const uint8_t* provisionedScheduleImage(ProvisionHeader& header);
+
+#endif
@@ -0,0 +1,187 @@
+// schedule_store.cpp
+#include "schedule_store.h"
+#include <string.h>
+
+// Days since 1970-01-01 for a civil date (proleptic Gregorian)
+static long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yoe = year - era * 400;
+    long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Smallest signed difference between two minute-of-day values
+static int minuteDelta(int from, int to) {
+    int delta = (to - from) % 1440;
+    if (delta >= 720) delta -= 1440;
+    if (delta < -720) delta += 1440;
+    return delta;
+}
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+size_t encodeSchedule(const PrayerTimes* days, uint16_t dayCount, int startYear, int startMonth,
+                      int startDay, uint8_t* out, size_t capacity) {
+    size_t size = scheduleBlobSize(dayCount);
+    if (dayCount == 0 || size > capacity || size - sizeof(ScheduleHeader) > 0xFFFF) {
+        return 0;
+    }
+
+    uint16_t blockCount = (dayCount + SCHEDULE_KEYFRAME_INTERVAL - 1) / SCHEDULE_KEYFRAME_INTERVAL;
+    uint8_t* payload = out + sizeof(ScheduleHeader);
+    uint16_t* keyframes = (uint16_t*)payload;
+    int8_t* deltas = (int8_t*)(payload + blockCount * PRAYER_TIME_COUNT * sizeof(uint16_t));
+
+    for (uint16_t d = 0; d < dayCount; d++) {
+        const PrayerTimes& key = days[d - d % SCHEDULE_KEYFRAME_INTERVAL];
+        for (int t = 0; t < PRAYER_TIME_COUNT; t++) {
+            int16_t value = days[d].minutes[t];
+            if (d % SCHEDULE_KEYFRAME_INTERVAL == 0) {
+                keyframes[(d / SCHEDULE_KEYFRAME_INTERVAL) * PRAYER_TIME_COUNT + t] =
+                    value < 0 ? SCHEDULE_UNDEFINED_KEYFRAME : (uint16_t)value;
+            }
+
+            int8_t* delta = &deltas[d * PRAYER_TIME_COUNT + t];
+            if (value < 0 || key.minutes[t] < 0) {
+                if (value >= 0) {
+                    return 0;  // A defined time cannot be expressed against an undefined keyframe
+                }
+                *delta = SCHEDULE_UNDEFINED_DELTA;
+                continue;
+            }
+            int diff = minuteDelta(key.minutes[t], value);
+            if (diff <= SCHEDULE_UNDEFINED_DELTA || diff > 127) {
+                return 0;
+            }
+            *delta = (int8_t)diff;
+        }
+    }
+
+    ScheduleHeader header;
+    header.magic = SCHEDULE_MAGIC;
+    header.version = SCHEDULE_VERSION;
+    header.timingCount = PRAYER_TIME_COUNT;
+    header.keyframeInterval = SCHEDULE_KEYFRAME_INTERVAL;
+    header.reserved = 0;
+    header.startYear = startYear;
+    header.startMonth = startMonth;
+    header.startDay = startDay;
+    header.dayCount = dayCount;
+    header.payloadSize = size - sizeof(ScheduleHeader);
+    header.crc = crc32(payload, header.payloadSize);
+    memcpy(out, &header, sizeof(header));
+    return size;
+}
+
+bool validateSchedule(const uint8_t* blob, size_t size) {
+    if (size < sizeof(ScheduleHeader)) {
+        return false;
+    }
+    ScheduleHeader header;
+    memcpy(&header, blob, sizeof(header));
+    if (header.magic != SCHEDULE_MAGIC || header.version != SCHEDULE_VERSION ||
+        header.timingCount != PRAYER_TIME_COUNT ||
+        header.keyframeInterval != SCHEDULE_KEYFRAME_INTERVAL ||
+        header.dayCount == 0 ||
+        header.payloadSize != scheduleBlobSize(header.dayCount) - sizeof(ScheduleHeader) ||
+        sizeof(ScheduleHeader) + header.payloadSize > size) {
+        return false;
+    }
+    return crc32(blob + sizeof(ScheduleHeader), header.payloadSize) == header.crc;
+}
+
+long scheduleDayIndex(const uint8_t* blob, int year, int month, int day) {
+    const ScheduleHeader* header = (const ScheduleHeader*)blob;
+    return daysFromCivil(year, month, day) -
+           daysFromCivil(header->startYear, header->startMonth, header->startDay);
+}
+
+// Decode the row of the index-th stored day
+static void decodeScheduleRow(const uint8_t* blob, long index, PrayerTimes& out) {
+    const ScheduleHeader* header = (const ScheduleHeader*)blob;
+    uint16_t blockCount = (header->dayCount + SCHEDULE_KEYFRAME_INTERVAL - 1) / SCHEDULE_KEYFRAME_INTERVAL;
+    const uint8_t* payload = blob + sizeof(ScheduleHeader);
+    const uint16_t* keyframe = (const uint16_t*)payload + (index / SCHEDULE_KEYFRAME_INTERVAL) * PRAYER_TIME_COUNT;
+    const int8_t* delta = (const int8_t*)(payload + blockCount * PRAYER_TIME_COUNT * sizeof(uint16_t)) +
+                          index * PRAYER_TIME_COUNT;
+
+    for (int t = 0; t < PRAYER_TIME_COUNT; t++) {
+        if (keyframe[t] == SCHEDULE_UNDEFINED_KEYFRAME || delta[t] == SCHEDULE_UNDEFINED_DELTA) {
+            out.minutes[t] = -1;
+        } else {
+            out.minutes[t] = (int16_t)((keyframe[t] + delta[t] + 1440) % 1440);
+        }
+    }
+}
+
+bool readScheduleDay(const uint8_t* blob, int year, int month, int day, PrayerTimes& out) {
+    const ScheduleHeader* header = (const ScheduleHeader*)blob;
+    long index = scheduleDayIndex(blob, year, month, day);
+    if (index < 0 || index >= header->dayCount) {
+        return false;
+    }
+    decodeScheduleRow(blob, index, out);
+    return true;
+}
+
+size_t copyScheduleWindow(const uint8_t* blob, int year, int month, int day, uint16_t dayCount, uint8_t* out,
+                          size_t capacity) {
+    const ScheduleHeader* header = (const ScheduleHeader*)blob;
+    long first = scheduleDayIndex(blob, year, month, day);
+    if (first < 0 || first >= header->dayCount) {
+        return 0;
+    }
+    if (dayCount > header->dayCount - first) {
+        dayCount = header->dayCount - first;
+    }
+    if (dayCount > SCHEDULE_DAYS) {
+        dayCount = SCHEDULE_DAYS;
+    }
+
+    PrayerTimes days[SCHEDULE_DAYS];
+    for (uint16_t d = 0; d < dayCount; d++) {
+        decodeScheduleRow(blob, first + d, days[d]);
+    }
+    return encodeSchedule(days, dayCount, year, month, day, out, capacity);
+}
+
+size_t encodeProvisionImage(const ProvisionHeader& info, const uint8_t* schedule, size_t scheduleSize,
+                            uint8_t* out, size_t capacity) {
+    if (sizeof(ProvisionHeader) + scheduleSize > capacity || !validateSchedule(schedule, scheduleSize)) {
+        return 0;
+    }
+    ProvisionHeader header = info;
+    header.magic = PROVISION_MAGIC;
+    header.version = PROVISION_VERSION;
+    header.name[PROVISION_NAME_SIZE - 1] = '\0';
+    header.scheduleSize = scheduleSize;
+    header.crc = crc32((const uint8_t*)&header, offsetof(ProvisionHeader, crc));
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), schedule, scheduleSize);
+    return sizeof(header) + scheduleSize;
+}
+
+const uint8_t* provisionedSchedule(const uint8_t* image, size_t size, ProvisionHeader& header) {
+    if (size < sizeof(ProvisionHeader)) {
+        return nullptr;
+    }
+    memcpy(&header, image, sizeof(header));
+    if (header.magic != PROVISION_MAGIC || header.version != PROVISION_VERSION ||
+        header.crc != crc32((const uint8_t*)&header, offsetof(ProvisionHeader, crc)) ||
+        header.scheduleSize > size - sizeof(ProvisionHeader)) {
+        return nullptr;
+    }
+    const uint8_t* schedule = image + sizeof(ProvisionHeader);
+    return validateSchedule(schedule, header.scheduleSize) ? schedule : nullptr;
+}
@@ -0,0 +1,103 @@
+// schedule_store.h
+#ifndef SCHEDULE_STORE_H
+#define SCHEDULE_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "prayer_times.h"
+
+// Packed multi-day schedule blob. Layout:
+//   ScheduleHeader
+//   uint16_t keyframes[blockCount][PRAYER_TIME_COUNT]  absolute minutes, one row per block
+//   int8_t   deltas[dayCount][PRAYER_TIME_COUNT]       minutes relative to the block keyframe
+// A day is decoded from its block keyframe plus its own delta row, so lookup
+// is O(1) and the blob can be used in place (NVS blob copy or mapped partition).
+#define SCHEDULE_MAGIC 0x43535A41UL  // "AZSC"
+#define SCHEDULE_VERSION 1
+#define SCHEDULE_KEYFRAME_INTERVAL 16
+#define SCHEDULE_UNDEFINED_KEYFRAME 0xFFFF
+#define SCHEDULE_UNDEFINED_DELTA (-128)
+
+#ifndef SCHEDULE_DAYS
+#define SCHEDULE_DAYS 31  // Days calculated and stored per update
+#endif
+
+struct ScheduleHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t timingCount;
+    uint8_t keyframeInterval;
+    uint8_t reserved;
+    uint16_t startYear;
+    uint8_t startMonth;
+    uint8_t startDay;
+    uint16_t dayCount;
+    uint16_t payloadSize;
+    uint32_t crc;  // CRC-32 of the payload
+};
+
+static_assert(sizeof(ScheduleHeader) == 20, "ScheduleHeader must stay packed");
+
+// Bytes needed to store dayCount days
+constexpr size_t scheduleBlobSize(uint16_t dayCount) {
+    return sizeof(ScheduleHeader) +
+           ((dayCount + SCHEDULE_KEYFRAME_INTERVAL - 1) / SCHEDULE_KEYFRAME_INTERVAL) *
+               PRAYER_TIME_COUNT * sizeof(uint16_t) +
+           dayCount * PRAYER_TIME_COUNT;
+}
+
+// Encode consecutive days starting at the given date. Returns the blob size, or 0 on failure.
+size_t encodeSchedule(const PrayerTimes* days, uint16_t dayCount, int startYear, int startMonth,
+                      int startDay, uint8_t* out, size_t capacity);
+
+// Check magic, version and CRC of a stored blob
+bool validateSchedule(const uint8_t* blob, size_t size);
+
+// Decode the row for the given date. Returns false if it is outside the stored range.
+bool readScheduleDay(const uint8_t* blob, int year, int month, int day, PrayerTimes& out);
+
+// Days from the first stored day to the given date (negative if before it)
+long scheduleDayIndex(const uint8_t* blob, int year, int month, int day);
+
+// Re-encode up to dayCount days (at most SCHEDULE_DAYS) from the given date into out, e.g. a
+// month out of a year-long image. Returns the blob size, or 0 if the date is
+// not covered.
+size_t copyScheduleWindow(const uint8_t* blob, int year, int month, int day, uint16_t dayCount, uint8_t* out,
+                          size_t capacity);
+
+uint32_t crc32(const uint8_t* data, size_t length);
+
+// Provisioning image, flashed to its own data partition next to the firmware
+// (made by tools/make_schedules.cpp). Layout:
+//   ProvisionHeader
+//   schedule blob, as above, usually a whole year
+// It carries what the schedule was calculated for, so a clock that has never
+// been online can show times and calculate the next ones itself.
+#define PROVISION_MAGIC 0x56505A41UL  // "AZPV"
+#define PROVISION_VERSION 1
+#define PROVISION_PARTITION_LABEL "schedule"
+#define PROVISION_PARTITION_SIZE 0x10000
+#define PROVISION_NAME_SIZE 32
+
+struct ProvisionHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t method;             // Aladhan method id
+    int16_t timezoneMinutes;    // Local time the schedule is in, east of UTC
+    double latitude;
+    double longitude;
+    char name[PROVISION_NAME_SIZE];  // City or site, NUL-terminated
+    uint32_t scheduleSize;
+    uint32_t crc;               // CRC-32 of the header up to this field
+};
+
+static_assert(sizeof(ProvisionHeader) == 64, "ProvisionHeader must stay packed");
+
+// Wrap a schedule blob into a provisioning image. Returns the image size, or 0 if it does not fit.
+size_t encodeProvisionImage(const ProvisionHeader& info, const uint8_t* schedule, size_t scheduleSize,
+                            uint8_t* out, size_t capacity);
+
+// Check an image and its schedule; returns the schedule blob inside it, or nullptr
+const uint8_t* provisionedSchedule(const uint8_t* image, size_t size, ProvisionHeader& header);
+
+#endif
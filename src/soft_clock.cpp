@@ -0,0 +1,132 @@
+// soft_clock.cpp
+// Seconds counter advanced by the DS3231 SQW falling edge. The DS3231 updates
+// its time registers on that edge, so the counter stays in phase with the RTC
+// and the display can redraw exactly when the second changes.
+#include <Arduino.h>
+#include "soft_clock.h"
+
+static RTC_DS3231* clockRtc = nullptr;
+static volatile uint32_t epochSeconds = 0;
+static volatile uint32_t edgeCount = 0;
+static volatile unsigned long lastEdgeMillis = 0;
+static volatile unsigned long lastEdgeMicros = 0;
+static portMUX_TYPE clockMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t seenEdgeCount = 0;
+static unsigned long lastResyncMillis = 0;
+static unsigned long fallbackMillis = 0;
+static bool usingSqw = false;
+static bool resyncRequested = false;
+
+static void IRAM_ATTR onSqwEdge() {
+    portENTER_CRITICAL_ISR(&clockMux);
+    epochSeconds++;
+    edgeCount++;
+    lastEdgeMillis = millis();
+    lastEdgeMicros = micros();
+    portEXIT_CRITICAL_ISR(&clockMux);
+}
+
+// Load the counter from the RTC. Called just after a second edge, so the
+// next edge is nearly a second away and cannot land inside the I2C read.
+static void resyncFromRtc(unsigned long nowMillis) {
+    DateTime rtcNow = clockRtc->now();
+
+    portENTER_CRITICAL(&clockMux);
+    int32_t drift = (int32_t)(epochSeconds - rtcNow.unixtime());
+    epochSeconds = rtcNow.unixtime();
+    portEXIT_CRITICAL(&clockMux);
+
+    if (lastResyncMillis != 0 && drift != 0 && !resyncRequested) {  // Expected after a sleep
+        Serial.printf("Soft clock resynced, off by %d s\n", (int)drift);
+    }
+    lastResyncMillis = nowMillis;
+    resyncRequested = false;
+    if (!usingSqw) {
+        fallbackMillis = nowMillis;
+    }
+}
+
+void beginSoftClock(RTC_DS3231* rtc, int sqwPin) {
+    clockRtc = rtc;
+    rtc->writeSqwPinMode(DS3231_SquareWave1Hz);
+
+    pinMode(sqwPin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(sqwPin), onSqwEdge, FALLING);
+
+    // Seed right after an edge so the counter starts in phase with the RTC
+    unsigned long start = millis();
+    uint32_t edges = edgeCount;
+    while (edgeCount == edges && millis() - start < SOFT_CLOCK_EDGE_TIMEOUT_MS) {
+        delay(1);
+    }
+    usingSqw = edgeCount != edges;
+    seenEdgeCount = edgeCount;
+    resyncFromRtc(millis());
+
+    Serial.println(usingSqw ? "Soft clock running from RTC SQW." : "No RTC SQW edges, soft clock using millis().");
+}
+
+DateTime softClockNow() {
+    return DateTime(epochSeconds);
+}
+
+int64_t softClockMicros() {
+    portENTER_CRITICAL(&clockMux);
+    uint32_t seconds = epochSeconds;
+    unsigned long sinceTick = usingSqw ? micros() - lastEdgeMicros : (millis() - fallbackMillis) * 1000UL;
+    portEXIT_CRITICAL(&clockMux);
+
+    if (sinceTick > 999999UL) {
+        sinceTick = 999999UL;  // The next edge is overdue; the counter has not moved yet
+    }
+    return (int64_t)seconds * 1000000LL + sinceTick;
+}
+
+void setSoftClock(const DateTime& time) {
+    portENTER_CRITICAL(&clockMux);
+    epochSeconds = time.unixtime();
+    portEXIT_CRITICAL(&clockMux);
+    lastResyncMillis = millis();
+}
+
+bool updateSoftClock(unsigned long nowMillis) {
+    if (clockRtc == nullptr) {
+        return false;
+    }
+
+    bool ticked = false;
+    uint32_t edges = edgeCount;
+    if (edges != seenEdgeCount) {
+        seenEdgeCount = edges;
+        usingSqw = true;
+        ticked = true;
+    } else if (usingSqw && nowMillis - lastEdgeMillis >= SOFT_CLOCK_EDGE_TIMEOUT_MS) {
+        // SQW missing: advance from millis() until edges come back
+        Serial.println("RTC SQW stopped, soft clock using millis().");
+        usingSqw = false;
+        fallbackMillis = lastEdgeMillis;
+    }
+
+    if (!usingSqw && nowMillis - fallbackMillis >= 1000) {
+        fallbackMillis += 1000;
+        portENTER_CRITICAL(&clockMux);
+        epochSeconds++;
+        portEXIT_CRITICAL(&clockMux);
+        ticked = true;
+    }
+
+    if (ticked && (resyncRequested || nowMillis - lastResyncMillis >= SOFT_CLOCK_RESYNC_MS)) {
+        resyncFromRtc(nowMillis);
+    }
+    return ticked;
+}
+
+void requestSoftClockResync() {
+    resyncRequested = true;
+    lastEdgeMillis = millis();  // Give the SQW a moment before assuming it stopped
+}
+
+bool softClockUsingSqw() {
+    return usingSqw;
+}
@@ -0,0 +1,34 @@
+// soft_clock.h
+#ifndef SOFT_CLOCK_H
+#define SOFT_CLOCK_H
+
+#include <RTClib.h>
+
+#define SOFT_CLOCK_RESYNC_MS 3600000UL   // Full RTC read once per hour
+#define SOFT_CLOCK_EDGE_TIMEOUT_MS 1500  // No SQW edge for this long: fall back to millis()
+
+// Enable the DS3231 1 Hz square wave on sqwPin and seed the counter from the RTC.
+// The SQW output is open-drain, so the pin uses the internal pull-up.
+void beginSoftClock(RTC_DS3231* rtc, int sqwPin);
+
+// Current time from the in-RAM counter; no I2C traffic
+DateTime softClockNow();
+
+// Current time in microseconds (local epoch), interpolated from the last SQW edge.
+// Safe from any task; used to compare the RTC with an NTP answer.
+int64_t softClockMicros();
+
+// Set the counter after the RTC itself has been adjusted
+void setSoftClock(const DateTime& time);
+
+// Call from loop(). Returns true once per second, right after the second edge.
+// Also performs the hourly resync against the RTC.
+bool updateSoftClock(unsigned long nowMillis);
+
+// Reload from the RTC on the next tick, e.g. after light sleep where edges were missed
+void requestSoftClockResync();
+
+// False while running on the millis() fallback (SQW not wired or not ticking)
+bool softClockUsingSqw();
+
+#endif
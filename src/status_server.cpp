@@ -0,0 +1,327 @@
+// status_server.cpp
+// One listening socket and a few client slots, all non-blocking. A client is
+// read until the blank line that ends its headers, then pointed at the
+// response buffer of its page and fed with send() until it has all of it.
+// A page is not rebuilt while a client is still being sent it; that client
+// keeps the version it started with and later ones may get it too, at most
+// one rebuild late.
+#include <WiFi.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <lwip/sockets.h>
+#include <stdarg.h>
+#include "status_server.h"
+#include "telemetry.h"
+
+static const char pageHeaderFormat[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+    "Cache-Control: no-store\r\nConnection: close\r\n\r\n";
+static const char badRequestResponse[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char notFoundResponse[] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char notAllowedResponse[] =
+    "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char tooLargeResponse[] =
+    "HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char unavailableResponse[] =
+    "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+struct StatusPage {
+    StatusPageWriter writer;
+    bool live;
+    bool stale;
+    uint8_t readers;          // Clients still being sent this page
+    unsigned long builtMs;
+    const char* response;     // Header start, inside buffer
+    size_t headerLength;
+    size_t length;            // Header plus body, 0 until built
+    char buffer[STATUS_PAGE_SIZE];
+};
+
+struct StatusClient {
+    int socket;               // -1 when the slot is free
+    int8_t page;              // Page being sent, -1 for a fixed answer
+    unsigned long openedMs;
+    size_t received;
+    const char* response;     // nullptr while the request is read
+    size_t length;
+    size_t sent;
+    char request[STATUS_SERVER_REQUEST_SIZE];
+};
+
+static StatusPage pages[STATUS_PAGE_COUNT];
+static StatusClient clients[STATUS_SERVER_MAX_CLIENTS];
+static StatusServerStats stats = {0, 0, 0, 0, 0, 0};
+static int listener = -1;
+static uint16_t serverPort = 0;
+static bool started = false;
+static bool listenFailed = false;
+
+void beginStatusServer(uint16_t port) {
+    serverPort = port;
+    started = true;
+    for (StatusClient& client : clients) {
+        client.socket = -1;
+    }
+}
+
+void setStatusPageWriter(StatusPageId page, StatusPageWriter writer, bool live) {
+    pages[page].writer = writer;
+    pages[page].live = live;
+    pages[page].stale = true;
+}
+
+void invalidateStatusPage(StatusPageId page) {
+    pages[page].stale = true;
+}
+
+const StatusServerStats& statusServerStats() {
+    return stats;
+}
+
+void statusPrintf(StatusBody& body, const char* format, ...) {
+    if (body.overflow) {
+        return;
+    }
+    va_list arguments;
+    va_start(arguments, format);
+    size_t room = body.capacity - body.length;
+    int written = vsnprintf(body.text + body.length, room, format, arguments);
+    va_end(arguments);
+    if (written < 0 || (size_t)written >= room) {
+        body.overflow = true;
+    } else {
+        body.length += written;
+    }
+}
+
+static void appendChar(StatusBody& body, char c) {
+    if (body.overflow || body.length + 1 >= body.capacity) {
+        body.overflow = true;
+        return;
+    }
+    body.text[body.length++] = c;
+    body.text[body.length] = '\0';
+}
+
+void statusPrintString(StatusBody& body, const char* text) {
+    appendChar(body, '"');
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            statusPrintf(body, "\\%c", *c);
+        } else if ((uint8_t)*c < 0x20) {
+            statusPrintf(body, "\\u%04x", (unsigned)*c);
+        } else {
+            appendChar(body, *c);
+        }
+    }
+    appendChar(body, '"');
+}
+
+static bool openListener() {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        return false;
+    }
+    int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(serverPort);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(fd, STATUS_SERVER_BACKLOG) < 0) {
+        Serial.printf("Status server cannot listen on port %u.\n", (unsigned)serverPort);
+        close(fd);
+        listenFailed = true;
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    listener = fd;
+    Serial.printf("Status server listening on port %u.\n", (unsigned)serverPort);
+    return true;
+}
+
+// Function to rebuild a page if it is due and no client is reading it; false if there is nothing to serve
+static bool refreshPage(StatusPage& page, unsigned long nowMillis) {
+    bool due = page.stale || page.length == 0 || (page.live && nowMillis - page.builtMs >= STATUS_PAGE_MAX_AGE_MS);
+    if (!due || page.readers > 0 || page.writer == nullptr) {
+        return page.length > 0;
+    }
+
+    uint32_t start = micros();
+    StatusBody body = {page.buffer + STATUS_SERVER_HEADER_RESERVE, sizeof(page.buffer) - STATUS_SERVER_HEADER_RESERVE,
+                       0, false};
+    if (!page.writer(body)) {
+        return page.length > 0;
+    }
+    if (body.overflow) {
+        Serial.println("Status page does not fit its buffer, not updated.");
+        return page.length > 0;
+    }
+
+    // The header goes right in front of the body, so the response is one contiguous block
+    char header[STATUS_SERVER_HEADER_RESERVE];
+    int headerLength = snprintf(header, sizeof(header), pageHeaderFormat, (unsigned)body.length);
+    char* response = body.text - headerLength;
+    memcpy(response, header, headerLength);
+    page.response = response;
+    page.headerLength = headerLength;
+    page.length = headerLength + body.length;
+    page.builtMs = nowMillis;
+    page.stale = false;
+
+    uint32_t elapsed = micros() - start;
+    stats.pageBuilds++;
+    if (elapsed > stats.maxBuildMicros) {
+        stats.maxBuildMicros = elapsed;
+    }
+    return true;
+}
+
+static void respondWith(StatusClient& client, const char* response, size_t length) {
+    client.response = response;
+    client.length = length;
+    client.sent = 0;
+}
+
+// Function to pick the answer for a complete request
+static void routeRequest(StatusClient& client, unsigned long nowMillis) {
+    const char* path;
+    bool head = false;
+    if (strncmp(client.request, "GET ", 4) == 0) {
+        path = client.request + 4;
+    } else if (strncmp(client.request, "HEAD ", 5) == 0) {
+        path = client.request + 5;
+        head = true;
+    } else {
+        stats.errors++;
+        respondWith(client, notAllowedResponse, sizeof(notAllowedResponse) - 1);
+        return;
+    }
+
+    size_t pathLength = strcspn(path, " ?\r\n");
+    if (path[pathLength] != ' ' && path[pathLength] != '?') {
+        stats.errors++;
+        respondWith(client, badRequestResponse, sizeof(badRequestResponse) - 1);
+        return;
+    }
+
+    int id = -1;
+    if ((pathLength == 7 && strncmp(path, "/status", 7) == 0) || (pathLength == 1 && path[0] == '/')) {
+        id = STATUS_PAGE_STATUS;
+    } else if (pathLength == 9 && strncmp(path, "/schedule", 9) == 0) {
+        id = STATUS_PAGE_SCHEDULE;
+    }
+    if (id < 0) {
+        stats.errors++;
+        respondWith(client, notFoundResponse, sizeof(notFoundResponse) - 1);
+        return;
+    }
+
+    StatusPage& page = pages[id];
+    if (!refreshPage(page, nowMillis)) {
+        respondWith(client, unavailableResponse, sizeof(unavailableResponse) - 1);
+        return;
+    }
+    page.readers++;
+    client.page = id;
+    stats.requests++;
+    respondWith(client, page.response, head ? page.headerLength : page.length);
+}
+
+static void closeClient(StatusClient& client) {
+    close(client.socket);
+    client.socket = -1;
+    if (client.page >= 0) {
+        pages[client.page].readers--;
+    }
+}
+
+// Function to move one client along; returns true if anything happened
+static bool serviceClient(StatusClient& client, unsigned long nowMillis) {
+    if (nowMillis - client.openedMs > STATUS_SERVER_TIMEOUT_MS) {
+        stats.errors++;
+        closeClient(client);
+        return true;
+    }
+
+    if (client.response == nullptr) {
+        int received = recv(client.socket, client.request + client.received,
+                            sizeof(client.request) - 1 - client.received, MSG_DONTWAIT);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return false;
+        }
+        if (received <= 0) {
+            stats.errors++;
+            closeClient(client);
+            return true;
+        }
+        client.received += received;
+        client.request[client.received] = '\0';
+        if (strstr(client.request, "\r\n\r\n") != nullptr) {
+            routeRequest(client, nowMillis);
+        } else if (client.received == sizeof(client.request) - 1) {
+            stats.errors++;
+            respondWith(client, tooLargeResponse, sizeof(tooLargeResponse) - 1);
+        } else {
+            return true;
+        }
+    }
+
+    int sent = send(client.socket, client.response + client.sent, client.length - client.sent, MSG_DONTWAIT);
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return false;
+    }
+    if (sent < 0) {
+        stats.errors++;
+        closeClient(client);
+        return true;
+    }
+    client.sent += sent;
+    stats.bytesSent += sent;
+    if (client.sent == client.length) {
+        closeClient(client);
+    }
+    return true;
+}
+
+void serviceStatusServer(unsigned long nowMillis) {
+    if (listener < 0) {
+        if (!started || listenFailed || WiFi.status() != WL_CONNECTED || !openListener()) {
+            return;
+        }
+    }
+
+    uint32_t start = telemetryStart();
+    bool worked = false;
+    for (StatusClient& client : clients) {
+        if (client.socket >= 0) {
+            continue;
+        }
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            break;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        client.socket = fd;
+        client.page = -1;
+        client.openedMs = nowMillis;
+        client.received = 0;
+        client.response = nullptr;
+        worked = true;
+    }
+    for (StatusClient& client : clients) {
+        if (client.socket >= 0 && serviceClient(client, nowMillis)) {
+            worked = true;
+        }
+    }
+
+    if (worked) {
+        uint32_t elapsed = micros() - start;
+        if (elapsed > stats.maxPassMicros) {
+            stats.maxPassMicros = elapsed;
+        }
+        telemetryRecord(TELEMETRY_HTTP, start);
+    }
+}
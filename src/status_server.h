@@ -0,0 +1,74 @@
+// status_server.h
+#ifndef STATUS_SERVER_H
+#define STATUS_SERVER_H
+
+#include <Arduino.h>
+
+// Minimal HTTP/1.1 server for reading the clock's state over Wi-Fi. It is
+// polled from loop() on non-blocking sockets, so a pass never waits on the
+// network. Each page is kept as a complete response (header and JSON body)
+// in a static buffer and sent from there; it is rebuilt only when stale,
+// not per request.
+#ifndef STATUS_SERVER_PORT
+#define STATUS_SERVER_PORT 80
+#endif
+#define STATUS_SERVER_BACKLOG 8
+#define STATUS_SERVER_MAX_CLIENTS 4         // Connections served at once; more wait in the backlog
+#define STATUS_SERVER_REQUEST_SIZE 256      // Request line and headers; longer requests get a 431
+#define STATUS_SERVER_TIMEOUT_MS 2000       // Drop a client that has not finished its request by then
+#define STATUS_SERVER_HEADER_RESERVE 128    // Room in front of a page body for its response header
+#define STATUS_PAGE_SIZE 1536               // Header plus body
+#define STATUS_PAGE_MAX_AGE_MS 1000         // Pages marked live are rebuilt at most this often
+
+enum StatusPageId : uint8_t {
+    STATUS_PAGE_STATUS,    // GET /status (also /)
+    STATUS_PAGE_SCHEDULE,  // GET /schedule
+    STATUS_PAGE_COUNT
+};
+
+// A page body being written; see statusPrintf()
+struct StatusBody {
+    char* text;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+};
+
+// Called on the loop task to write a page's JSON body. Return false to keep
+// serving the previous version.
+typedef bool (*StatusPageWriter)(StatusBody& body);
+
+struct StatusServerStats {
+    uint32_t requests;        // Pages served, HEAD included
+    uint32_t errors;          // 4xx answers, timeouts and connections reset
+    uint32_t pageBuilds;
+    uint32_t maxBuildMicros;  // Longest page rebuild
+    uint32_t maxPassMicros;   // Longest serviceStatusServer() call that had work to do
+    uint64_t bytesSent;
+};
+
+// Listening starts once Wi-Fi is connected
+void beginStatusServer(uint16_t port);
+
+// Set the writer of a page. A live page is rebuilt when it is requested and
+// older than STATUS_PAGE_MAX_AGE_MS; any other page only after
+// invalidateStatusPage(). Pages without a writer answer 503.
+void setStatusPageWriter(StatusPageId page, StatusPageWriter writer, bool live);
+
+// Rebuild the page before it is next served
+void invalidateStatusPage(StatusPageId page);
+
+// Call from loop() on every pass: accepts, reads and answers what it can
+// without blocking
+void serviceStatusServer(unsigned long nowMillis);
+
+// Append formatted text to a page body. Past the capacity, overflow is set and
+// the page is not published.
+void statusPrintf(StatusBody& body, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+// Append text as a quoted JSON string, escaping quotes and control characters
+void statusPrintString(StatusBody& body, const char* text);
+
+const StatusServerStats& statusServerStats();
+
+#endif
@@ -0,0 +1,51 @@
+// table_layer.cpp
+#include "table_layer.h"
+
+#define TABLE_LABEL_COLUMN_X 5
+#define TABLE_ROW_HEIGHT 8
+#define TABLE_CHAR_WIDTH 6  // Built-in 5x7 font at size 1, with spacing
+
+// Function to centre text of a given length within a column starting at columnX
+static int centredX(int columnX, size_t length) {
+    return columnX + (TABLE_COLUMN_WIDTH - (int)length * TABLE_CHAR_WIDTH) / 2;
+}
+
+void buildTableLayer(TableLayer& layer, Adafruit_SSD1306& display, const char* const* names, int rows) {
+    int width = display.width();
+    int height = display.height();
+
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.drawRect(0, 0, width, height, SSD1306_WHITE);
+    display.drawLine(width / 2, 0, width / 2, height, SSD1306_WHITE);
+
+    int y = TABLE_FIRST_ROW_Y;
+    for (int i = 0; i < rows; i++) {
+        display.setCursor(centredX(TABLE_LABEL_COLUMN_X, strlen(names[i])), y);
+        display.print(names[i]);
+
+        // A line under each row for separation, except the last row
+        if (i != rows - 1) {
+            display.drawLine(0, y + TABLE_ROW_HEIGHT, width, y + TABLE_ROW_HEIGHT, SSD1306_WHITE);
+        }
+        y += TABLE_ROW_PITCH;
+    }
+
+    memcpy(layer.chrome, display.getBuffer(), sizeof(layer.chrome));
+    layer.rows = rows;
+    layer.built = true;
+}
+
+void composeTable(const TableLayer& layer, Adafruit_SSD1306& display, const char* const* values) {
+    memcpy(display.getBuffer(), layer.chrome, sizeof(layer.chrome));
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+
+    int y = TABLE_FIRST_ROW_Y;
+    for (int i = 0; i < layer.rows; i++) {
+        display.setCursor(centredX(TABLE_VALUE_COLUMN_X, strlen(values[i])), y);
+        display.print(values[i]);
+        y += TABLE_ROW_PITCH;
+    }
+}
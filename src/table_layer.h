@@ -0,0 +1,32 @@
+// table_layer.h
+#ifndef TABLE_LAYER_H
+#define TABLE_LAYER_H
+
+#include <Adafruit_SSD1306.h>
+#include "display_flush.h"
+
+// The timing tables as two layers: the static chrome (border, centre divider,
+// row separators and the label column) is drawn once into its own framebuffer
+// image, and each frame copies it in with one memcpy and prints only the
+// value cells on top.
+#define TABLE_MAX_ROWS 6
+#define TABLE_VALUE_COLUMN_X 69   // Left edge of the value column
+#define TABLE_COLUMN_WIDTH 60     // Cells are centred within this
+#define TABLE_FIRST_ROW_Y 2
+#define TABLE_ROW_PITCH 10        // Text row plus separator and spacing
+
+struct TableLayer {
+    uint8_t chrome[DISPLAY_PAGES * DISPLAY_COLUMNS];
+    uint8_t rows;
+    bool built;
+};
+
+// Draw the chrome for rows labelled names[0..rows) into the layer. Uses the
+// display's framebuffer as scratch, so call it before drawing the frame.
+void buildTableLayer(TableLayer& layer, Adafruit_SSD1306& display, const char* const* names, int rows);
+
+// Copy the chrome into the framebuffer and print values[0..rows) centred in
+// the value column. Leaves the frame for the caller to flush.
+void composeTable(const TableLayer& layer, Adafruit_SSD1306& display, const char* const* values);
+
+#endif
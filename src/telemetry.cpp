@@ -0,0 +1,182 @@
+// telemetry.cpp
+#include "telemetry.h"
+#include "schedule_store.h"
+
+static const char* const sectionNames[TELEMETRY_SECTION_COUNT] = {
+    "loop", "render", "flush", "wifi_connect", "geolocate", "calculate", "download", "ntp_sync",
+    "tls_full", "tls_resumed", "http"};
+
+static portMUX_TYPE telemetryMux = portMUX_INITIALIZER_UNLOCKED;
+static TelemetryHistogram histograms[TELEMETRY_SECTION_COUNT];
+static TelemetryGauges gauges = {0, 0, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+// Loop task only
+static uint32_t loopStartMicros = 0;
+static bool loopStarted = false;
+static bool skipLoop = false;
+
+static uint8_t bucketFor(uint32_t micros) {
+    uint8_t bucket = 31 - __builtin_clz(micros | 1);
+    return bucket < TELEMETRY_BUCKETS ? bucket : TELEMETRY_BUCKETS - 1;
+}
+
+void telemetryRecord(TelemetrySection section, uint32_t startMicros) {
+    uint32_t elapsed = micros() - startMicros;
+    uint8_t bucket = bucketFor(elapsed);
+
+    portENTER_CRITICAL(&telemetryMux);
+    TelemetryHistogram& histogram = histograms[section];
+    histogram.count++;
+    histogram.totalMicros += elapsed;
+    histogram.buckets[bucket]++;
+    if (elapsed > histogram.maxMicros) {
+        histogram.maxMicros = elapsed;
+    }
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+void telemetryLoopBegin() {
+    uint32_t now = micros();
+    if (loopStarted && !skipLoop) {
+        uint32_t gap = now - loopStartMicros;
+        if (gap > gauges.maxLoopGapMicros) {
+            portENTER_CRITICAL(&telemetryMux);
+            gauges.maxLoopGapMicros = gap;
+            gauges.maxLoopGapAtMs = millis();
+            portEXIT_CRITICAL(&telemetryMux);
+        }
+    }
+    loopStartMicros = now;
+    loopStarted = true;
+    skipLoop = false;
+}
+
+void telemetryLoopEnd() {
+    if (!skipLoop) {
+        telemetryRecord(TELEMETRY_LOOP, loopStartMicros);
+    }
+}
+
+void telemetrySkipLoop() {
+    skipLoop = true;
+}
+
+static void lowerTo(uint32_t& watermark, uint32_t sample) {
+    if (sample < watermark) {
+        watermark = sample;
+    }
+}
+
+void sampleTelemetryGauges() {
+    uint32_t freeHeap = ESP.getMinFreeHeap();
+    uint32_t largestBlock = ESP.getMaxAllocHeap();
+    uint32_t stackFree = uxTaskGetStackHighWaterMark(nullptr);
+
+    portENTER_CRITICAL(&telemetryMux);
+    lowerTo(gauges.minFreeHeap, freeHeap);
+    lowerTo(gauges.minLargestBlock, largestBlock);
+    lowerTo(gauges.loopStackFree, stackFree);
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+void noteNetworkStackFree() {
+    uint32_t stackFree = uxTaskGetStackHighWaterMark(nullptr);
+
+    portENTER_CRITICAL(&telemetryMux);
+    lowerTo(gauges.networkStackFree, stackFree);
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+// Copied out under the lock so a dump never holds it while printing
+static TelemetryDump snapshot;
+
+static void takeSnapshot() {
+    snapshot.magic = TELEMETRY_MAGIC;
+    snapshot.version = TELEMETRY_VERSION;
+    snapshot.sectionCount = TELEMETRY_SECTION_COUNT;
+    snapshot.bucketCount = TELEMETRY_BUCKETS;
+    snapshot.reserved = 0;
+    snapshot.uptimeMs = millis();
+    snapshot.histogramSize = sizeof(TelemetryHistogram);
+    snapshot.gaugesSize = sizeof(TelemetryGauges);
+
+    portENTER_CRITICAL(&telemetryMux);
+    memcpy(snapshot.histograms, histograms, sizeof(histograms));
+    snapshot.gauges = gauges;
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+void dumpTelemetryCsv(Print& out) {
+    takeSnapshot();
+
+    out.printf("telemetry,uptime_ms,%u\n", (unsigned)snapshot.uptimeMs);
+    out.print("section,count,mean_us,max_us");
+    for (int b = 0; b < TELEMETRY_BUCKETS - 1; b++) {
+        out.printf(",lt%lu", 2UL << b);
+    }
+    out.print(",longer");
+    out.println();
+    for (int s = 0; s < TELEMETRY_SECTION_COUNT; s++) {
+        const TelemetryHistogram& histogram = snapshot.histograms[s];
+        out.printf("%s,%u,%u,%u", sectionNames[s], (unsigned)histogram.count,
+                   (unsigned)(histogram.count > 0 ? histogram.totalMicros / histogram.count : 0),
+                   (unsigned)histogram.maxMicros);
+        for (int b = 0; b < TELEMETRY_BUCKETS; b++) {
+            out.printf(",%u", (unsigned)histogram.buckets[b]);
+        }
+        out.println();
+    }
+    // 4294967295 means not sampled yet
+    out.printf("max_loop_gap_us,%u,at_ms,%u\n", (unsigned)snapshot.gauges.maxLoopGapMicros,
+               (unsigned)snapshot.gauges.maxLoopGapAtMs);
+    out.printf("min_free_heap,%u\n", (unsigned)snapshot.gauges.minFreeHeap);
+    out.printf("min_largest_block,%u\n", (unsigned)snapshot.gauges.minLargestBlock);
+    out.printf("loop_stack_free,%u\n", (unsigned)snapshot.gauges.loopStackFree);
+    out.printf("network_stack_free,%u\n", (unsigned)snapshot.gauges.networkStackFree);
+}
+
+void dumpTelemetryBinary(Print& out) {
+    takeSnapshot();
+    uint32_t crc = crc32((const uint8_t*)&snapshot, sizeof(snapshot));
+    out.write((const uint8_t*)&snapshot, sizeof(snapshot));
+    out.write((const uint8_t*)&crc, sizeof(crc));
+}
+
+void resetTelemetry() {
+    portENTER_CRITICAL(&telemetryMux);
+    memset(histograms, 0, sizeof(histograms));
+    gauges.maxLoopGapMicros = 0;
+    gauges.maxLoopGapAtMs = 0;
+    gauges.minFreeHeap = UINT32_MAX;
+    gauges.minLargestBlock = UINT32_MAX;
+    portEXIT_CRITICAL(&telemetryMux);
+    // Stack watermarks are since task start and cannot be reset
+}
+
+TelemetryHistogram telemetryHistogram(TelemetrySection section) {
+    portENTER_CRITICAL(&telemetryMux);
+    TelemetryHistogram histogram = histograms[section];
+    portEXIT_CRITICAL(&telemetryMux);
+    return histogram;
+}
+
+TelemetryGauges telemetryGauges() {
+    portENTER_CRITICAL(&telemetryMux);
+    TelemetryGauges copy = gauges;
+    portEXIT_CRITICAL(&telemetryMux);
+    return copy;
+}
+
+bool handleTelemetryCommand(int command, Print& out) {
+    if (command == 't') {
+        dumpTelemetryCsv(out);
+    } else if (command == 'b') {
+        dumpTelemetryBinary(out);
+    } else if (command == 'z') {
+        resetTelemetry();
+        out.println("telemetry,reset");
+    } else {
+        return false;
+    }
+    return true;
+}
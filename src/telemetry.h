@@ -0,0 +1,97 @@
+// telemetry.h
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+// Latency histograms and watermarks kept in RAM for post-mortem analysis.
+// Recording is a handful of integer operations under a spinlock; all
+// formatting happens in the dump functions.
+#define TELEMETRY_BUCKETS 24  // Bucket k counts durations in [2^k, 2^(k+1)) us; the last is open-ended
+#define TELEMETRY_MAGIC 0x4C545A41UL  // "AZTL"
+#define TELEMETRY_VERSION 3
+
+enum TelemetrySection : uint8_t {
+    TELEMETRY_LOOP,          // One pass of loop()
+    TELEMETRY_RENDER,        // Drawing a screen, including its flush
+    TELEMETRY_FLUSH,         // Sending changed bytes to the OLED over I2C
+    TELEMETRY_WIFI_CONNECT,  // Fetch phases, on the network task
+    TELEMETRY_GEOLOCATE,
+    TELEMETRY_CALCULATE,
+    TELEMETRY_DOWNLOAD,
+    TELEMETRY_NTP_SYNC,
+    TELEMETRY_TLS_FULL,      // TLS handshakes, with and without a resumed session
+    TELEMETRY_TLS_RESUMED,
+    TELEMETRY_HTTP,          // A status server pass that accepted, read or sent something
+    TELEMETRY_SECTION_COUNT
+};
+
+struct TelemetryHistogram {
+    uint32_t count;
+    uint32_t maxMicros;
+    uint64_t totalMicros;
+    uint32_t buckets[TELEMETRY_BUCKETS];
+};
+
+struct TelemetryGauges {
+    uint32_t maxLoopGapMicros;   // Longest time between two loop() starts, sleep excluded
+    uint32_t maxLoopGapAtMs;     // millis() when it ended
+    uint32_t minFreeHeap;
+    uint32_t minLargestBlock;    // Smallest "largest free block" seen, i.e. worst fragmentation
+    uint32_t loopStackFree;      // Stack high-water marks, in bytes left unused
+    uint32_t networkStackFree;
+};
+
+// Binary dump: this struct as laid out in memory (little endian, no padding),
+// followed by a CRC-32 of it
+struct TelemetryDump {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t sectionCount;
+    uint8_t bucketCount;
+    uint8_t reserved;
+    uint32_t uptimeMs;
+    uint16_t histogramSize;  // sizeof(TelemetryHistogram), so a reader can check the layout
+    uint16_t gaugesSize;
+    TelemetryHistogram histograms[TELEMETRY_SECTION_COUNT];
+    TelemetryGauges gauges;
+};
+
+static_assert(sizeof(TelemetryDump) == 16 + TELEMETRY_SECTION_COUNT * sizeof(TelemetryHistogram) +
+                                           sizeof(TelemetryGauges),
+              "TelemetryDump must stay packed");
+
+// Timestamp to pass to telemetryRecord()
+inline uint32_t telemetryStart() {
+    return micros();
+}
+
+// Add the time since start to a section's histogram; safe from any task
+void telemetryRecord(TelemetrySection section, uint32_t startMicros);
+
+// Call first thing in loop() and at its end
+void telemetryLoopBegin();
+void telemetryLoopEnd();
+
+// Leave the current loop pass and the next gap out of the statistics (after light sleep)
+void telemetrySkipLoop();
+
+// Call once per second from the loop task: largest free block and loop stack watermark
+void sampleTelemetryGauges();
+
+// Call from the network task after each request
+void noteNetworkStackFree();
+
+// Serial commands: 't' prints CSV, 'b' writes the binary dump, 'z' resets the
+// statistics. Returns false for any other command.
+bool handleTelemetryCommand(int command, Print& out);
+
+void dumpTelemetryCsv(Print& out);
+void dumpTelemetryBinary(Print& out);
+void resetTelemetry();
+
+// Copies taken under the lock, for the status page
+TelemetryHistogram telemetryHistogram(TelemetrySection section);
+TelemetryGauges telemetryGauges();
+
+#endif
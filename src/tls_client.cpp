@@ -0,0 +1,315 @@
+// tls_client.cpp
+// mbedTLS over the plain WiFiClient socket underneath. A full handshake runs
+// the certificate chain through verifyCertificate(); a resumed one does not,
+// which is how the two are told apart. The heap is sampled on every record
+// sent or received, so the peak covers the key exchange.
+#include <Preferences.h>
+#include "tls_client.h"
+#include "tls_roots.h"
+#include "telemetry.h"
+#include "schedule_store.h"
+
+static TlsStats stats;
+
+// NVS keys are limited to 15 characters, so a host's session is stored under a hash of its name
+static void sessionKey(const char* host, char* key, size_t size) {
+    snprintf(key, size, "s%08x", (unsigned)crc32((const uint8_t*)host, strlen(host)));
+}
+
+TlsSessionClient::TlsSessionClient() {}
+
+TlsSessionClient::~TlsSessionClient() {
+    stop();
+}
+
+int TlsSessionClient::connect(IPAddress ip, uint16_t port) {
+    return 0;  // The host name is needed for SNI and to check the certificate
+}
+
+int TlsSessionClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+    return 0;
+}
+
+int TlsSessionClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, TLS_TIMEOUT_MS);
+}
+
+int TlsSessionClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    stop();
+    if (!WiFiClient::connect(host, port, timeout) || !handshake(host)) {
+        stop();
+        stats.failures++;
+        return 0;
+    }
+    return 1;
+}
+
+void TlsSessionClient::sampleHeap() {
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if (freeHeap < heapLow) {
+        heapLow = freeHeap;
+    }
+}
+
+int TlsSessionClient::sendRecord(void* context, const unsigned char* data, size_t length) {
+    TlsSessionClient* client = (TlsSessionClient*)context;
+    client->sampleHeap();
+    size_t sent = client->WiFiClient::write(data, length);
+    if (sent > 0) {
+        return (int)sent;
+    }
+    return client->WiFiClient::connected() ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_SSL_CONN_EOF;
+}
+
+int TlsSessionClient::receiveRecord(void* context, unsigned char* data, size_t length) {
+    TlsSessionClient* client = (TlsSessionClient*)context;
+    client->sampleHeap();
+    int received = client->WiFiClient::read(data, length);
+    if (received > 0) {
+        return received;
+    }
+    return client->WiFiClient::connected() ? MBEDTLS_ERR_SSL_WANT_READ : 0;  // 0 is end of stream
+}
+
+int TlsSessionClient::verifyCertificate(void* context, mbedtls_x509_crt* certificate, int depth, uint32_t* flags) {
+    ((TlsSessionClient*)context)->certificateVerified = true;
+    return 0;  // mbedTLS still rejects the chain if flags are set
+}
+
+bool TlsSessionClient::loadSession(const char* host) {
+    char key[12];
+    sessionKey(host, key, sizeof(key));
+    uint8_t* blob = (uint8_t*)malloc(TLS_SESSION_MAX_SIZE);
+    if (blob == nullptr) {
+        return false;
+    }
+
+    size_t size = 0;
+    Preferences preferences;
+    if (preferences.begin(TLS_SESSION_NAMESPACE, true)) {
+        size = preferences.getBytes(key, blob, TLS_SESSION_MAX_SIZE);
+        preferences.end();
+    }
+    bool loaded = size > 0 && mbedtls_ssl_session_load(&session, blob, size) == 0;
+    free(blob);
+    return loaded;
+}
+
+// Function to store the session (and the ticket the server just issued), only when it changed
+void TlsSessionClient::saveSession(const char* host) {
+    mbedtls_ssl_session_free(&session);
+    mbedtls_ssl_session_init(&session);
+    uint8_t* blob = (uint8_t*)malloc(2 * TLS_SESSION_MAX_SIZE);
+    if (blob == nullptr || mbedtls_ssl_get_session(&ssl, &session) != 0) {
+        free(blob);
+        return;
+    }
+
+    size_t size = 0;
+    if (mbedtls_ssl_session_save(&session, blob, TLS_SESSION_MAX_SIZE, &size) == 0) {
+        char key[12];
+        sessionKey(host, key, sizeof(key));
+        Preferences preferences;
+        preferences.begin(TLS_SESSION_NAMESPACE, false);
+        uint8_t* stored = blob + TLS_SESSION_MAX_SIZE;
+        if (preferences.getBytes(key, stored, TLS_SESSION_MAX_SIZE) != size || memcmp(stored, blob, size) != 0) {
+            preferences.putBytes(key, blob, size);
+        }
+        preferences.end();
+    }
+    free(blob);
+}
+
+bool TlsSessionClient::handshake(const char* host) {
+    uint32_t heapBefore = ESP.getFreeHeap();
+    heapLow = heapBefore;
+    uint32_t start = telemetryStart();
+
+    mbedtls_ssl_init(&ssl);
+    mbedtls_ssl_config_init(&config);
+    mbedtls_x509_crt_init(&roots);
+    mbedtls_ctr_drbg_init(&random);
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ssl_session_init(&session);
+    initialized = true;
+
+    if (mbedtls_ctr_drbg_seed(&random, mbedtls_entropy_func, &entropy, nullptr, 0) != 0 ||
+        mbedtls_x509_crt_parse(&roots, (const unsigned char*)TLS_PINNED_ROOTS, sizeof(TLS_PINNED_ROOTS)) != 0 ||
+        mbedtls_ssl_config_defaults(&config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+        Serial.println("TLS setup failed.");
+        return false;
+    }
+    mbedtls_ssl_conf_authmode(&config, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(&config, &roots, nullptr);
+    mbedtls_ssl_conf_verify(&config, verifyCertificate, this);
+    mbedtls_ssl_conf_rng(&config, mbedtls_ctr_drbg_random, &random);
+    mbedtls_ssl_conf_session_tickets(&config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+    if (mbedtls_ssl_setup(&ssl, &config) != 0 || mbedtls_ssl_set_hostname(&ssl, host) != 0) {
+        Serial.println("TLS setup failed.");
+        return false;
+    }
+    mbedtls_ssl_set_bio(&ssl, this, sendRecord, receiveRecord, nullptr);
+
+    bool offered = loadSession(host) && mbedtls_ssl_set_session(&ssl, &session) == 0;
+    certificateVerified = false;
+
+    unsigned long started = millis();
+    int result;
+    while ((result = mbedtls_ssl_handshake(&ssl)) != 0) {
+        if ((result != MBEDTLS_ERR_SSL_WANT_READ && result != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+            millis() - started > TLS_TIMEOUT_MS) {
+            Serial.printf("TLS handshake with %s failed: -0x%04x\n", host, (unsigned)-result);
+            return false;
+        }
+        delay(2);
+    }
+    secured = true;
+
+    bool resumed = offered && !certificateVerified;
+    uint32_t elapsedMs = (micros() - start) / 1000;
+    uint32_t heapUsed = heapBefore - heapLow;
+    telemetryRecord(resumed ? TELEMETRY_TLS_RESUMED : TELEMETRY_TLS_FULL, start);
+    if (resumed) {
+        stats.resumedHandshakes++;
+        stats.resumedMs += elapsedMs;
+        stats.resumedHeapPeak = max(stats.resumedHeapPeak, heapUsed);
+    } else {
+        stats.fullHandshakes++;
+        stats.fullMs += elapsedMs;
+        stats.fullHeapPeak = max(stats.fullHeapPeak, heapUsed);
+    }
+    Serial.printf("TLS %s: %s handshake in %u ms, heap peak %u bytes\n", host, resumed ? "resumed" : "full",
+                  (unsigned)elapsedMs, (unsigned)heapUsed);
+
+    saveSession(host);
+    return true;
+}
+
+void TlsSessionClient::noteRequest() {
+    if (connected()) {
+        stats.reusedRequests++;
+    }
+}
+
+size_t TlsSessionClient::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+size_t TlsSessionClient::write(const uint8_t* buf, size_t size) {
+    if (!secured) {
+        return 0;
+    }
+    size_t sent = 0;
+    unsigned long start = millis();
+    while (sent < size) {
+        int result = mbedtls_ssl_write(&ssl, buf + sent, size - sent);
+        if (result > 0) {
+            sent += result;
+        } else if ((result != MBEDTLS_ERR_SSL_WANT_READ && result != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+                   millis() - start > TLS_TIMEOUT_MS) {
+            break;
+        } else {
+            delay(2);  // Socket buffer full: let lwIP send, as in handshake()
+        }
+    }
+    return sent;
+}
+
+int TlsSessionClient::available() {
+    if (!secured) {
+        return 0;
+    }
+    if (mbedtls_ssl_get_bytes_avail(&ssl) == 0) {
+        // Decrypt the next record if it has arrived, without blocking
+        int result = mbedtls_ssl_read(&ssl, nullptr, 0);
+        if (result < 0 && result != MBEDTLS_ERR_SSL_WANT_READ && result != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            secured = false;  // Closed by the server, or a fatal alert
+            return peeked >= 0 ? 1 : 0;
+        }
+    }
+    return (int)mbedtls_ssl_get_bytes_avail(&ssl) + (peeked >= 0 ? 1 : 0);
+}
+
+int TlsSessionClient::read(uint8_t* buf, size_t size) {
+    size_t count = 0;
+    if (size > 0 && peeked >= 0) {
+        buf[count++] = (uint8_t)peeked;
+        peeked = -1;
+    }
+    if (count < size && available() > 0) {
+        int result = mbedtls_ssl_read(&ssl, buf + count, size - count);
+        if (result > 0) {
+            count += result;
+        }
+    }
+    return count > 0 ? (int)count : -1;
+}
+
+int TlsSessionClient::read() {
+    uint8_t c;
+    return read(&c, 1) > 0 ? c : -1;
+}
+
+int TlsSessionClient::peek() {
+    if (peeked < 0) {
+        uint8_t c;
+        if (read(&c, 1) > 0) {
+            peeked = c;
+        }
+    }
+    return peeked;
+}
+
+// Drop what has arrived of the current response (HTTPClient calls this before reusing the connection)
+void TlsSessionClient::flush() {
+    uint8_t skip[64];
+    while (available() > 0 && read(skip, sizeof(skip)) > 0) {
+    }
+}
+
+uint8_t TlsSessionClient::connected() {
+    if (!secured) {
+        return false;
+    }
+    return peeked >= 0 || mbedtls_ssl_get_bytes_avail(&ssl) > 0 || WiFiClient::connected();
+}
+
+void TlsSessionClient::release() {
+    if (!initialized) {
+        return;
+    }
+    mbedtls_ssl_session_free(&session);
+    mbedtls_ssl_free(&ssl);
+    mbedtls_ssl_config_free(&config);
+    mbedtls_x509_crt_free(&roots);
+    mbedtls_ctr_drbg_free(&random);
+    mbedtls_entropy_free(&entropy);
+    initialized = false;
+}
+
+void TlsSessionClient::stop() {
+    if (secured && WiFiClient::connected()) {
+        mbedtls_ssl_close_notify(&ssl);
+    }
+    secured = false;
+    peeked = -1;
+    release();
+    WiFiClient::stop();
+}
+
+const TlsStats& tlsStats() {
+    return stats;
+}
+
+// Function to print handshake counts, mean time and heap peak, full versus resumed
+void printTlsReport(Print& out) {
+    out.println("tls,handshakes,mean_ms,heap_peak");
+    out.printf("full,%u,%u,%u\n", (unsigned)stats.fullHandshakes,
+               (unsigned)(stats.fullHandshakes > 0 ? stats.fullMs / stats.fullHandshakes : 0),
+               (unsigned)stats.fullHeapPeak);
+    out.printf("resumed,%u,%u,%u\n", (unsigned)stats.resumedHandshakes,
+               (unsigned)(stats.resumedHandshakes > 0 ? stats.resumedMs / stats.resumedHandshakes : 0),
+               (unsigned)stats.resumedHeapPeak);
+    out.printf("reused_requests,%u\nfailures,%u\n", (unsigned)stats.reusedRequests, (unsigned)stats.failures);
+}
@@ -0,0 +1,81 @@
+// tls_client.h
+#ifndef TLS_CLIENT_H
+#define TLS_CLIENT_H
+
+#include <WiFi.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+
+// HTTPS transport for HTTPClient that validates against the pinned roots in
+// tls_roots.h and resumes sessions from tickets kept in NVS, so a fetch after
+// the first (even after a reboot) costs an abbreviated handshake instead of a
+// full one. Use one instance per host and HTTPClient::setReuse(true) to send
+// sequential requests over the same connection; HTTPClient only keeps it open
+// over HTTP/1.1, so leave useHTTP10() off and read the body through a
+// ChunkedStream (chunked_stream.h).
+#define TLS_SESSION_NAMESPACE "tls"
+#define TLS_SESSION_MAX_SIZE 3072      // Saved session with its ticket and peer certificate
+#define TLS_TIMEOUT_MS 15000           // Handshake, and each write
+
+struct TlsStats {
+    uint32_t fullHandshakes;
+    uint32_t resumedHandshakes;
+    uint32_t fullMs;            // Total handshake time of each kind
+    uint32_t resumedMs;
+    uint32_t fullHeapPeak;      // Most heap a handshake of each kind has taken
+    uint32_t resumedHeapPeak;
+    uint32_t reusedRequests;    // Requests sent over an already open connection
+    uint32_t failures;          // Connections or handshakes that failed
+};
+
+class TlsSessionClient : public WiFiClient {
+public:
+    TlsSessionClient();
+    ~TlsSessionClient();
+
+    int connect(IPAddress ip, uint16_t port);
+    int connect(IPAddress ip, uint16_t port, int32_t timeout);
+    int connect(const char* host, uint16_t port);
+    int connect(const char* host, uint16_t port, int32_t timeout);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* buf, size_t size);
+    int available();
+    int read();
+    int read(uint8_t* buf, size_t size);
+    int peek();
+    void flush();
+    void stop();
+    uint8_t connected();
+
+    // Call before each request: counts it when it goes over the open connection
+    void noteRequest();
+
+private:
+    static int sendRecord(void* context, const unsigned char* data, size_t length);
+    static int receiveRecord(void* context, unsigned char* data, size_t length);
+    static int verifyCertificate(void* context, mbedtls_x509_crt* certificate, int depth, uint32_t* flags);
+
+    bool handshake(const char* host);
+    bool loadSession(const char* host);
+    void saveSession(const char* host);
+    void release();
+    void sampleHeap();
+
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config config;
+    mbedtls_x509_crt roots;
+    mbedtls_ctr_drbg_context random;
+    mbedtls_entropy_context entropy;
+    mbedtls_ssl_session session;
+    bool initialized = false;
+    bool secured = false;              // Handshake done, ssl carries the data
+    bool certificateVerified = false;  // Only a full handshake checks the chain
+    int peeked = -1;                   // Byte read ahead by peek()
+    uint32_t heapLow = 0;              // Free heap low point during the handshake
+};
+
+const TlsStats& tlsStats();
+void printTlsReport(Print& out);
+
+#endif
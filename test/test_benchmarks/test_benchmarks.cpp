@@ -0,0 +1,382 @@
+// test_benchmarks.cpp
+// Times the render, schedule and parse hot paths of the running firmware, one
+// test per function: ns/op (CPU cycles on the ESP32), heap allocations/op and
+// bytes sent to the OLED per call. A build with -DBENCHMARK_UPDATE_BASELINE
+// stores the results as the baseline in NVS (namespace "bench"); other runs
+// fail a function that is more than BENCHMARK_REGRESSION_PERCENT slower, that
+// allocates or draws more, or that has no baseline on this machine. On the PC
+// the NVS is kept in BENCHMARK_NVS_FILE between runs. Each case keeps the
+// fastest of BENCHMARK_ROUNDS rounds.
+// Run with: pio test -e native -f test_benchmarks (or -e nodemcu-32s)
+#include <Arduino.h>
+#include <Preferences.h>
+#include <RTClib.h>
+#include <Adafruit_SSD1306.h>
+#include <unity.h>
+#include "digit_font.h"
+#include "display_flush.h"
+#include "event_scheduler.h"
+#include "heap_monitor.h"
+#include "network_task.h"
+#include "prayer_times.h"
+#include "schedule_store.h"
+#include "soft_clock.h"
+#ifndef ARDUINO
+#include <stdlib.h>
+#include <sim_hal.h>
+#endif
+
+#ifndef BENCHMARK_REGRESSION_PERCENT
+#define BENCHMARK_REGRESSION_PERCENT 15  // Slower than the baseline by more than this is a regression
+#endif
+
+#ifndef BENCHMARK_NVS_FILE
+#define BENCHMARK_NVS_FILE ".pio/benchmark.nvs"  // PC only, relative to the project
+#endif
+
+#ifndef BENCHMARK_ROUNDS
+#define BENCHMARK_ROUNDS 5  // Each case is timed this many times and the fastest round counts
+#endif
+
+#define BENCHMARK_NAMESPACE "bench"  // NVS namespace holding the baseline
+
+// Firmware state and functions under test (main.cpp)
+void firmwareSetup();
+extern uint8_t scheduleBlob[];
+extern size_t scheduleSize;
+extern PrayerTimes todayTimes;
+extern EventQueue eventQueue;
+extern Adafruit_SSD1306 display;
+void displayLargeTime();
+void displayTimings();
+void displayOtherTimings();
+void whenToBuzzer();
+void formatMinutesAs12Hour(int minutes, char* out, size_t size);
+bool loadTodayFromSchedule();
+int parseAzanCalendar(Stream& stream, int firstDay, PrayerTimes* days, int& dayCount, char* hijri);
+
+// Fixed inputs so runs on any board compare against each other: Dubai, 10 March 2024, 10:00,
+// which is between the sunrise reminder and Dhuhr, so whenToBuzzer() has nothing to fire.
+#define BENCH_LATITUDE 25.2048
+#define BENCH_LONGITUDE 55.2708
+#define BENCH_TIMEZONE 4.0
+#define BENCH_METHOD 16
+#define BENCH_YEAR 2024
+#define BENCH_MONTH 3
+#define BENCH_DAY 10
+#define BENCH_EPOCH 1710064800UL  // 2024-03-10 10:00:00
+#define BENCH_CALENDAR_DAYS 31
+#define BENCH_CALENDAR_CAPACITY 16384
+
+static const char* const calendarKeys[PRAYER_TIME_COUNT] = {"Fajr", "Sunrise", "Dhuhr", "Asr", "Maghrib", "Isha",
+                                                            "Sunset", "Imsak", "Midnight", "Firstthird", "Lastthird"};
+
+// Read-only Stream over a buffer, standing in for the HTTPS body
+class MemoryStream : public Stream {
+public:
+    MemoryStream(const char* data, size_t length) : data(data), length(length), position(0) {}
+
+    int available() override { return (int)(length - position); }
+    int peek() override { return position < length ? (uint8_t)data[position] : -1; }
+    int read() override { return position < length ? (uint8_t)data[position++] : -1; }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    const char* data;
+    size_t length;
+    size_t position;
+};
+
+static char calendarFixture[BENCH_CALENDAR_CAPACITY];
+static size_t calendarFixtureLength = 0;
+static PrayerTimes benchDays[SCHEDULE_DAYS];
+static EventQueue benchQueue;
+static DateTime benchStart(BENCH_YEAR, BENCH_MONTH, BENCH_DAY, 10, 0, 0);
+
+// Function to build an Aladhan calendar response for March in the same shape as the API
+static bool buildCalendarFixture() {
+    size_t used = snprintf(calendarFixture, BENCH_CALENDAR_CAPACITY, "{\"code\":200,\"status\":\"OK\",\"data\":[");
+    for (int day = 1; day <= BENCH_CALENDAR_DAYS; day++) {
+        PrayerTimes times;
+        computePrayerTimes(BENCH_YEAR, BENCH_MONTH, day, BENCH_LATITUDE, BENCH_LONGITUDE, BENCH_TIMEZONE,
+                           BENCH_METHOD, times);
+
+        used += snprintf(calendarFixture + used, BENCH_CALENDAR_CAPACITY - used, "%s{\"timings\":{",
+                         day > 1 ? "," : "");
+        for (int i = 0; i < PRAYER_TIME_COUNT && used < BENCH_CALENDAR_CAPACITY; i++) {
+            used += snprintf(calendarFixture + used, BENCH_CALENDAR_CAPACITY - used, "%s\"%s\":\"%02d:%02d (+04)\"",
+                             i > 0 ? "," : "", calendarKeys[i], times.minutes[i] / 60, times.minutes[i] % 60);
+        }
+        if (used >= BENCH_CALENDAR_CAPACITY) {
+            return false;
+        }
+        used += snprintf(calendarFixture + used, BENCH_CALENDAR_CAPACITY - used,
+                         "},\"date\":{\"readable\":\"%02d Mar 2024\",\"gregorian\":{\"date\":\"%02d-03-2024\"},"
+                         "\"hijri\":{\"date\":\"%02d-08-1445\",\"month\":{\"number\":8,\"en\":\"Shaban\"}}},"
+                         "\"meta\":{\"latitude\":25.2048,\"longitude\":55.2708,\"timezone\":\"Asia/Dubai\","
+                         "\"method\":{\"id\":16,\"name\":\"Dubai (experimental)\"}}}",
+                         day, day, (day + 19) % 30 + 1);
+        if (used >= BENCH_CALENDAR_CAPACITY) {
+            return false;
+        }
+    }
+    used += snprintf(calendarFixture + used, BENCH_CALENDAR_CAPACITY - used, "]}");
+    calendarFixtureLength = used;
+    return used < BENCH_CALENDAR_CAPACITY;
+}
+
+// Function to install a schedule starting on the benchmark date and compile today's events
+static bool loadBenchSchedule() {
+    for (int d = 0; d < SCHEDULE_DAYS; d++) {
+        DateTime date = benchStart + TimeSpan(d, 0, 0, 0);
+        computePrayerTimes(date.year(), date.month(), date.day(), BENCH_LATITUDE, BENCH_LONGITUDE, BENCH_TIMEZONE,
+                           BENCH_METHOD, benchDays[d]);
+    }
+    scheduleSize = encodeSchedule(benchDays, SCHEDULE_DAYS, BENCH_YEAR, BENCH_MONTH, BENCH_DAY, scheduleBlob,
+                                  scheduleBlobSize(SCHEDULE_DAYS));
+    setSoftClock(benchStart);
+    return scheduleSize > 0 && loadTodayFromSchedule();
+}
+
+static void benchFormat12Hour(uint32_t i) {
+    char text[16];
+    formatMinutesAs12Hour(i % 1440, text, sizeof(text));
+}
+
+static void benchParseCalendar(uint32_t i) {
+    MemoryStream stream(calendarFixture, calendarFixtureLength);
+    int dayCount = 0;
+    char hijri[HIJRI_DATE_SIZE];
+    parseAzanCalendar(stream, 1, benchDays, dayCount, hijri);
+}
+
+static void benchComputeDay(uint32_t i) {
+    PrayerTimes times;
+    computePrayerTimes(BENCH_YEAR, BENCH_MONTH, 1 + i % BENCH_CALENDAR_DAYS, BENCH_LATITUDE, BENCH_LONGITUDE,
+                       BENCH_TIMEZONE, BENCH_METHOD, times);
+}
+
+static void benchReadDay(uint32_t i) {
+    PrayerTimes times;
+    DateTime date = benchStart + TimeSpan(i % SCHEDULE_DAYS, 0, 0, 0);
+    readScheduleDay(scheduleBlob, date.year(), date.month(), date.day(), times);
+}
+
+static void benchBuildQueue(uint32_t i) {
+    buildEventQueue(benchQueue, todayTimes, BENCH_DAY, i % 1440);
+}
+
+static void benchWhenToBuzzer(uint32_t i) {
+    whenToBuzzer();
+}
+
+// The clock advances one second per call, like the 1 Hz redraw
+static void benchLargeTime(uint32_t i) {
+    setSoftClock(benchStart + TimeSpan(i + 1));
+    displayLargeTime();
+}
+
+// The clock digits alone, without the flush: Adafruit GFX scaling the 5x7 font,
+// against the pre-rendered atlas at the same size and at full-panel size
+static const char* const benchClockTexts[4] = {"12:59:59", "10:08:30", "3:45:17", "11:11:11"};
+
+static void benchDigitsGfx(uint32_t i) {
+    display.setTextSize(2);
+    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
+    display.setCursor(16, 16);
+    display.print(benchClockTexts[i % 4]);
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+}
+
+static void benchDigitsAtlas(uint32_t i) {
+    drawDigits(display.getBuffer(), DIGIT_FONT_SMALL, 16, 16, benchClockTexts[i % 4]);
+}
+
+static void benchDigitsLarge(uint32_t i) {
+    drawDigits(display.getBuffer(), DIGIT_FONT_LARGE, 2, 0, "12:59");
+}
+
+static void benchTimings(uint32_t i) {
+    displayTimings();
+}
+
+static void benchTimingsFull(uint32_t i) {
+    invalidateDisplay();
+    displayTimings();
+}
+
+static void benchOtherTimings(uint32_t i) {
+    displayOtherTimings();
+}
+
+// One button press each: the next screen replaces the whole previous one
+static void benchScreenSwitch(uint32_t i) {
+    if (i % 2 == 0) {
+        displayTimings();
+    } else {
+        displayOtherTimings();
+    }
+}
+
+struct BenchmarkCase {
+    const char* name;  // Also the NVS key, so at most 15 characters
+    uint32_t iterations;
+    void (*body)(uint32_t iteration);
+};
+
+static const BenchmarkCase benchmarkCases[] = {
+    {"format12h", 2000, benchFormat12Hour},
+    {"parseCalendar", 10, benchParseCalendar},
+    {"computeDay", 100, benchComputeDay},
+    {"readDay", 2000, benchReadDay},
+    {"buildQueue", 2000, benchBuildQueue},
+    {"whenToBuzzer", 2000, benchWhenToBuzzer},
+    {"largeTime", 60, benchLargeTime},
+    {"digitsGfx", 200, benchDigitsGfx},
+    {"digitsAtlas", 200, benchDigitsAtlas},
+    {"digitsLarge", 200, benchDigitsLarge},
+    {"timings", 20, benchTimings},
+    {"timingsFull", 20, benchTimingsFull},
+    {"otherTimings", 20, benchOtherTimings},
+    {"screenSwitch", 20, benchScreenSwitch},
+};
+
+struct BenchmarkResult {
+    uint32_t nsPerOp;
+    uint32_t allocsPerOpX100;     // Heap allocations per call, times 100
+    uint32_t displayBytesPerOp;   // I2C payload pushed to the OLED per call
+};
+
+// Function to time one round of a case with the CPU cycle counter
+static BenchmarkResult measureRound(const BenchmarkCase& benchCase) {
+    waitDisplayFlush();
+    uint64_t cycles = 0;
+    uint32_t allocationsBefore = heapAllocationCount();
+    uint64_t displayBytesBefore = displayFlushStats().totalBytes;
+    for (uint32_t i = 1; i <= benchCase.iterations; i++) {
+        uint32_t start = ESP.getCycleCount();
+        benchCase.body(i);
+        cycles += (uint32_t)(ESP.getCycleCount() - start);  // Per call, so CCOUNT wrap-around is harmless
+        waitDisplayFlush();  // The render and the handoff are timed, the transfer is not
+    }
+
+    BenchmarkResult result;
+    result.nsPerOp = (uint32_t)(cycles * 1000 / ESP.getCpuFreqMHz() / benchCase.iterations);
+    result.allocsPerOpX100 = (heapAllocationCount() - allocationsBefore) * 100 / benchCase.iterations;
+    result.displayBytesPerOp = (uint32_t)((displayFlushStats().totalBytes - displayBytesBefore) / benchCase.iterations);
+    return result;
+}
+
+// Function to run one case after a warm-up call and keep its fastest round, so an
+// interrupt or, on the PC, another process only fails the test if it hits every round
+static BenchmarkResult measureBenchmark(const BenchmarkCase& benchCase) {
+    benchCase.body(0);
+
+    BenchmarkResult best = measureRound(benchCase);
+    for (int round = 1; round < BENCHMARK_ROUNDS; round++) {
+        BenchmarkResult result = measureRound(benchCase);
+        if (result.nsPerOp < best.nsPerOp) {
+            best.nsPerOp = result.nsPerOp;
+        }
+        if (result.allocsPerOpX100 > best.allocsPerOpX100) {
+            best.allocsPerOpX100 = result.allocsPerOpX100;
+        }
+        if (result.displayBytesPerOp > best.displayBytesPerOp) {
+            best.displayBytesPerOp = result.displayBytesPerOp;
+        }
+    }
+    return best;
+}
+
+static Preferences baselines;
+static bool fixturesReady = false;
+static const BenchmarkCase* currentCase = nullptr;
+
+// Function to measure the current case and compare it with its stored baseline; with
+// BENCHMARK_UPDATE_BASELINE, store the result as the new baseline instead
+static void test_benchmark(void) {
+    TEST_ASSERT_TRUE_MESSAGE(fixturesReady, "benchmark fixtures did not load");
+    BenchmarkResult result = measureBenchmark(*currentCase);
+
+    BenchmarkResult baseline;
+#ifdef BENCHMARK_UPDATE_BASELINE
+    baseline = result;
+    baselines.putBytes(currentCase->name, &baseline, sizeof(baseline));
+#else
+    bool haveBaseline = baselines.getBytes(currentCase->name, &baseline, sizeof(baseline)) == sizeof(baseline);
+    if (!haveBaseline) {
+        baseline = result;  // Still print the row, so the numbers can be reviewed before recording them
+    }
+#endif
+
+    char row[128];
+    snprintf(row, sizeof(row), "bench,%s,%u,%u,%u.%02u,%u,%u", currentCase->name, (unsigned)currentCase->iterations,
+             (unsigned)result.nsPerOp, (unsigned)(result.allocsPerOpX100 / 100),
+             (unsigned)(result.allocsPerOpX100 % 100), (unsigned)result.displayBytesPerOp,
+             (unsigned)baseline.nsPerOp);
+    TEST_MESSAGE(row);
+#ifndef BENCHMARK_UPDATE_BASELINE
+    TEST_ASSERT_TRUE_MESSAGE(haveBaseline, "no baseline on this machine; record one with -DBENCHMARK_UPDATE_BASELINE");
+#endif
+
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE((uint64_t)baseline.nsPerOp * (100 + BENCHMARK_REGRESSION_PERCENT) / 100,
+                                      result.nsPerOp, "slower than the baseline");
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(baseline.allocsPerOpX100, result.allocsPerOpX100,
+                                      "more heap allocations than the baseline");
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(baseline.displayBytesPerOp, result.displayBytesPerOp,
+                                      "more bytes to the OLED than the baseline");
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Runs once the firmware is up and the network task is idle, so nothing else allocates or draws
+static int runTests() {
+    fixturesReady = buildCalendarFixture() && loadBenchSchedule();
+    baselines.begin(BENCHMARK_NAMESPACE, false);
+    Serial.printf("Benchmarks: CPU %u MHz, best of %d rounds, threshold %d%%\n", (unsigned)ESP.getCpuFreqMHz(),
+                  BENCHMARK_ROUNDS, BENCHMARK_REGRESSION_PERCENT);
+    Serial.printf("bench,name,iterations,ns_per_op,allocs_per_op,display_bytes_per_op,baseline_ns_per_op\n");
+
+    UNITY_BEGIN();
+    for (const BenchmarkCase& benchCase : benchmarkCases) {
+        currentCase = &benchCase;
+        UnityDefaultTestRun(test_benchmark, benchCase.name, __LINE__);
+    }
+    int failures = UNITY_END();
+    baselines.end();
+    return failures;
+}
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000);  // Let the test runner open the serial port
+    firmwareSetup();
+    while (networkBusy()) {
+        delay(10);
+    }
+    runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char** argv) {
+    simBindMainThread();
+    simSetWallTime(BENCH_EPOCH);
+    simSetRtcTime(BENCH_EPOCH);
+    simSetSqwPin(4);  // RTC_SQW_PIN in main.cpp
+    simSetWifiAvailable(false);
+    simSetToneLogging(false);
+    simLoadNvs(BENCHMARK_NVS_FILE);
+    firmwareSetup();
+    while (networkBusy()) {
+        delay(10);
+    }
+    int failures = runTests();
+    simSaveNvs(BENCHMARK_NVS_FILE);
+    fflush(stdout);
+    _Exit(failures);  // The firmware's tasks are still blocked on their queues
+}
+#endif
@@ -0,0 +1,202 @@
+// test_fetch_month.cpp
+// Thirty days of schedule fetches, twice, against the simulated network
+// (lib/native_hal): once as the old firmware fetched, at boot and every night
+// at 01:01 (public IP, geolocation, then one day of timings), and once as the
+// whole firmware does now with the Aladhan API (a month of calendar, fetched
+// again when fewer than SCHEDULE_REFILL_DAYS remain). Each run reports the
+// requests, the radio-on time charged by the simulator's air time model and
+// the response bytes. Both runs bring Wi-Fi up per fetch and switch it off
+// after; the batching run also includes the firmware's NTP syncs. PC only.
+// Run with: pio test -e native -f test_fetch_month
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <sim_hal.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include "prayer_times.h"
+
+#define BOOT_EPOCH 1710045000UL  // 2024-03-10 04:30:00, local time
+#define BOOT_DAY 10
+#define RUN_DAYS 30
+#define STEP_US 100000           // One loop() pass; alerts are not checked here
+#define FETCH_LATITUDE 25.2048
+#define FETCH_LONGITUDE 55.2708
+#define FETCH_TIMEZONE 4.0
+#define FETCH_METHOD 16
+#define CALENDAR_CAPACITY 16384
+
+void firmwareSetup();
+void firmwareLoop();
+extern bool calculateOnDevice;
+extern const char* WIFI_SSID;
+
+static const char* const timingKeys[PRAYER_TIME_COUNT] = {"Fajr", "Sunrise", "Dhuhr", "Asr", "Maghrib", "Isha",
+                                                          "Sunset", "Imsak", "Midnight", "Firstthird", "Lastthird"};
+static const char* const monthNames[] = {"Mar", "Apr"};
+
+// What ip-api.com answers without a field list, as the old firmware asked for it
+static const char* const fullGeolocation =
+    "{\"status\":\"success\",\"country\":\"United Arab Emirates\",\"countryCode\":\"AE\",\"region\":\"DU\","
+    "\"regionName\":\"Dubai\",\"city\":\"Dubai\",\"zip\":\"\",\"lat\":25.2048,\"lon\":55.2708,"
+    "\"timezone\":\"Asia/Dubai\",\"isp\":\"Emirates Telecommunications Corporation\",\"org\":\"\","
+    "\"as\":\"AS5384 Emirates Telecommunications Corporation\",\"query\":\"203.0.113.7\"}";
+
+static char calendar[2][CALENDAR_CAPACITY];
+static char timings[CALENDAR_CAPACITY];
+static SimRadioStats nightly;
+static SimRadioStats batched;
+
+// Function to append one day in the shape the Aladhan API returns it (calendar element or timings data)
+static size_t appendDay(char* out, size_t capacity, size_t used, int month, int day) {
+    PrayerTimes times;
+    computePrayerTimes(2024, month, day, FETCH_LATITUDE, FETCH_LONGITUDE, FETCH_TIMEZONE, FETCH_METHOD, times);
+    used += snprintf(out + used, capacity - used, "{\"timings\":{");
+    for (int i = 0; i < PRAYER_TIME_COUNT && used < capacity; i++) {
+        used += snprintf(out + used, capacity - used, "%s\"%s\":\"%02d:%02d (+04)\"", i > 0 ? "," : "",
+                         timingKeys[i], times.minutes[i] / 60, times.minutes[i] % 60);
+    }
+    if (used >= capacity) {
+        return used;
+    }
+    used += snprintf(out + used, capacity - used,
+                     "},\"date\":{\"readable\":\"%02d %s 2024\",\"gregorian\":{\"date\":\"%02d-%02d-2024\"},"
+                     "\"hijri\":{\"date\":\"%02d-08-1445\",\"month\":{\"number\":8,\"en\":\"Shaban\"}}},"
+                     "\"meta\":{\"latitude\":25.2048,\"longitude\":55.2708,\"timezone\":\"Asia/Dubai\","
+                     "\"method\":{\"id\":16,\"name\":\"Dubai (experimental)\"}}}",
+                     day, monthNames[month - 3], day, month, (day + 19) % 30 + 1);
+    return used;
+}
+
+// Function to build the calendar response for March or April 2024
+static bool buildCalendar(int month, int days) {
+    char* out = calendar[month - 3];
+    size_t used = snprintf(out, CALENDAR_CAPACITY, "{\"code\":200,\"status\":\"OK\",\"data\":[");
+    for (int day = 1; day <= days && used < CALENDAR_CAPACITY; day++) {
+        if (day > 1) {
+            used += snprintf(out + used, CALENDAR_CAPACITY - used, ",");
+        }
+        used = appendDay(out, CALENDAR_CAPACITY, used, month, day);
+    }
+    if (used < CALENDAR_CAPACITY) {
+        used += snprintf(out + used, CALENDAR_CAPACITY - used, "]}");
+    }
+    return used < CALENDAR_CAPACITY;
+}
+
+static bool buildRoutes() {
+    size_t used = snprintf(timings, sizeof(timings), "{\"code\":200,\"status\":\"OK\",\"data\":");
+    used = appendDay(timings, sizeof(timings), used, 3, BOOT_DAY);
+    if (used < sizeof(timings)) {
+        used += snprintf(timings + used, sizeof(timings) - used, "}");
+    }
+    if (used >= sizeof(timings) || !buildCalendar(3, 31) || !buildCalendar(4, 30)) {
+        return false;
+    }
+
+    simAddHttpRoute("api.ipify.org", 200, "203.0.113.7");
+    simAddHttpRoute("ip-api.com/json/", 200, fullGeolocation);
+    simAddHttpRoute("ip-api.com/json/203.0.113.7?fields=", 200, "{\"lat\":25.2048,\"lon\":55.2708,\"city\":\"Dubai\"}");
+    simAddHttpRoute("api.aladhan.com/v1/timings/", 200, timings);
+    simAddHttpRoute("api.aladhan.com/v1/calendar/2024/3?", 200, calendar[0]);
+    simAddHttpRoute("api.aladhan.com/v1/calendar/2024/4?", 200, calendar[1]);
+    return true;
+}
+
+// Function to fetch one day the way the old fetchAzanTimes() did: public IP, geolocation, then timings
+static bool oldNightlyFetch(int month, int day) {
+    WiFi.begin("home", "");
+    HTTPClient http;
+    http.begin("https://api.ipify.org");
+    bool ok = http.GET() == 200;
+    String publicIP = http.getString();
+    http.end();
+
+    http.begin("http://ip-api.com/json/" + publicIP);
+    ok = http.GET() == 200 && ok;
+    http.getString();
+    http.end();
+
+    char apiUrl[128];
+    snprintf(apiUrl, sizeof(apiUrl),
+             "https://api.aladhan.com/v1/timings/%02d-%02d-2024?latitude=%.4f&longitude=%.4f&method=%d", day, month,
+             FETCH_LATITUDE, FETCH_LONGITUDE, FETCH_METHOD);
+    WiFiClientSecure client;
+    client.setInsecure();
+    HTTPClient https;
+    https.begin(client, apiUrl);
+    ok = https.GET() == 200 && ok;
+    https.getString();
+    https.end();
+
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    return ok;
+}
+
+static uint64_t microsAt(int day, int minute) {
+    return ((uint64_t)day * 86400 + minute * 60 - (BOOT_EPOCH % 86400)) * 1000000ULL;
+}
+
+static void runUntil(uint64_t micros) {
+    while (simMicros() < micros) {
+        firmwareLoop();
+        simAdvance(STEP_US);
+    }
+}
+
+static void report(const char* mode, const SimRadioStats& stats) {
+    char row[160];
+    snprintf(row, sizeof(row), "fetch,%s,requests,%u,radio_ms,%u,bytes,%u,joins,%u,handshakes,%u", mode,
+             (unsigned)stats.requests, (unsigned)(stats.airMicros / 1000), (unsigned)stats.bytes,
+             (unsigned)stats.joins, (unsigned)stats.handshakes);
+    TEST_MESSAGE(row);
+}
+
+static void test_old_nightly_fetch(void) {
+    TEST_ASSERT_TRUE(buildRoutes());
+    simResetRadioStats();
+    for (int day = BOOT_DAY; day <= BOOT_DAY + RUN_DAYS; day++) {  // At boot, then each night
+        TEST_ASSERT_TRUE(oldNightlyFetch(day > 31 ? 4 : 3, day > 31 ? day - 31 : day));
+    }
+    nightly = simRadioStats();
+    report("nightly", nightly);
+    TEST_ASSERT_EQUAL_UINT32(3 * (RUN_DAYS + 1), nightly.requests);
+}
+
+static void test_calendar_batching(void) {
+    WIFI_SSID = "home";
+    calculateOnDevice = false;
+    simResetRadioStats();
+    firmwareSetup();
+    runUntil(microsAt(RUN_DAYS, 2 * 60));  // Past the last night's refresh
+    batched = simRadioStats();
+    report("calendar", batched);
+
+    TEST_ASSERT_TRUE(batched.requests > 0);
+    TEST_ASSERT_TRUE_MESSAGE(batched.requests < nightly.requests, "more requests than the nightly fetch");
+    TEST_ASSERT_TRUE_MESSAGE(batched.airMicros < nightly.airMicros, "radio on longer than the nightly fetch");
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static int runTests() {
+    simBindMainThread();
+    simSetWallTime(BOOT_EPOCH);
+    simSetRtcTime(BOOT_EPOCH);
+    simSetSqwPin(4);  // RTC_SQW_PIN in main.cpp
+    simSetToneLogging(false);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_old_nightly_fetch);
+    RUN_TEST(test_calendar_batching);
+    return UNITY_END();
+}
+
+int main(int argc, char** argv) {
+    int failures = runTests();
+    fflush(stdout);
+    _Exit(failures);  // The firmware's tasks are still blocked on their queues
+}
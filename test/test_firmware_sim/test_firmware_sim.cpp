@@ -0,0 +1,180 @@
+// test_firmware_sim.cpp
+// The whole firmware against the simulated hardware (lib/native_hal): a
+// provisioning image with a canned calendar in the schedule partition, the
+// DS3231 and SQW on the fake RTC, Wi-Fi and SNTP from the stand-in, and the
+// recording buzzer. Checks that each alert beeps in its minute with its own
+// pattern, that a schedule refresh in the middle of an alert minute does not
+// repeat it, and that the panel is off overnight. PC only, as it needs the
+// simulator. Run with: pio test -e native -f test_firmware_sim
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <unity.h>
+#include <esp_partition.h>
+#include <sim_hal.h>
+#include <Adafruit_SSD1306.h>
+#include "network_task.h"
+#include "schedule_store.h"
+
+#define BOOT_EPOCH 1710045000UL  // 2024-03-10 04:30:00, local time
+#define STEP_US 10000            // One loop() pass, as the simulator's default
+#define CALENDAR_DAYS 40
+#define REMINDER_BEEPS 5         // "rem" pattern in alert_player.cpp
+#define PRAYER_BEEPS 15          // "time" pattern
+
+void firmwareSetup();
+void firmwareLoop();
+void requestNetwork(NetworkRequestType type);
+extern bool scheduleLoaded;
+extern bool fetchingAzanTimes;
+
+// Every day of the canned calendar, PrayerTimeIndex order, minutes since midnight
+static const int16_t cannedDay[PRAYER_TIME_COUNT] = {
+    5 * 60 + 10,   // Fajr
+    6 * 60 + 25,   // Sunrise
+    12 * 60 + 30,  // Dhuhr
+    15 * 60 + 50,  // Asr
+    18 * 60 + 35,  // Maghrib
+    19 * 60 + 50,  // Isha
+    18 * 60 + 32,  // Sunset
+    5 * 60,        // Imsak
+    0 * 60 + 28,   // Midnight
+    22 * 60 + 30,  // First third
+    2 * 60 + 26,   // Last third
+};
+
+struct ExpectedAlert {
+    int minute;
+    uint32_t beeps;
+};
+
+// Reminders ten minutes ahead (none for Dhuhr), and Fajr ending ten minutes before sunrise
+static const ExpectedAlert expectedAlerts[] = {
+    {5 * 60, REMINDER_BEEPS},       {5 * 60 + 10, PRAYER_BEEPS},  {6 * 60 + 15, REMINDER_BEEPS},
+    {12 * 60 + 30, PRAYER_BEEPS},   {15 * 60 + 40, REMINDER_BEEPS}, {15 * 60 + 50, PRAYER_BEEPS},
+    {18 * 60 + 25, REMINDER_BEEPS}, {18 * 60 + 35, PRAYER_BEEPS}, {19 * 60 + 40, REMINDER_BEEPS},
+    {19 * 60 + 50, PRAYER_BEEPS},
+};
+
+static uint8_t image[PROVISION_PARTITION_SIZE];
+
+// Flash the canned calendar for Dubai-like coordinates in the firmware's time zone and method
+static bool flashCannedCalendar() {
+    PrayerTimes days[CALENDAR_DAYS];
+    for (int d = 0; d < CALENDAR_DAYS; d++) {
+        memcpy(days[d].minutes, cannedDay, sizeof(cannedDay));
+    }
+    static uint8_t schedule[scheduleBlobSize(CALENDAR_DAYS)];
+    size_t scheduleSize = encodeSchedule(days, CALENDAR_DAYS, 2024, 3, 1, schedule, sizeof(schedule));
+    if (scheduleSize == 0) {
+        return false;
+    }
+
+    ProvisionHeader header;
+    memset(&header, 0, sizeof(header));
+    header.method = 16;
+    header.timezoneMinutes = 330;  // gmtOffsetSec in main.cpp
+    header.latitude = 25.2048;
+    header.longitude = 55.2708;
+    strncpy(header.name, "Canned", sizeof(header.name) - 1);
+    size_t imageSize = encodeProvisionImage(header, schedule, scheduleSize, image, sizeof(image));
+    if (imageSize == 0) {
+        return false;
+    }
+    simAddPartition(PROVISION_PARTITION_LABEL, image, imageSize);
+    return true;
+}
+
+static uint64_t microsAt(int day, int minute, int second) {
+    return ((uint64_t)day * 86400 + minute * 60 + second - (BOOT_EPOCH % 86400)) * 1000000ULL;
+}
+
+static void runUntil(uint64_t micros) {
+    while (simMicros() < micros) {
+        firmwareLoop();
+        simAdvance(STEP_US);
+    }
+}
+
+// Tones that start in [from, to)
+static uint32_t beepsBetween(uint64_t from, uint64_t to) {
+    uint32_t beeps = 0;
+    for (const SimToneEvent& event : simToneLog()) {
+        if (event.frequency > 0 && event.micros >= from && event.micros < to) {
+            beeps++;
+        }
+    }
+    return beeps;
+}
+
+static void checkDayOfAlerts(int day) {
+    uint32_t expectedTotal = 0;
+    for (const ExpectedAlert& alert : expectedAlerts) {
+        char message[48];
+        snprintf(message, sizeof(message), "day %d, alert at %02d:%02d", day, alert.minute / 60, alert.minute % 60);
+        TEST_ASSERT_EQUAL_MESSAGE(alert.beeps, beepsBetween(microsAt(day, alert.minute, 0),
+                                                            microsAt(day, alert.minute + 1, 0)), message);
+        expectedTotal += alert.beeps;
+    }
+    uint64_t from = day == 0 ? 0 : microsAt(day, 0, 0);
+    TEST_ASSERT_EQUAL_MESSAGE(expectedTotal, beepsBetween(from, microsAt(day + 1, 0, 0)), "beeps outside alerts");
+}
+
+static void test_boot_from_canned_calendar(void) {
+    TEST_ASSERT_TRUE(flashCannedCalendar());
+    firmwareSetup();
+    runUntil(microsAt(0, 4 * 60 + 31, 0));
+    TEST_ASSERT_TRUE(scheduleLoaded);
+    TEST_ASSERT_TRUE(simSsd1306Panel().displayOn());
+}
+
+static void test_alerts_follow_calendar(void) {
+    runUntil(microsAt(1, 0, 0));
+    checkDayOfAlerts(0);
+}
+
+static void test_panel_off_overnight(void) {
+    runUntil(microsAt(1, 2 * 60, 0));
+    TEST_ASSERT_FALSE(simSsd1306Panel().displayOn());
+    runUntil(microsAt(1, 5 * 60 + 1, 0));  // Awake for the Fajr reminder
+    TEST_ASSERT_TRUE(simSsd1306Panel().displayOn());
+}
+
+static void test_refresh_keeps_fired_alerts(void) {
+    // The refreshed schedule lands while the Dhuhr alert is still beeping
+    runUntil(microsAt(1, 12 * 60 + 30, 5));
+    requestNetwork(NETWORK_REFRESH_SCHEDULE);
+    while (networkBusy()) {
+        usleep(1000);  // The network task runs in real time; keep the clock still meanwhile
+    }
+    firmwareLoop();
+    TEST_ASSERT_FALSE(fetchingAzanTimes);
+    runUntil(microsAt(2, 0, 0));
+    checkDayOfAlerts(1);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static int runTests() {
+    simBindMainThread();
+    simSetWallTime(BOOT_EPOCH);
+    simSetRtcTime(BOOT_EPOCH);
+    simSetSqwPin(4);  // RTC_SQW_PIN in main.cpp
+    simSetToneLogging(false);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_from_canned_calendar);
+    RUN_TEST(test_alerts_follow_calendar);
+    RUN_TEST(test_panel_off_overnight);
+    RUN_TEST(test_refresh_keeps_fired_alerts);
+    return UNITY_END();
+}
+
+int main(int argc, char** argv) {
+    int failures = runTests();
+    fflush(stdout);
+    _Exit(failures);  // The firmware's tasks are still blocked on their queues
+}
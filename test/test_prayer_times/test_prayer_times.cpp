@@ -0,0 +1,140 @@
+// test_prayer_times.cpp
+// The on-device calculation against a reference table: every timing within a
+// minute for a spread of cities, seasons and methods, including Dubai with
+// method 16 (the firmware default) and latitudes where Fajr and Isha come
+// from the high latitude rule. Run with: pio test -e native -f test_prayer_times
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unity.h>
+#include "prayer_times.h"
+
+#define HIGH_LATITUDE 48.5  // Above this, summer twilight never ends at 18 degrees
+
+static const char* const timingNames[PRAYER_TIME_COUNT] = {"Fajr", "Sunrise", "Dhuhr", "Asr", "Maghrib", "Isha",
+                                                           "Sunset", "Imsak", "Midnight", "Firstthird", "Lastthird"};
+
+struct ReferenceDay {
+    const char* city;
+    double latitude;
+    double longitude;
+    double timezoneHours;
+    int year;
+    int month;
+    int day;
+    uint8_t method;
+    int16_t minutes[PRAYER_TIME_COUNT];  // PrayerTimeIndex order, minutes since midnight
+};
+
+// UNVERIFIED: printed by tools/aladhan_reference.py --offline, its port of the algorithm the
+// API runs, not by api.aladhan.com. Replace with the tool's online output and drop this note.
+// The comment above each row is the same in HH:MM.
+static const ReferenceDay referenceDays[] = {
+    // 05:16 06:30 12:32 15:56 18:29 19:42 18:26 05:06 00:29 22:28 02:30
+    {"Dubai", 25.2048, 55.2708, 4, 2024, 3, 10, 16, { 316,  390,  752,  956, 1109, 1182, 1106,  306,   29, 1348,  150}},
+    // 03:59 05:27 12:24 15:46 19:15 20:43 19:12 03:49 00:21 22:38 02:04
+    {"Dubai", 25.2048, 55.2708, 4, 2024, 6, 21, 16, { 239,  327,  744,  946, 1155, 1243, 1152,  229,   21, 1358,  124}},
+    // 05:37 06:57 12:20 15:18 17:37 18:57 17:34 05:27 00:17 22:03 02:31
+    {"Dubai", 25.2048, 55.2708, 4, 2024, 12, 21, 16, { 337,  417,  740,  918, 1057, 1137, 1054,  327,   17, 1323,  151}},
+    // 05:41 07:01 12:30 15:37 17:59 19:29 17:59 05:31 00:30 22:20 02:40
+    {"Makkah", 21.4225, 39.8262, 3, 2024, 1, 15, 4, { 341,  421,  750,  937, 1079, 1169, 1079,  331,   30, 1340,  160}},
+    // 05:39 06:55 12:44 16:05 18:34 19:50 18:34 05:29 00:45 22:41 02:48
+    {"Karachi", 24.8607, 67.0011, 5, 2024, 2, 29, 1, { 339,  415,  764,  965, 1114, 1190, 1114,  329,   45, 1361,  168}},
+    // 04:44 06:12 11:39 14:43 17:05 18:24 17:05 04:34 23:38 21:27 01:50
+    {"Cairo", 30.0444, 31.2357, 2, 2024, 11, 5, 5, { 284,  372,  699,  883, 1025, 1104, 1025,  274, 1418, 1287,  110}},
+    // 04:09 05:37 12:04 15:42 18:50 19:39 18:31 03:59 23:20 21:44 00:57
+    {"Tehran", 35.6892, 51.3890, 3.5, 2024, 9, 1, 7, { 249,  337,  724,  942, 1130, 1179, 1111,  239, 1400, 1304,   57}},
+    // 04:40 06:03 11:57 15:19 17:50 19:04 17:50 04:30 23:57 21:54 01:59
+    {"Jakarta", -6.2088, 106.8456, 7, 2024, 7, 1, 20, { 280,  363,  717,  919, 1070, 1144, 1070,  270, 1437, 1314,  119}},
+    // 05:54 07:17 11:54 14:14 16:32 17:54 16:32 05:44 23:54 21:27 02:22
+    {"New York", 40.7128, -74.0060, -5, 2024, 12, 21, 2, { 354,  437,  714,  854,  992, 1074,  992,  344, 1434, 1287,  142}},
+    // 02:31 04:43 13:02 17:25 21:22 23:27 21:22 02:21 01:02 23:49 02:16
+    {"London", 51.5074, -0.1278, 1, 2024, 6, 21, 3, { 151,  283,  782, 1045, 1282, 1407, 1282,  141,   62, 1429,  136}},
+    // 02:21 03:54 13:19 18:01 22:44 00:12 22:44 02:11 01:19 00:27 02:11
+    {"Oslo", 59.9139, 10.7522, 2, 2024, 6, 21, 3, { 141,  234,  799, 1081, 1364,   12, 1364,  131,   79,   27,  131}},
+    // 07:54 11:22 13:26 13:47 15:30 18:49 15:30 07:44 01:26 22:07 04:45
+    {"Reykjavik", 64.1466, -21.9426, 0, 2024, 12, 21, 3, { 474,  682,  806,  827,  930, 1129,  930,  464,   86, 1327,  285}},
+};
+
+// Function to check one reference day, allowing a minute either way (across midnight too)
+static void checkReferenceDay(const ReferenceDay& reference) {
+    PrayerTimes times;
+    char message[96];
+    snprintf(message, sizeof(message), "%s %04d-%02d-%02d method %u", reference.city, reference.year,
+             reference.month, reference.day, reference.method);
+    TEST_ASSERT_TRUE_MESSAGE(computePrayerTimes(reference.year, reference.month, reference.day, reference.latitude,
+                                                reference.longitude, reference.timezoneHours, reference.method, times),
+                             message);
+
+    for (int i = 0; i < PRAYER_TIME_COUNT; i++) {
+        int difference = abs(times.minutes[i] - reference.minutes[i]);
+        if (difference > 720) {
+            difference = 1440 - difference;
+        }
+        snprintf(message, sizeof(message), "%s %04d-%02d-%02d method %u %s: %02d:%02d, reference %02d:%02d",
+                 reference.city, reference.year, reference.month, reference.day, reference.method, timingNames[i],
+                 times.minutes[i] / 60, times.minutes[i] % 60, reference.minutes[i] / 60, reference.minutes[i] % 60);
+        TEST_ASSERT_MESSAGE(times.minutes[i] >= 0 && difference <= 1, message);
+    }
+}
+
+static void test_dubai_method_16(void) {
+    for (const ReferenceDay& reference : referenceDays) {
+        if (reference.method == 16) {
+            checkReferenceDay(reference);
+        }
+    }
+}
+
+static void test_other_methods(void) {
+    for (const ReferenceDay& reference : referenceDays) {
+        if (reference.method != 16 && fabs(reference.latitude) < HIGH_LATITUDE) {
+            checkReferenceDay(reference);
+        }
+    }
+}
+
+static void test_high_latitude_rule(void) {
+    int checked = 0;
+    for (const ReferenceDay& reference : referenceDays) {
+        if (fabs(reference.latitude) >= HIGH_LATITUDE) {
+            checkReferenceDay(reference);
+            checked++;
+        }
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(2, checked);
+}
+
+// No sunrise at all (Tromso in December) and unknown methods are refused, not guessed
+static void test_undefined_days_rejected(void) {
+    PrayerTimes times;
+    TEST_ASSERT_FALSE(computePrayerTimes(2024, 12, 21, 69.6492, 18.9553, 1, 3, times));
+    TEST_ASSERT_FALSE(computePrayerTimes(2024, 3, 10, 25.2048, 55.2708, 4, 6, times));
+    TEST_ASSERT_FALSE(computePrayerTimes(2024, 3, 10, 95.0, 55.2708, 4, 16, times));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_dubai_method_16);
+    RUN_TEST(test_other_methods);
+    RUN_TEST(test_high_latitude_rule);
+    RUN_TEST(test_undefined_days_rejected);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000);  // Let the test runner open the serial port
+    runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char** argv) {
+    return runTests();
+}
+#endif
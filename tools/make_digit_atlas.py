@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+# make_digit_atlas.py
+# Rasterizes the clock digits into src/digit_atlas.h. Each glyph is drawn from
+# stroke outlines (lines and elliptical arcs), supersampled 4x4 and
+# thresholded, then packed in SSD1306 page-major order: for each 8-pixel page
+# row, one byte per column with bit 0 at the top.
+#
+#   python3 tools/make_digit_atlas.py > src/digit_atlas.h
+import math
+
+SUPERSAMPLE = 4
+
+# name, cell width, cell height (multiple of 8), glyph width, glyph height, stroke width, colon width
+FONTS = [
+    ("SMALL", 12, 16, 10, 15, 2.3, 6),
+    ("LARGE", 28, 48, 24, 46, 5.0, 12),
+]
+
+
+def line(x0, y0, x1, y1):
+    return ("line", x0, y0, x1, y1)
+
+
+def arc(cx, cy, rx, ry, start, end):
+    # Angles in degrees on screen: 0 right, 90 down, 180 left, 270 up
+    return ("arc", cx, cy, rx, ry, start, end)
+
+
+def strokes(digit, w, h, s):
+    half = s / 2.0
+    left, right, top, bottom = half, w - half, half, h - half
+    cx = w / 2.0
+    rx = (right - left) / 2.0
+    middle = h / 2.0
+    upper = (top + middle) / 2.0
+    lower = (middle + bottom) / 2.0
+    upperRy = (middle - top) / 2.0
+    lowerRy = (bottom - middle) / 2.0
+    corner = rx
+    if digit == 0:
+        return [arc(cx, top + corner, rx, corner, 180, 360), line(right, top + corner, right, bottom - corner),
+                arc(cx, bottom - corner, rx, corner, 0, 180), line(left, bottom - corner, left, top + corner)]
+    if digit == 1:
+        return [line(cx + rx * 0.2, top, cx + rx * 0.2, bottom),
+                line(cx + rx * 0.2, top, cx - rx * 0.6, top + rx * 0.8)]
+    if digit == 2:
+        return [arc(cx, top + corner, rx, corner, 190, 360), line(right, top + corner, left, bottom),
+                line(left, bottom, right, bottom)]
+    if digit == 3:
+        return [arc(cx, upper, rx * 0.9, upperRy, 200, 450), arc(cx, lower, rx, lowerRy, 270, 520)]
+    if digit == 4:
+        stem = left + (right - left) * 0.72
+        bar = middle + (bottom - middle) * 0.35
+        return [line(stem, top, stem, bottom), line(stem, top, left, bar), line(left, bar, right, bar)]
+    if digit == 5:
+        shoulder = middle - s * 0.3
+        return [line(right, top, left + s * 0.3, top), line(left + s * 0.3, top, left, shoulder),
+                arc(cx, lower - s * 0.15, rx, lowerRy + s * 0.15, 215, 515)]
+    if digit == 6:
+        return [arc(cx, lower, rx, lowerRy, 0, 360), line(left, lower, left, top + corner),
+                arc(cx, top + corner, rx, corner, 180, 320)]
+    if digit == 7:
+        return [line(left, top, right, top), line(right, top, left + (right - left) * 0.35, bottom)]
+    if digit == 8:
+        return [arc(cx, upper, rx * 0.85, upperRy, 0, 360), arc(cx, lower, rx, lowerRy, 0, 360)]
+    if digit == 9:
+        return [arc(cx, upper, rx, upperRy, 0, 360), line(right, upper, right, bottom - corner),
+                arc(cx, bottom - corner, rx, corner, 0, 140)]
+    raise ValueError(digit)
+
+
+def distanceToSegment(px, py, x0, y0, x1, y1):
+    dx, dy = x1 - x0, y1 - y0
+    length = dx * dx + dy * dy
+    t = 0.0 if length == 0 else max(0.0, min(1.0, ((px - x0) * dx + (py - y0) * dy) / length))
+    return math.hypot(px - (x0 + t * dx), py - (y0 + t * dy))
+
+
+def flatten(stroke):
+    if stroke[0] == "line":
+        return [stroke[1:]]
+    _, cx, cy, rx, ry, start, end = stroke
+    steps = max(8, int(abs(end - start) / 6))
+    points = []
+    for i in range(steps + 1):
+        a = math.radians(start + (end - start) * i / steps)
+        points.append((cx + rx * math.cos(a), cy + ry * math.sin(a)))
+    return [(points[i][0], points[i][1], points[i + 1][0], points[i + 1][1]) for i in range(steps)]
+
+
+def rasterize(segments, w, h, s):
+    half = s / 2.0
+    pixels = [[False] * w for _ in range(h)]
+    for y in range(h):
+        for x in range(w):
+            covered = 0
+            for sy in range(SUPERSAMPLE):
+                for sx in range(SUPERSAMPLE):
+                    px = x + (sx + 0.5) / SUPERSAMPLE
+                    py = y + (sy + 0.5) / SUPERSAMPLE
+                    if any(distanceToSegment(px, py, *seg) <= half for seg in segments):
+                        covered += 1
+            pixels[y][x] = covered * 2 >= SUPERSAMPLE * SUPERSAMPLE
+    return pixels
+
+
+def place(pixels, cellWidth, cellHeight, offsetX, offsetY):
+    cell = [[False] * cellWidth for _ in range(cellHeight)]
+    for y, row in enumerate(pixels):
+        for x, lit in enumerate(row):
+            if lit and 0 <= y + offsetY < cellHeight and 0 <= x + offsetX < cellWidth:
+                cell[y + offsetY][x + offsetX] = True
+    return cell
+
+
+def colon(glyphHeight, cellWidth, cellHeight, offsetY, s):
+    dot = max(2, int(round(s)))
+    cell = [[False] * cellWidth for _ in range(cellHeight)]
+    x0 = (cellWidth - dot) // 2
+    for centre in (offsetY + glyphHeight * 0.3, offsetY + glyphHeight * 0.7):
+        y0 = int(round(centre - dot / 2.0))
+        for y in range(y0, y0 + dot):
+            for x in range(x0, x0 + dot):
+                cell[y][x] = True
+    return cell
+
+
+def pack(cell):
+    width = len(cell[0])
+    out = []
+    for page in range(len(cell) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                if cell[page * 8 + bit][x]:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+def emit(name, values, comment):
+    print("// " + comment)
+    print("static const uint8_t %s[] PROGMEM = {" % name)
+    for i in range(0, len(values), 16):
+        print("    " + ", ".join("0x%02x" % v for v in values[i:i + 16]) + ",")
+    print("};")
+    print()
+
+
+def main():
+    print("// digit_atlas.h")
+    print("// Generated by tools/make_digit_atlas.py; do not edit. SSD1306 page-major:")
+    print("// per glyph, one byte per column for each 8-pixel page row in turn.")
+    print("#ifndef DIGIT_ATLAS_H")
+    print("#define DIGIT_ATLAS_H")
+    print()
+    print("#include <Arduino.h>")
+    print()
+    for name, cellWidth, cellHeight, glyphWidth, glyphHeight, stroke, colonWidth in FONTS:
+        offsetX = (cellWidth - glyphWidth) // 2
+        offsetY = (cellHeight - glyphHeight) // 2
+        digits = []
+        for digit in range(10):
+            segments = [seg for st in strokes(digit, glyphWidth, glyphHeight, stroke) for seg in flatten(st)]
+            digits += pack(place(rasterize(segments, glyphWidth, glyphHeight, stroke), cellWidth, cellHeight,
+                                 offsetX, offsetY))
+        emit("DIGIT_ATLAS_%s_DIGITS" % name, digits,
+             "%dx%d cells, digits 0 to 9" % (cellWidth, cellHeight))
+        emit("DIGIT_ATLAS_%s_COLON" % name, pack(colon(glyphHeight, colonWidth, cellHeight, offsetY, stroke)),
+             "%dx%d colon" % (colonWidth, cellHeight))
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,359 @@
+// make_schedules.cpp
+// Bulk schedule generator for provisioning a fleet of clocks. For every
+// location it calculates a run of days (a calendar year by default) with the
+// firmware's solar model, encodes them with the firmware's schedule_store and
+// writes one provisioning image per location, to be flashed into the
+// "schedule" partition (see partitions.csv) next to the firmware. A clock that
+// finds a matching image shows times on first boot without going online.
+//
+// Locations come from a CSV file, one "name,latitude,longitude[,timezone hours]"
+// per line, or from a synthetic grid for timing runs. They are spread over
+// all cores; each worker runs the vectorized day kernel (schedule_kernel.cpp)
+// and recomputes the few days it flags with computePrayerTimes() itself, so
+// the images hold exactly what the clock would calculate.
+//
+//   g++ -std=c++11 -O3 -ffast-math -march=native -Isrc -c tools/schedule_kernel.cpp -o schedule_kernel.o
+//   g++ -std=c++11 -O2 -pthread -Isrc -o make_schedules tools/make_schedules.cpp src/prayer_times.cpp
+//       src/schedule_store.cpp schedule_kernel.o
+//   ./make_schedules --locations fleet.csv --year 2025 --out images/
+//   esptool.py write_flash 0x3E0000 images/<name>.bin
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "prayer_times.h"
+#include "schedule_store.h"
+#include "schedule_kernel.h"
+
+// Firmware defaults (gmtOffsetSec and calculationMethod in src/main.cpp)
+#define DEFAULT_TIMEZONE_HOURS 5.5
+#define DEFAULT_METHOD 16
+
+struct Location {
+    std::string name;
+    double latitude;
+    double longitude;
+    double timezoneHours;
+};
+
+struct Options {
+    const char* locationsPath = nullptr;
+    int gridCount = 0;
+    int startYear = 0;
+    int startMonth = 1;
+    int startDay = 1;
+    int dayCount = 0;               // 0: to the end of the start year
+    double timezoneHours = DEFAULT_TIMEZONE_HOURS;
+    int method = DEFAULT_METHOD;
+    int asrFactor = 1;
+    unsigned threads = 0;           // 0: one per core
+    const char* outDir = nullptr;   // Nothing is written without it
+    bool scalar = false;
+    bool check = false;
+};
+
+// Totals over all workers
+struct RunStats {
+    std::atomic<uint64_t> exactDays{0};
+    std::atomic<uint64_t> recomputedDays{0};
+    std::atomic<uint64_t> mismatchedDays{0};
+    std::atomic<uint32_t> failedLocations{0};
+    std::atomic<uint64_t> imageBytes{0};
+};
+
+// Days since 1970-01-01 for a civil date (proleptic Gregorian)
+static long daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yoe = year - era * 400;
+    long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civilFromDays(long days, int& year, int& month, int& day) {
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    long doe = days - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2);
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Usage: make_schedules (--locations FILE | --grid N) [options]\n"
+            "  --locations FILE   CSV lines of name,latitude,longitude[,timezone hours]\n"
+            "  --grid N           N synthetic locations between 58 S and 58 N, for timing\n"
+            "  --year Y           calculate all of year Y (default: this year)\n"
+            "  --start YYYY-MM-DD first day instead of 1 January\n"
+            "  --days N           number of days (default: to the end of the start year)\n"
+            "  --tz HOURS         time zone where the CSV has none (default %.1f)\n"
+            "  --method ID        Aladhan method id (default %d)\n"
+            "  --hanafi           Hanafi Asr\n"
+            "  --threads N        worker threads (default: one per core)\n"
+            "  --out DIR          write DIR/<name>.bin per location\n"
+            "  --scalar           calculate every day with computePrayerTimes(), for comparison\n"
+            "  --check            also compare every kernel day with computePrayerTimes()\n",
+            DEFAULT_TIMEZONE_HOURS, DEFAULT_METHOD);
+}
+
+static bool readLocations(const char* path, double defaultTimezone, std::vector<Location>& locations) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char line[256];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        lineNumber++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        char name[PROVISION_NAME_SIZE];
+        Location location;
+        location.timezoneHours = defaultTimezone;
+        int fields = sscanf(line, "%31[^,],%lf,%lf,%lf", name, &location.latitude, &location.longitude,
+                            &location.timezoneHours);
+        if (fields < 3) {
+            if (lineNumber > 1) {
+                fprintf(stderr, "%s:%d: expected name,latitude,longitude[,timezone]\n", path, lineNumber);
+            }
+            continue;  // A header line, or a malformed one
+        }
+        location.name = name;
+        locations.push_back(location);
+    }
+    fclose(file);
+    return true;
+}
+
+static void makeGrid(int count, double timezone, std::vector<Location>& locations) {
+    int columns = 1;
+    while (columns * columns < count) {
+        columns++;
+    }
+    for (int i = 0; i < count; i++) {
+        Location location;
+        char name[PROVISION_NAME_SIZE];
+        snprintf(name, sizeof(name), "grid_%05d", i);
+        location.name = name;
+        location.latitude = -58.0 + 116.0 * (i / columns + 0.5) / columns;
+        location.longitude = -180.0 + 360.0 * (i % columns + 0.5) / columns;
+        location.timezoneHours = timezone;
+        locations.push_back(location);
+    }
+}
+
+// Letters, digits, '-' and '_' only, so a name cannot leave the output directory
+static std::string fileNameFor(const std::string& name) {
+    std::string file = name;
+    for (char& c : file) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        if (!safe) {
+            c = '_';
+        }
+    }
+    return file + ".bin";
+}
+
+static bool writeImage(const char* dir, const std::string& name, const uint8_t* image, size_t size) {
+    std::string path = std::string(dir) + "/" + fileNameFor(name);
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = fwrite(image, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+// Function to calculate, encode and write one location; false if any day has no sunrise or sunset
+static bool makeImage(const Options& options, const Location& location, long startDays,
+                      std::vector<PrayerTimes>& days, std::vector<uint8_t>& exact, std::vector<uint8_t>& schedule,
+                      std::vector<uint8_t>& image, RunStats& stats) {
+    int dayCount = options.dayCount;
+    int year, month, day;
+    if (options.scalar) {
+        std::fill(exact.begin(), exact.end(), 0);
+    } else {
+        KernelLocation kernelLocation = {location.latitude, location.longitude, location.timezoneHours,
+                                         findCalculationMethod(options.method), options.asrFactor};
+        computeDaysKernel(startDays + 2440587.5, dayCount, kernelLocation, days.data(), exact.data());
+    }
+
+    uint64_t recomputed = 0;
+    uint64_t mismatched = 0;
+    for (int d = 0; d < dayCount; d++) {
+        if (exact[d] && !options.check) {
+            continue;
+        }
+        civilFromDays(startDays + d, year, month, day);
+        PrayerTimes times;
+        if (!computePrayerTimes(year, month, day, location.latitude, location.longitude, location.timezoneHours,
+                                options.method, times, options.asrFactor)) {
+            return false;
+        }
+        if (!exact[d]) {
+            days[d] = times;
+            recomputed++;
+        } else if (memcmp(&times, &days[d], sizeof(times)) != 0) {
+            mismatched++;
+        }
+    }
+    stats.recomputedDays += recomputed;
+    stats.exactDays += dayCount - recomputed;
+    stats.mismatchedDays += mismatched;
+
+    civilFromDays(startDays, year, month, day);
+    size_t scheduleSize = encodeSchedule(days.data(), dayCount, year, month, day, schedule.data(), schedule.size());
+    if (scheduleSize == 0) {
+        return false;
+    }
+
+    ProvisionHeader header;
+    memset(&header, 0, sizeof(header));
+    header.method = options.method;
+    header.timezoneMinutes = (int16_t)lround(location.timezoneHours * 60.0);
+    header.latitude = location.latitude;
+    header.longitude = location.longitude;
+    strncpy(header.name, location.name.c_str(), sizeof(header.name) - 1);
+    size_t imageSize = encodeProvisionImage(header, schedule.data(), scheduleSize, image.data(), image.size());
+    if (imageSize == 0) {
+        return false;
+    }
+    stats.imageBytes += imageSize;
+
+    if (options.outDir != nullptr && !writeImage(options.outDir, location.name, image.data(), imageSize)) {
+        fprintf(stderr, "Cannot write the image for %s: %s\n", location.name.c_str(), strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--locations" && value) {
+            options.locationsPath = argv[++i];
+        } else if (arg == "--grid" && value) {
+            options.gridCount = atoi(argv[++i]);
+        } else if (arg == "--year" && value) {
+            options.startYear = atoi(argv[++i]);
+        } else if (arg == "--start" && value &&
+                   sscanf(value, "%d-%d-%d", &options.startYear, &options.startMonth, &options.startDay) == 3) {
+            i++;
+        } else if (arg == "--days" && value) {
+            options.dayCount = atoi(argv[++i]);
+        } else if (arg == "--tz" && value) {
+            options.timezoneHours = atof(argv[++i]);
+        } else if (arg == "--method" && value) {
+            options.method = atoi(argv[++i]);
+        } else if (arg == "--hanafi") {
+            options.asrFactor = 2;
+        } else if (arg == "--threads" && value) {
+            options.threads = atoi(argv[++i]);
+        } else if (arg == "--out" && value) {
+            options.outDir = argv[++i];
+        } else if (arg == "--scalar") {
+            options.scalar = true;
+        } else if (arg == "--check") {
+            options.check = true;
+        } else {
+            usage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    std::vector<Location> locations;
+    if (options.locationsPath != nullptr) {
+        if (!readLocations(options.locationsPath, options.timezoneHours, locations)) {
+            fprintf(stderr, "Cannot read %s\n", options.locationsPath);
+            return 2;
+        }
+    } else if (options.gridCount > 0) {
+        makeGrid(options.gridCount, options.timezoneHours, locations);
+    } else {
+        usage();
+        return 2;
+    }
+    if (findCalculationMethod(options.method) == nullptr) {
+        fprintf(stderr, "Unknown calculation method %d\n", options.method);
+        return 2;
+    }
+
+    if (options.startYear == 0) {
+        time_t now = time(nullptr);
+        options.startYear = gmtime(&now)->tm_year + 1900;
+    }
+    long startDays = daysFromCivil(options.startYear, options.startMonth, options.startDay);
+    if (options.dayCount <= 0) {
+        options.dayCount = daysFromCivil(options.startYear + 1, 1, 1) - startDays;
+    }
+    size_t scheduleCapacity = scheduleBlobSize(options.dayCount);
+    if (options.dayCount > 0xFFFF || scheduleCapacity + sizeof(ProvisionHeader) > PROVISION_PARTITION_SIZE) {
+        fprintf(stderr, "%d days do not fit the %u byte schedule partition\n", options.dayCount,
+                (unsigned)PROVISION_PARTITION_SIZE);
+        return 2;
+    }
+    if (options.outDir != nullptr && mkdir(options.outDir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Cannot create %s: %s\n", options.outDir, strerror(errno));
+        return 2;
+    }
+
+    unsigned threads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    RunStats stats;
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        std::vector<PrayerTimes> days(options.dayCount);
+        std::vector<uint8_t> exact(options.dayCount);
+        std::vector<uint8_t> schedule(scheduleCapacity);
+        std::vector<uint8_t> image(sizeof(ProvisionHeader) + scheduleCapacity);
+        for (size_t i = next++; i < locations.size(); i = next++) {
+            if (!makeImage(options, locations[i], startDays, days, exact, schedule, image, stats)) {
+                fprintf(stderr, "No schedule for %s (%.4f, %.4f): polar day or night, or the image failed\n",
+                        locations[i].name.c_str(), locations[i].latitude, locations[i].longitude);
+                stats.failedLocations++;
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t locationDays = (uint64_t)locations.size() * options.dayCount;
+    printf("locations,%u,days,%d,threads,%u,mode,%s,seconds,%.3f,location_days_per_s,%.0f\n",
+           (unsigned)locations.size(), options.dayCount, threads, options.scalar ? "scalar" : "kernel", seconds,
+           locationDays / seconds);
+    printf("exact_days,%llu,recomputed_days,%llu,failed_locations,%u,image_bytes,%llu\n",
+           (unsigned long long)stats.exactDays, (unsigned long long)stats.recomputedDays,
+           (unsigned)stats.failedLocations, (unsigned long long)stats.imageBytes);
+    if (options.check) {
+        printf("check,mismatched_days,%llu\n", (unsigned long long)stats.mismatchedDays);
+    }
+    return stats.failedLocations == 0 && stats.mismatchedDays == 0 ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+// schedule_kernel.cpp
+// Build with -O3 -ffast-math: glibc then declares SIMD variants of sin, cos,
+// acos, asin, atan, atan2 and tan (libmvec), and each day loop below becomes
+// vector code. Fast math moves results by a few ulps, so instead of matching
+// the firmware bit for bit, the kernel flags the days where that could change
+// a rounded minute or a branch, and make_schedules recomputes those exactly.
+// The constants and the order of the steps follow src/prayer_times.cpp.
+#include <math.h>
+#include "schedule_kernel.h"
+
+static constexpr double J2000 = 2451545.0;
+static constexpr double MEAN_ANOMALY[2] = {357.529, 0.98560028};
+static constexpr double MEAN_LONGITUDE[2] = {280.459, 0.98564736};
+static constexpr double ECLIPTIC_TERMS[2] = {1.915, 0.020};
+static constexpr double OBLIQUITY[2] = {23.439, -0.00000036};
+static constexpr double RISE_SET_ANGLE = 0.833;
+static constexpr int IMSAK_MINUTES = 10;
+
+static constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+// How close a value may come to an edge before the day goes to the exact path. The kernel's
+// error is around 1e-12 hours; these leave several orders of magnitude to spare.
+static constexpr double EDGE_HOURS = 1e-8;
+static constexpr double EDGE_MINUTE_FRACTION = 1e-6;
+static constexpr double EDGE_COSINE = 1e-12;
+
+static inline double fixRange(double value, double range) {
+    value = value - range * floor(value / range);
+    return value < 0 ? value + range : value;
+}
+
+// A sine and cosine of the same angle would be fused into one sincos call, which GCC does not
+// vectorize; taking the cosine as the sine of the complement keeps them apart
+static inline double dsin(double d) { return sin(d * DEG_TO_RAD); }
+static inline double dcos(double d) { return sin((90.0 - d) * DEG_TO_RAD); }
+
+// Sine and cosine of the solar declination, and the equation of time (hours)
+static inline void sunPosition(double jd, double& sinDecl, double& cosDecl, double& equation) {
+    double d = jd - J2000;
+    double g = fixRange(MEAN_ANOMALY[0] + MEAN_ANOMALY[1] * d, 360.0);
+    double q = fixRange(MEAN_LONGITUDE[0] + MEAN_LONGITUDE[1] * d, 360.0);
+    double l = fixRange(q + ECLIPTIC_TERMS[0] * dsin(g) + ECLIPTIC_TERMS[1] * dsin(2 * g), 360.0);
+    double e = OBLIQUITY[0] + OBLIQUITY[1] * d;
+
+    double ra = atan2(dcos(e) * dsin(l), dcos(l)) / DEG_TO_RAD / 15.0;
+    equation = q / 15.0 - fixRange(ra, 24.0);
+    sinDecl = dsin(e) * dsin(l);
+    cosDecl = sqrt(1.0 - sinDecl * sinDecl);
+}
+
+// Hours from noon at which the sun reaches the depression whose negated sine is given;
+// valid is false when it never does
+static inline double hourAngle(double negSinAngle, double sinDecl, double cosDecl, double sinLat, double cosLat,
+                               bool& valid, bool& edge) {
+    double cosT = (negSinAngle - sinDecl * sinLat) / (cosDecl * cosLat);
+    valid = fabs(cosT) <= 1.0;
+    edge |= fabs(fabs(cosT) - 1.0) < EDGE_COSINE;
+    cosT = cosT > 1.0 ? 1.0 : (cosT < -1.0 ? -1.0 : cosT);
+    return acos(cosT) / DEG_TO_RAD / 15.0;
+}
+
+// Angle-based high latitude rule, as adjustHighLatitude()
+static inline double adjustHighLatitude(double time, bool valid, double base, double angle, double night,
+                                        bool beforeBase, bool& edge) {
+    double portion = angle / 60.0 * night;
+    double diff = beforeBase ? fixRange(base - time, 24.0) : fixRange(time - base, 24.0);
+    edge |= valid & ((fabs(diff - portion) < EDGE_HOURS) | (diff < EDGE_HOURS) | (diff > 24.0 - EDGE_HOURS));
+    return !valid | (diff > portion) ? base + (beforeBase ? -portion : portion) : time;
+}
+
+// Round to the minute as toMinutes(); edge is set when the fraction is too close to call
+static inline int16_t toMinutes(double hours, bool& edge) {
+    double minutes = fixRange(hours + 0.5 / 60.0, 24.0) * 60.0;
+    double whole = floor(minutes);
+    double fraction = minutes - whole;
+    edge |= (fraction < EDGE_MINUTE_FRACTION) | (fraction > 1.0 - EDGE_MINUTE_FRACTION);
+    return (int16_t)((int)whole % 1440);
+}
+
+// Everything the day loop needs from the location and method, worked out once
+struct KernelConstants {
+    double sinLat;
+    double cosLat;
+    double latitude;
+    double asrFactor;
+    double shift;          // From solar time at the meridian to the local time zone
+    double julianOffset;
+    double riseSetSin;     // Negated sines of the depression angles
+    double fajrSin;
+    double ishaSin;
+    double maghribSin;
+    double fajrAngle;
+    double ishaValue;
+    double maghribValue;
+    double offsets[MAIN_TIMING_COUNT];  // Hours
+};
+
+// Day-major working arrays: each loop below runs straight down a column
+struct KernelBlock {
+    double times[PRAYER_TIME_COUNT][KERNEL_BLOCK_DAYS];
+    int16_t minutes[PRAYER_TIME_COUNT][KERNEL_BLOCK_DAYS];
+    uint8_t edges[KERNEL_BLOCK_DAYS];
+};
+
+// Function to work out count days from julianFirst. The method's switches are template
+// arguments, so the loop has no branches left for the vectorizer to trip over.
+template <bool maghribIsMinutes, bool ishaIsMinutes, bool jafariMidnight>
+static void computeBlock(const KernelConstants& constants, double julianFirst, int count, KernelBlock& block) {
+    const KernelConstants k = constants;  // A local copy, which no store to block can alias
+    for (int i = 0; i < count; i++) {
+        double jd = julianFirst + i - k.julianOffset;
+        bool edge = false;
+
+        // The first-guess times of day used by the single refinement pass: 5, 6, 12, 13 and 18 h
+        double sinDecl5, cosDecl5, eqt5, sinDecl6, cosDecl6, eqt6, sinDecl12, cosDecl12, eqt12;
+        double sinDecl13, cosDecl13, eqt13, sinDecl18, cosDecl18, eqt18;
+        sunPosition(jd + 5 / 24.0, sinDecl5, cosDecl5, eqt5);
+        sunPosition(jd + 6 / 24.0, sinDecl6, cosDecl6, eqt6);
+        sunPosition(jd + 12 / 24.0, sinDecl12, cosDecl12, eqt12);
+        sunPosition(jd + 13 / 24.0, sinDecl13, cosDecl13, eqt13);
+        sunPosition(jd + 18 / 24.0, sinDecl18, cosDecl18, eqt18);
+
+        bool fajrValid, sunriseValid, asrValid, sunsetValid, maghribValid, ishaValid;
+        double fajr = fixRange(12.0 - eqt5, 24.0) -
+                      hourAngle(k.fajrSin, sinDecl5, cosDecl5, k.sinLat, k.cosLat, fajrValid, edge);
+        double sunrise = fixRange(12.0 - eqt6, 24.0) -
+                         hourAngle(k.riseSetSin, sinDecl6, cosDecl6, k.sinLat, k.cosLat, sunriseValid, edge);
+        double dhuhr = fixRange(12.0 - eqt12, 24.0);
+
+        double declination13 = asin(sinDecl13) / DEG_TO_RAD;
+        double asrAngle = -atan(1.0 / (k.asrFactor + tan(fabs(k.latitude - declination13) * DEG_TO_RAD)));
+        double asr = fixRange(12.0 - eqt13, 24.0) +
+                     hourAngle(-sin(asrAngle), sinDecl13, cosDecl13, k.sinLat, k.cosLat, asrValid, edge);
+
+        double noon18 = fixRange(12.0 - eqt18, 24.0);
+        double sunset = noon18 + hourAngle(k.riseSetSin, sinDecl18, cosDecl18, k.sinLat, k.cosLat, sunsetValid, edge);
+        double maghrib = sunset;
+        double isha = 0;
+        if (!maghribIsMinutes) {
+            maghrib = noon18 + hourAngle(k.maghribSin, sinDecl18, cosDecl18, k.sinLat, k.cosLat, maghribValid, edge);
+        }
+        if (!ishaIsMinutes) {
+            isha = noon18 + hourAngle(k.ishaSin, sinDecl18, cosDecl18, k.sinLat, k.cosLat, ishaValid, edge);
+        }
+
+        fajr += k.shift;
+        sunrise += k.shift;
+        dhuhr += k.shift;
+        asr += k.shift;
+        sunset += k.shift;
+        maghrib += k.shift;
+        isha += k.shift;
+
+        // computePrayerTimes() fails the day; the exact path reports it
+        edge |= !sunriseValid | !sunsetValid | !asrValid;
+
+        double night = fixRange(sunrise - sunset, 24.0);
+        fajr = adjustHighLatitude(fajr, fajrValid, sunrise, k.fajrAngle, night, true, edge);
+        if (!ishaIsMinutes) {
+            isha = adjustHighLatitude(isha, ishaValid, sunset, k.ishaValue, night, false, edge);
+        }
+        if (!maghribIsMinutes) {
+            maghrib = adjustHighLatitude(maghrib, maghribValid, sunset, k.maghribValue, night, false, edge);
+        }
+
+        if (maghribIsMinutes) {
+            maghrib = sunset + k.maghribValue / 60.0;
+        }
+        if (ishaIsMinutes) {
+            isha = maghrib + k.ishaValue / 60.0;
+        }
+
+        double nightEnd = jafariMidnight ? fajr : sunrise;
+        double nightLength = fixRange(nightEnd - sunset, 24.0);
+
+        block.times[PRAYER_FAJR][i] = fajr + k.offsets[PRAYER_FAJR];
+        block.times[PRAYER_SUNRISE][i] = sunrise + k.offsets[PRAYER_SUNRISE];
+        block.times[PRAYER_DHUHR][i] = dhuhr + k.offsets[PRAYER_DHUHR];
+        block.times[PRAYER_ASR][i] = asr + k.offsets[PRAYER_ASR];
+        block.times[PRAYER_MAGHRIB][i] = maghrib + k.offsets[PRAYER_MAGHRIB];
+        block.times[PRAYER_ISHA][i] = isha + k.offsets[PRAYER_ISHA];
+        block.times[PRAYER_SUNSET][i] = sunset;
+        block.times[PRAYER_IMSAK][i] = fajr - IMSAK_MINUTES / 60.0;
+        block.times[PRAYER_MIDNIGHT][i] = sunset + nightLength / 2.0;
+        block.times[PRAYER_FIRST_THIRD][i] = sunset + nightLength / 3.0;
+        block.times[PRAYER_LAST_THIRD][i] = sunset + nightLength * 2.0 / 3.0;
+        block.edges[i] = edge;
+    }
+}
+
+typedef void (*BlockFunction)(const KernelConstants&, double, int, KernelBlock&);
+
+// Indexed by maghribIsMinutes * 4 + ishaIsMinutes * 2 + jafariMidnight
+static const BlockFunction blockFunctions[8] = {
+    computeBlock<false, false, false>, computeBlock<false, false, true>,
+    computeBlock<false, true, false>,  computeBlock<false, true, true>,
+    computeBlock<true, false, false>,  computeBlock<true, false, true>,
+    computeBlock<true, true, false>,   computeBlock<true, true, true>,
+};
+
+void computeDaysKernel(double julianStart, int dayCount, const KernelLocation& location, PrayerTimes* out,
+                       uint8_t* exact) {
+    const CalculationMethod& method = *location.method;
+    KernelConstants k;
+    k.sinLat = dsin(location.latitude);
+    k.cosLat = dcos(location.latitude);
+    k.latitude = location.latitude;
+    k.asrFactor = location.asrFactor;
+    k.shift = location.timezoneHours - location.longitude / 15.0;
+    k.julianOffset = location.longitude / (15.0 * 24.0);
+    k.riseSetSin = -dsin(RISE_SET_ANGLE);
+    k.fajrSin = -dsin(method.fajrAngle);
+    k.ishaSin = -dsin(method.ishaValue);
+    k.maghribSin = -dsin(method.maghribValue);
+    k.fajrAngle = method.fajrAngle;
+    k.ishaValue = method.ishaValue;
+    k.maghribValue = method.maghribValue;
+    for (int t = 0; t < MAIN_TIMING_COUNT; t++) {
+        k.offsets[t] = method.offsets[t] / 60.0;
+    }
+    BlockFunction computeDays =
+        blockFunctions[method.maghribIsMinutes * 4 + method.ishaIsMinutes * 2 + method.jafariMidnight];
+
+    KernelBlock block;
+    for (int first = 0; first < dayCount; first += KERNEL_BLOCK_DAYS) {
+        int count = dayCount - first < KERNEL_BLOCK_DAYS ? dayCount - first : KERNEL_BLOCK_DAYS;
+        computeDays(k, julianStart + first, count, block);
+
+        for (int t = 0; t < PRAYER_TIME_COUNT; t++) {
+            for (int i = 0; i < count; i++) {
+                bool edge = false;
+                block.minutes[t][i] = toMinutes(block.times[t][i], edge);
+                block.edges[i] |= edge;
+            }
+        }
+
+        for (int i = 0; i < count; i++) {
+            for (int t = 0; t < PRAYER_TIME_COUNT; t++) {
+                out[first + i].minutes[t] = block.minutes[t][i];
+            }
+            exact[first + i] = !block.edges[i];
+        }
+    }
+}
@@ -0,0 +1,29 @@
+// schedule_kernel.h
+// Per-day kernel of tools/make_schedules.cpp: the solar model of
+// src/prayer_times.cpp for a run of consecutive days at one location, written
+// as branch-free loops over day-major arrays so the compiler vectorizes them.
+#ifndef SCHEDULE_KERNEL_H
+#define SCHEDULE_KERNEL_H
+
+#include <stdint.h>
+#include "prayer_times.h"
+
+#define KERNEL_BLOCK_DAYS 64  // Days per pass through the working arrays
+
+struct KernelLocation {
+    double latitude;
+    double longitude;
+    double timezoneHours;
+    const CalculationMethod* method;
+    int asrFactor;
+};
+
+// Fill out[d] for dayCount days from the Julian date julianStart (at 0h UT).
+// exact[d] is cleared for a day the kernel cannot vouch for: polar day or
+// night, a twilight time on the edge of the high latitude rule, or a time
+// within a hair of a minute boundary, where the last bit decides the rounding.
+// Those days must be recomputed with computePrayerTimes().
+void computeDaysKernel(double julianStart, int dayCount, const KernelLocation& location, PrayerTimes* out,
+                       uint8_t* exact);
+
+#endif